@@ -0,0 +1,243 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file hid_capture.c
+ * @brief Captures of the HID traffic of the host build.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "nrf_host.h"
+#include "hid_capture.h"
+
+
+/** File being recorded, NULL if none. */
+static FILE * m_p_file;
+
+/** Wall time of the start of the recording. */
+static uint64_t m_wall_start_ns;
+
+/** Device clock at the start of the recording. */
+static uint64_t m_clock_start_ns;
+
+
+static uint64_t wall_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+static void record_write(hid_capture_type_t type, uint8_t client,
+                         uint8_t const * p_report, uint16_t size)
+{
+    hid_capture_record_header_t header =
+    {
+        .time_ns = host_clock_ns(),
+        .type    = (uint8_t)type,
+        .client  = client,
+        .size    = size,
+    };
+
+    if(fwrite(&header, sizeof(header), 1, m_p_file) != 1 ||
+       (size > 0 && fwrite(p_report, size, 1, m_p_file) != 1))
+    {
+        fprintf(stderr, "Capture write failed, recording stopped\n");
+        hid_capture_close();
+    }
+}
+
+
+ret_code_t hid_capture_open(char const * p_path, uint32_t seed)
+{
+    hid_capture_header_t header =
+    {
+        .magic       = HID_CAPTURE_MAGIC,
+        .version     = HID_CAPTURE_VERSION,
+        .report_size = HOST_USBD_REPORT_SIZE,
+        .seed        = seed,
+    };
+
+    m_p_file = fopen(p_path, "wb");
+    if(m_p_file == NULL)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    if(fwrite(&header, sizeof(header), 1, m_p_file) != 1)
+    {
+        hid_capture_close();
+        return NRF_ERROR_INTERNAL;
+    }
+
+    host_clock_stop();
+    m_clock_start_ns = host_clock_ns();
+    m_wall_start_ns = wall_ns();
+
+    return NRF_SUCCESS;
+}
+
+
+bool hid_capture_is_open(void)
+{
+    return m_p_file != NULL;
+}
+
+
+void hid_capture_clock_sync(void)
+{
+    if(m_p_file == NULL) return;
+
+    host_clock_set_ns(m_clock_start_ns + wall_ns() - m_wall_start_ns);
+
+    if(app_timer_host_process())
+    {
+        record_write(HID_CAPTURE_TICK, 0, NULL, 0);
+    }
+}
+
+
+void hid_capture_report(hid_capture_type_t type, uint8_t client,
+                        uint8_t const * p_report)
+{
+    if(m_p_file == NULL) return;
+
+    record_write(type, client, p_report, HOST_USBD_REPORT_SIZE);
+}
+
+
+void hid_capture_close(void)
+{
+    if(m_p_file == NULL) return;
+
+    fclose(m_p_file);
+    m_p_file = NULL;
+}
+
+
+ret_code_t hid_capture_load(char const * p_path, hid_capture_t * p_capture)
+{
+    hid_capture_header_t header;
+    hid_capture_record_header_t record;
+    size_t capacity = 0;
+    ret_code_t ret = NRF_SUCCESS;
+
+    memset(p_capture, 0, sizeof(*p_capture));
+
+    FILE * p_file = fopen(p_path, "rb");
+    if(p_file == NULL)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    if(fread(&header, sizeof(header), 1, p_file) != 1 ||
+       header.magic != HID_CAPTURE_MAGIC ||
+       header.version != HID_CAPTURE_VERSION ||
+       header.report_size != HOST_USBD_REPORT_SIZE)
+    {
+        fclose(p_file);
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    p_capture->seed = header.seed;
+
+    while(fread(&record, sizeof(record), 1, p_file) == 1)
+    {
+        if(record.type > HID_CAPTURE_TICK ||
+           record.size != ((record.type == HID_CAPTURE_TICK) ?
+                           0 : HOST_USBD_REPORT_SIZE))
+        {
+            ret = NRF_ERROR_INVALID_DATA;
+            break;
+        }
+
+        if(p_capture->count == capacity)
+        {
+            capacity = (capacity == 0) ? 256 : capacity * 2;
+
+            hid_capture_record_t * p_records =
+                realloc(p_capture->p_records, capacity * sizeof(*p_records));
+            if(p_records == NULL)
+            {
+                ret = NRF_ERROR_NO_MEM;
+                break;
+            }
+            p_capture->p_records = p_records;
+        }
+
+        hid_capture_record_t * p_record = &p_capture->p_records[p_capture->count];
+
+        p_record->time_ns = record.time_ns;
+        p_record->type = record.type;
+        p_record->client = record.client;
+        memset(p_record->report, 0, sizeof(p_record->report));
+
+        if(record.size > 0 &&
+           fread(p_record->report, record.size, 1, p_file) != 1)
+        {
+            break;
+        }
+
+        p_capture->count++;
+    }
+
+    /* The loop also stops at the partial record of a capture cut short,
+     * which is dropped: the records before it still replay. */
+    if(ret == NRF_SUCCESS && ferror(p_file))
+    {
+        ret = NRF_ERROR_INVALID_DATA;
+    }
+
+    fclose(p_file);
+
+    if(ret != NRF_SUCCESS)
+    {
+        hid_capture_free(p_capture);
+    }
+
+    return ret;
+}
+
+
+void hid_capture_free(hid_capture_t * p_capture)
+{
+    free(p_capture->p_records);
+    memset(p_capture, 0, sizeof(*p_capture));
+}
@@ -0,0 +1,207 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file hid_capture.h
+ * @brief Captures of the HID traffic of the host build.
+ *
+ * A capture holds the reports exchanged with the device, in order, with the
+ * time of the device clock at which each one went through. The socket
+ * server records one while serving its clients; the test driver replays it
+ * against a fresh device, and checks that the IN reports are the same, byte
+ * for byte.
+ *
+ * The file is a @ref hid_capture_header_t followed by records, each a
+ * @ref hid_capture_record_header_t and @c size bytes of report. The fields
+ * are little-endian.
+ *
+ * For the replay to be exact, the recording device starts from empty flash,
+ * with its clock stopped (host_clock_stop()) and its random numbers seeded
+ * with the seed of the header (nrf_crypto_host_rng_seed()). The clock is
+ * moved to the wall time before each event, and the timer runs that the
+ * move triggers are recorded as ticks.
+ */
+
+#ifndef HID_CAPTURE_H__
+#define HID_CAPTURE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+#include "nrf_host.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Magic number at the start of a capture, "HIDC".
+ */
+#define HID_CAPTURE_MAGIC       0x43444948
+
+/**
+ * @brief Version of the file format.
+ */
+#define HID_CAPTURE_VERSION     1
+
+
+/**
+ * @brief Record types.
+ */
+typedef enum
+{
+    HID_CAPTURE_OUT  = 0,   /**< OUT report, delivered to the device. */
+    HID_CAPTURE_IN   = 1,   /**< IN report, read from the device. */
+    HID_CAPTURE_TICK = 2,   /**< Expired timers run, no report. */
+} hid_capture_type_t;
+
+
+/**
+ * @brief Header of a capture file.
+ */
+typedef struct
+{
+    uint32_t magic;         /**< @ref HID_CAPTURE_MAGIC. */
+    uint16_t version;       /**< @ref HID_CAPTURE_VERSION. */
+    uint16_t report_size;   /**< @ref HOST_USBD_REPORT_SIZE. */
+    uint32_t seed;          /**< Seed of the random numbers of the device. */
+    uint32_t reserved;
+} hid_capture_header_t;
+
+
+/**
+ * @brief Header of a record in a capture file.
+ */
+typedef struct
+{
+    uint64_t time_ns;       /**< Device clock, see host_clock_ns(). */
+    uint8_t  type;          /**< @ref hid_capture_type_t. */
+    uint8_t  client;        /**< Socket client of an OUT report. */
+    uint16_t size;          /**< Report bytes that follow, 0 for a tick. */
+    uint32_t reserved;
+} hid_capture_record_header_t;
+
+
+/**
+ * @brief Record of a capture loaded in memory.
+ */
+typedef struct
+{
+    uint64_t time_ns;
+    uint8_t  type;
+    uint8_t  client;
+    uint8_t  report[HOST_USBD_REPORT_SIZE];
+} hid_capture_record_t;
+
+
+/**
+ * @brief Capture loaded in memory.
+ */
+typedef struct
+{
+    uint32_t               seed;        /**< Seed of the random numbers. */
+    size_t                 count;       /**< Number of records. */
+    hid_capture_record_t * p_records;   /**< Records, in order. */
+} hid_capture_t;
+
+
+/**
+ * @brief Start recording to @p p_path.
+ *
+ * Stops the device clock; from then on @ref hid_capture_clock_sync moves it.
+ *
+ * @param[in] p_path    Capture file, replaced if it exists.
+ * @param[in] seed      Seed the random numbers of the device were set with.
+ *
+ * @retval NRF_SUCCESS          Recording.
+ * @retval NRF_ERROR_INTERNAL   File error, see errno.
+ */
+ret_code_t hid_capture_open(char const * p_path, uint32_t seed);
+
+
+/**
+ * @brief Tell whether a capture is being recorded.
+ */
+bool hid_capture_is_open(void);
+
+
+/**
+ * @brief Move the stopped device clock to the wall time, and run the timers.
+ *
+ * Records a tick if timers expired. Does nothing if not recording.
+ */
+void hid_capture_clock_sync(void);
+
+
+/**
+ * @brief Record a report, at the current time of the device clock.
+ *
+ * Does nothing if not recording.
+ *
+ * @param[in] type      @ref HID_CAPTURE_OUT or @ref HID_CAPTURE_IN.
+ * @param[in] client    Client of an OUT report.
+ * @param[in] p_report  Report, @ref HOST_USBD_REPORT_SIZE bytes.
+ */
+void hid_capture_report(hid_capture_type_t type, uint8_t client,
+                        uint8_t const * p_report);
+
+
+/**
+ * @brief Stop recording, and close the file.
+ */
+void hid_capture_close(void);
+
+
+/**
+ * @brief Load the capture file at @p p_path.
+ *
+ * @param[in]  p_path       Capture file.
+ * @param[out] p_capture    Capture, to free with @ref hid_capture_free.
+ *
+ * @retval NRF_SUCCESS              Loaded.
+ * @retval NRF_ERROR_NOT_FOUND      Cannot open the file.
+ * @retval NRF_ERROR_INVALID_DATA   Not a capture, or truncated.
+ * @retval NRF_ERROR_NO_MEM         Out of memory.
+ */
+ret_code_t hid_capture_load(char const * p_path, hid_capture_t * p_capture);
+
+
+/**
+ * @brief Free a capture loaded by @ref hid_capture_load.
+ */
+void hid_capture_free(hid_capture_t * p_capture);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HID_CAPTURE_H__
@@ -0,0 +1,283 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file hid_socket.c
+ * @brief Virtual HID device over a Unix domain socket.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "app_util.h"
+#include "nrf_host.h"
+#include "hid_socket.h"
+#include "hid_capture.h"
+
+
+/**
+ * @brief Connected client, with the part of an OUT report received.
+ */
+typedef struct
+{
+    int      fd;
+    size_t   size;
+    uint32_t dropped;
+    uint8_t  report[HOST_USBD_REPORT_SIZE];
+} hid_socket_client_t;
+
+
+static int m_listen_fd = -1;
+
+static struct sockaddr_un m_addr;
+
+static hid_socket_client_t m_clients[HID_SOCKET_MAX_CLIENTS];
+
+
+static void client_close(hid_socket_client_t * p_client)
+{
+    close(p_client->fd);
+    p_client->fd = -1;
+    p_client->size = 0;
+}
+
+
+static void client_accept(void)
+{
+    int fd = accept(m_listen_fd, NULL, NULL);
+
+    if(fd < 0) return;
+
+    for(size_t i = 0; i < ARRAY_SIZE(m_clients); i++)
+    {
+        if(m_clients[i].fd < 0)
+        {
+            m_clients[i].fd = fd;
+            m_clients[i].size = 0;
+            m_clients[i].dropped = 0;
+            return;
+        }
+    }
+
+    /* No room left */
+    close(fd);
+}
+
+
+/**
+ * @brief Send the IN reports of the device to all the clients.
+ */
+static void in_reports_send(void)
+{
+    uint8_t report[HOST_USBD_REPORT_SIZE];
+
+    while(host_usbd_in_report_get(report))
+    {
+        hid_capture_report(HID_CAPTURE_IN, 0, report);
+
+        for(size_t i = 0; i < ARRAY_SIZE(m_clients); i++)
+        {
+            if(m_clients[i].fd < 0) continue;
+
+            ssize_t len = send(m_clients[i].fd, report, sizeof(report),
+                               MSG_NOSIGNAL | MSG_DONTWAIT);
+
+            /* A client that does not read loses the reports, as with
+             * hidraw, rather than stalling the device. */
+            if(len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                m_clients[i].dropped++;
+            }
+            else if(len != sizeof(report))
+            {
+                client_close(&m_clients[i]);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Read what a client sent, and deliver its complete reports.
+ */
+static void client_read(hid_socket_client_t * p_client)
+{
+    ssize_t len = recv(p_client->fd, p_client->report + p_client->size,
+                       sizeof(p_client->report) - p_client->size, 0);
+
+    if(len <= 0)
+    {
+        if(len < 0 && (errno == EINTR || errno == EAGAIN)) return;
+        client_close(p_client);
+        return;
+    }
+
+    p_client->size += (size_t)len;
+    if(p_client->size < sizeof(p_client->report)) return;
+
+    p_client->size = 0;
+
+    hid_capture_clock_sync();
+
+    /* The device event queue only fills up when the IN reports are not
+     * read, make room and retry once. */
+    ret_code_t ret = host_usbd_out_report(p_client->report,
+                                          sizeof(p_client->report));
+    if(ret == NRF_ERROR_BUSY)
+    {
+        in_reports_send();
+        ret = host_usbd_out_report(p_client->report, sizeof(p_client->report));
+    }
+
+    /* Recorded once delivered, after the IN reports read to make room */
+    if(ret == NRF_SUCCESS)
+    {
+        hid_capture_report(HID_CAPTURE_OUT,
+                           (uint8_t)(p_client - m_clients), p_client->report);
+    }
+
+    in_reports_send();
+}
+
+
+ret_code_t hid_socket_open(char const * p_path)
+{
+    if(strlen(p_path) >= sizeof(m_addr.sun_path))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for(size_t i = 0; i < ARRAY_SIZE(m_clients); i++)
+    {
+        m_clients[i].fd = -1;
+    }
+
+    memset(&m_addr, 0, sizeof(m_addr));
+    m_addr.sun_family = AF_UNIX;
+    strcpy(m_addr.sun_path, p_path);
+    unlink(p_path);
+
+    m_listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(m_listen_fd < 0)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    if(bind(m_listen_fd, (struct sockaddr *)&m_addr, sizeof(m_addr)) != 0 ||
+       listen(m_listen_fd, HID_SOCKET_MAX_CLIENTS) != 0)
+    {
+        close(m_listen_fd);
+        m_listen_fd = -1;
+        return NRF_ERROR_INTERNAL;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t hid_socket_process(uint32_t timeout_ms)
+{
+    struct pollfd fds[HID_SOCKET_MAX_CLIENTS + 1];
+    hid_socket_client_t * p_clients[HID_SOCKET_MAX_CLIENTS + 1];
+    nfds_t count = 0;
+
+    if(m_listen_fd < 0)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    fds[count].fd = m_listen_fd;
+    fds[count].events = POLLIN;
+    p_clients[count++] = NULL;
+
+    for(size_t i = 0; i < ARRAY_SIZE(m_clients); i++)
+    {
+        if(m_clients[i].fd < 0) continue;
+
+        fds[count].fd = m_clients[i].fd;
+        fds[count].events = POLLIN;
+        p_clients[count++] = &m_clients[i];
+    }
+
+    if(poll(fds, count, (int)timeout_ms) > 0)
+    {
+        for(nfds_t i = 0; i < count; i++)
+        {
+            if((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) == 0) continue;
+
+            if(p_clients[i] == NULL)
+            {
+                client_accept();
+            }
+            else if(p_clients[i]->fd >= 0)
+            {
+                client_read(p_clients[i]);
+            }
+        }
+    }
+
+    if(hid_capture_is_open())
+    {
+        hid_capture_clock_sync();
+    }
+    else
+    {
+        host_rng_process();
+        UNUSED_RETURN_VALUE(app_timer_host_process());
+    }
+    in_reports_send();
+
+    return NRF_SUCCESS;
+}
+
+
+void hid_socket_close(void)
+{
+    if(m_listen_fd < 0) return;
+
+    for(size_t i = 0; i < ARRAY_SIZE(m_clients); i++)
+    {
+        if(m_clients[i].fd >= 0)
+        {
+            client_close(&m_clients[i]);
+        }
+    }
+
+    close(m_listen_fd);
+    m_listen_fd = -1;
+    unlink(m_addr.sun_path);
+}
@@ -0,0 +1,104 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file hid_socket.h
+ * @brief Virtual HID device over a Unix domain socket.
+ *
+ * Carries the 64-byte reports of the U2F HID interface over a stream socket,
+ * so that client code such as tools/u2f_socket_device.py can drive the host
+ * build like a real key. Each OUT report written by a client is delivered to
+ * the HID generic stand-in; each IN report of the device is sent to every
+ * connected client, as hidraw does for the processes that opened a device.
+ * The reports of a client whose socket buffer is full are dropped.
+ *
+ * While a capture is open, see hid_capture.h, the reports delivered and sent
+ * are recorded.
+ */
+
+#ifndef HID_SOCKET_H__
+#define HID_SOCKET_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of connected clients.
+ */
+#define HID_SOCKET_MAX_CLIENTS      8
+
+/**
+ * @brief Timeout of @ref hid_socket_process that keeps the timers running
+ *        when no report comes in, in ms.
+ */
+#define HID_SOCKET_TICK_MS          10
+
+
+/**
+ * @brief Listen on @p p_path.
+ *
+ * An existing socket file at @p p_path is replaced.
+ *
+ * @retval NRF_SUCCESS              Listening.
+ * @retval NRF_ERROR_INVALID_PARAM  Path too long.
+ * @retval NRF_ERROR_INTERNAL       Socket error, see errno.
+ */
+ret_code_t hid_socket_open(char const * p_path);
+
+
+/**
+ * @brief Serve the clients for up to @p timeout_ms.
+ *
+ * Accepts the new clients, delivers their OUT reports, sends the IN reports
+ * of the device and runs the expired timers. Returns after the first batch
+ * of events, or after @p timeout_ms without any.
+ *
+ * @retval NRF_SUCCESS              Events, if any, served.
+ * @retval NRF_ERROR_INVALID_STATE  Not listening.
+ */
+ret_code_t hid_socket_process(uint32_t timeout_ms);
+
+
+/**
+ * @brief Disconnect the clients, and remove the socket file.
+ */
+void hid_socket_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HID_SOCKET_H__
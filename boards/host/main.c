@@ -0,0 +1,967 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file main.c
+ * @brief Test driver of the host build.
+ *
+ * Plays the USB host: sends U2FHID frames to the firmware sources through
+ * the HID generic stand-in, and checks the responses, the signatures with
+ * OpenSSL. Exits nonzero on the first failure.
+ *
+ * Can also serve the device on a Unix socket, recording the traffic, and
+ * replay a recorded capture against a fresh device.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <openssl/x509.h>
+
+#include "nrf.h"
+#include "app_util_platform.h"
+#include "app_timer.h"
+#include "app_error.h"
+#include "nrf_host.h"
+
+#include "u2f.h"
+#include "u2f_crypto.h"
+#include "u2f_crypto_comb.h"
+#include "u2f_hid.h"
+#include "u2f_stats.h"
+#include "timer_platform.h"
+#include "u2f_trace.h"
+#include "u2f_worker.h"
+
+#include "hid_socket.h"
+#include "hid_capture.h"
+
+
+/** Time the driver waits for a response, in ms. */
+#define RESPONSE_TIMEOUT_MS     2000
+
+/** Largest message exchanged by the scenario. */
+#define MSG_MAX_SIZE            (U2F_MAX_RESP_SIZE)
+
+/** Size of the U2F request APDU header, extended length encoding. */
+#define APDU_HEADER_SIZE        7
+
+
+#define CHECK(cond, ...)                                    \
+    do                                                      \
+    {                                                       \
+        if(!(cond))                                         \
+        {                                                   \
+            fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__);                   \
+            fprintf(stderr, "\n");                          \
+            exit(EXIT_FAILURE);                             \
+        }                                                   \
+    } while(0)
+
+
+extern const uint8_t attestation_cert[];
+extern uint16_t attestation_cert_size;
+
+
+/** User presence, consumed by the next register or authenticate. */
+static bool m_user_present;
+
+/** Confirm every user presence check, for the clients of the socket. */
+static bool m_user_always_present;
+
+/** Stop serving the socket. */
+static volatile sig_atomic_t m_stop;
+
+
+/**
+ * @brief Check user button state.
+ */
+bool is_user_button_pressed(void)
+{
+    if(m_user_present || m_user_always_present)
+    {
+        m_user_present = false;
+        return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Send a U2FHID message, split in frames.
+ */
+static void hid_send(uint32_t cid, uint8_t cmd, uint8_t const * p_data,
+                     size_t size)
+{
+    U2FHID_FRAME frame;
+    size_t offset;
+    uint8_t seq = 0;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.cid = cid;
+    frame.init.cmd = cmd;
+    frame.init.bcnth = (uint8_t)(size >> 8);
+    frame.init.bcntl = (uint8_t)(size & 0xFF);
+    offset = MIN(size, sizeof(frame.init.data));
+    memcpy(frame.init.data, p_data, offset);
+    CHECK(host_usbd_out_report((uint8_t *)&frame, sizeof(frame)) == NRF_SUCCESS,
+          "OUT report refused");
+
+    while(offset < size)
+    {
+        size_t len = MIN(size - offset, sizeof(frame.cont.data));
+
+        memset(&frame, 0, sizeof(frame));
+        frame.cid = cid;
+        frame.cont.seq = seq++;
+        memcpy(frame.cont.data, p_data + offset, len);
+        offset += len;
+        CHECK(host_usbd_out_report((uint8_t *)&frame, sizeof(frame)) == NRF_SUCCESS,
+              "OUT report refused");
+    }
+}
+
+
+/**
+ * @brief Read an IN report, running the timers while waiting.
+ */
+static bool hid_frame_get(U2FHID_FRAME * p_frame)
+{
+    uint64_t deadline = host_clock_ns() + RESPONSE_TIMEOUT_MS * 1000000ULL;
+
+    while(host_clock_ns() < deadline)
+    {
+        if(host_usbd_in_report_get((uint8_t *)p_frame))
+        {
+            return true;
+        }
+        host_rng_process();
+        app_timer_host_process();
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Receive a U2FHID message on @p cid.
+ *
+ * @return Command of the response.
+ */
+static uint8_t hid_recv(uint32_t cid, uint8_t * p_data, size_t * p_size)
+{
+    U2FHID_FRAME frame;
+    size_t size, offset;
+    uint8_t cmd, seq = 0;
+
+    CHECK(hid_frame_get(&frame), "no response on cid 0x%08x", cid);
+    CHECK(frame.cid == cid, "response on cid 0x%08x, expected 0x%08x",
+          frame.cid, cid);
+    CHECK(FRAME_TYPE(frame) == TYPE_INIT, "continuation frame first");
+
+    cmd = frame.init.cmd;
+    size = MSG_LEN(frame);
+    CHECK(size <= MSG_MAX_SIZE, "response of %u bytes", (unsigned)size);
+    offset = MIN(size, sizeof(frame.init.data));
+    memcpy(p_data, frame.init.data, offset);
+
+    while(offset < size)
+    {
+        size_t len = MIN(size - offset, sizeof(frame.cont.data));
+
+        CHECK(hid_frame_get(&frame), "response truncated at %u bytes",
+              (unsigned)offset);
+        CHECK(frame.cid == cid && FRAME_TYPE(frame) == TYPE_CONT &&
+              FRAME_SEQ(frame) == seq, "bad continuation frame %u", seq);
+        seq++;
+        memcpy(p_data + offset, frame.cont.data, len);
+        offset += len;
+    }
+
+    *p_size = size;
+
+    return cmd;
+}
+
+
+/**
+ * @brief Expect an ERROR response with @p error on @p cid.
+ */
+static void hid_error_expect(uint32_t cid, uint8_t error)
+{
+    uint8_t resp[MSG_MAX_SIZE];
+    size_t size;
+
+    CHECK(hid_recv(cid, resp, &size) == U2FHID_ERROR, "ERROR expected");
+    CHECK(size == 1 && resp[0] == error, "error 0x%02x, expected 0x%02x",
+          resp[0], error);
+}
+
+
+/**
+ * @brief Send a U2F request APDU in a MSG, and receive the response.
+ *
+ * @return Status word of the response.
+ */
+static uint16_t u2f_apdu(uint32_t cid, uint8_t ins, uint8_t p1, uint8_t p2,
+                         uint8_t const * p_req, size_t req_size,
+                         uint8_t * p_resp, size_t * p_resp_size)
+{
+    uint8_t apdu[APDU_HEADER_SIZE + U2F_MAX_REQ_SIZE];
+    size_t size;
+
+    apdu[0] = 0;
+    apdu[1] = ins;
+    apdu[2] = p1;
+    apdu[3] = p2;
+    apdu[4] = 0;
+    apdu[5] = (uint8_t)(req_size >> 8);
+    apdu[6] = (uint8_t)(req_size & 0xFF);
+    memcpy(&apdu[APDU_HEADER_SIZE], p_req, req_size);
+
+    hid_send(cid, U2FHID_MSG, apdu, APDU_HEADER_SIZE + req_size);
+    CHECK(hid_recv(cid, p_resp, &size) == U2FHID_MSG, "MSG expected");
+    CHECK(size >= 2, "response without status word");
+
+    *p_resp_size = size - 2;
+
+    return uint16_big_decode(&p_resp[size - 2]);
+}
+
+
+static uint16_t u2f_msg(uint32_t cid, uint8_t ins, uint8_t p1,
+                        uint8_t const * p_req, size_t req_size,
+                        uint8_t * p_resp, size_t * p_resp_size)
+{
+    return u2f_apdu(cid, ins, p1, 0, p_req, req_size, p_resp, p_resp_size);
+}
+
+
+/**
+ * @brief Size of the DER element at @p p_der.
+ */
+static size_t der_size_get(uint8_t const * p_der)
+{
+    if(p_der[1] < 0x80) return 2 + p_der[1];
+    if(p_der[1] == 0x81) return 3 + p_der[2];
+    return 4 + ((size_t)p_der[2] << 8) + p_der[3];
+}
+
+
+/**
+ * @brief Verify a DER ECDSA signature of the SHA-256 of @p p_msg.
+ */
+static bool signature_verify(EC_KEY const * p_key, uint8_t const * p_msg,
+                             size_t msg_size, uint8_t const * p_sig,
+                             size_t sig_size)
+{
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+
+    SHA256(p_msg, msg_size, hash);
+
+    return ECDSA_verify(0, hash, sizeof(hash), p_sig, (int)sig_size,
+                        (EC_KEY *)p_key) == 1;
+}
+
+
+/**
+ * @brief Allocate a channel with INIT on the broadcast channel.
+ */
+static uint32_t scenario_init(void)
+{
+    uint8_t nonce[INIT_NONCE_SIZE] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t resp[MSG_MAX_SIZE];
+    U2FHID_INIT_RESP init_resp;
+    size_t size;
+
+    hid_send(CID_BROADCAST, U2FHID_INIT, nonce, sizeof(nonce));
+    CHECK(hid_recv(CID_BROADCAST, resp, &size) == U2FHID_INIT, "INIT expected");
+    CHECK(size >= sizeof(init_resp), "INIT response of %u bytes", (unsigned)size);
+    memcpy(&init_resp, resp, sizeof(init_resp));
+    CHECK(memcmp(init_resp.nonce, nonce, sizeof(nonce)) == 0, "nonce mismatch");
+    CHECK(init_resp.cid != 0 && init_resp.cid != CID_BROADCAST,
+          "invalid cid 0x%08x", init_resp.cid);
+    CHECK(init_resp.versionInterface == U2FHID_IF_VERSION, "interface version");
+
+    printf("INIT: cid 0x%08x\n", init_resp.cid);
+
+    return init_resp.cid;
+}
+
+
+/**
+ * @brief Echo a multi-frame payload.
+ */
+static void scenario_ping(uint32_t cid)
+{
+    uint8_t data[200];
+    uint8_t resp[MSG_MAX_SIZE];
+    size_t size;
+
+    for(size_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 7);
+    }
+
+    hid_send(cid, U2FHID_PING, data, sizeof(data));
+    CHECK(hid_recv(cid, resp, &size) == U2FHID_PING, "PING expected");
+    CHECK(size == sizeof(data) && memcmp(resp, data, size) == 0, "echo mismatch");
+
+    printf("PING: %u bytes echoed\n", (unsigned)size);
+}
+
+
+static void scenario_version(uint32_t cid)
+{
+    uint8_t resp[MSG_MAX_SIZE];
+    size_t size;
+
+    CHECK(u2f_msg(cid, U2F_VERSION, 0, NULL, 0, resp, &size) == U2F_SW_NO_ERROR,
+          "VERSION status");
+    CHECK(size == strlen(VENDOR_U2F_VERSION) &&
+          memcmp(resp, VENDOR_U2F_VERSION, size) == 0, "VERSION string");
+
+    printf("VERSION: %.*s\n", (int)size, resp);
+}
+
+
+/**
+ * @brief Check the attestation signature of a registration response.
+ */
+static void attestation_verify(U2F_REGISTER_REQ const * p_req,
+                               uint8_t const * p_resp, size_t size)
+{
+    uint8_t msg[1 + U2F_APPID_SIZE + U2F_CHAL_SIZE + U2F_MAX_KH_SIZE +
+                U2F_EC_POINT_SIZE];
+    uint8_t const * p;
+    size_t msg_size, cert_size;
+    uint8_t kh_size;
+    X509 * p_cert;
+
+    CHECK(p_resp[0] == U2F_REGISTER_ID, "register id");
+    kh_size = p_resp[1 + U2F_EC_POINT_SIZE];
+    CHECK(kh_size > 0 && kh_size <= U2F_MAX_KH_SIZE, "key handle size");
+
+    p = &p_resp[2 + U2F_EC_POINT_SIZE + kh_size];
+    cert_size = der_size_get(p);
+    CHECK(cert_size == attestation_cert_size, "certificate size");
+    p_cert = d2i_X509(NULL, &p, (long)cert_size);
+    CHECK(p_cert != NULL, "certificate parse");
+
+    msg_size = 0;
+    msg[msg_size++] = U2F_REGISTER_HASH_ID;
+    memcpy(&msg[msg_size], p_req->appId, U2F_APPID_SIZE);
+    msg_size += U2F_APPID_SIZE;
+    memcpy(&msg[msg_size], p_req->chal, U2F_CHAL_SIZE);
+    msg_size += U2F_CHAL_SIZE;
+    memcpy(&msg[msg_size], &p_resp[2 + U2F_EC_POINT_SIZE], kh_size);
+    msg_size += kh_size;
+    memcpy(&msg[msg_size], &p_resp[1], U2F_EC_POINT_SIZE);
+    msg_size += U2F_EC_POINT_SIZE;
+
+    CHECK(signature_verify(EVP_PKEY_get0_EC_KEY(X509_get0_pubkey(p_cert)),
+                           msg, msg_size, p, size - (size_t)(p - p_resp)),
+          "attestation signature");
+    X509_free(p_cert);
+}
+
+
+/**
+ * @brief Register, and check the attestation signature.
+ *
+ * @return Credential public key.
+ */
+static EC_KEY * scenario_register(uint32_t cid, uint8_t const * p_app_id,
+                                  uint8_t * p_key_handle, uint8_t * p_kh_size)
+{
+    U2F_REGISTER_REQ req;
+    uint8_t resp[MSG_MAX_SIZE];
+    uint8_t const * p;
+    size_t size;
+    uint8_t kh_size;
+    EC_KEY * p_key;
+
+    memset(req.chal, 0xC1, sizeof(req.chal));
+    memcpy(req.appId, p_app_id, sizeof(req.appId));
+
+    m_user_present = false;
+    CHECK(u2f_msg(cid, U2F_REGISTER, 0, (uint8_t *)&req, sizeof(req),
+                  resp, &size) == U2F_SW_CONDITIONS_NOT_SATISFIED,
+          "REGISTER without user presence");
+
+    m_user_present = true;
+    CHECK(u2f_msg(cid, U2F_REGISTER, 0, (uint8_t *)&req, sizeof(req),
+                  resp, &size) == U2F_SW_NO_ERROR, "REGISTER status");
+
+    CHECK(resp[1] == U2F_POINT_UNCOMPRESSED, "point format");
+    attestation_verify(&req, resp, size);
+    kh_size = resp[1 + U2F_EC_POINT_SIZE];
+
+    p = &resp[1];
+    p_key = EC_KEY_new_by_curve_name(NID_X9_62_prime256v1);
+    CHECK(p_key != NULL && o2i_ECPublicKey(&p_key, &p, U2F_EC_POINT_SIZE) != NULL,
+          "public key");
+
+    memcpy(p_key_handle, &resp[2 + U2F_EC_POINT_SIZE], kh_size);
+    *p_kh_size = kh_size;
+
+    printf("REGISTER: key handle of %u bytes, attestation verified\n", kh_size);
+
+    return p_key;
+}
+
+
+/**
+ * @brief Authenticate, and check the signature.
+ *
+ * @return Counter of the response.
+ */
+static uint32_t scenario_authenticate(uint32_t cid, EC_KEY * p_key,
+                                      uint8_t const * p_app_id,
+                                      uint8_t const * p_key_handle,
+                                      uint8_t kh_size)
+{
+    U2F_AUTHENTICATE_REQ req;
+    uint8_t resp[MSG_MAX_SIZE];
+    uint8_t msg[U2F_APPID_SIZE + 1 + U2F_CTR_SIZE + U2F_CHAL_SIZE];
+    size_t size, req_size;
+
+    memset(req.chal, 0xA5, sizeof(req.chal));
+    memcpy(req.appId, p_app_id, sizeof(req.appId));
+    req.keyHandleLen = kh_size;
+    memcpy(req.keyHandle, p_key_handle, kh_size);
+    req_size = offsetof(U2F_AUTHENTICATE_REQ, keyHandle) + kh_size;
+
+    m_user_present = true;
+    CHECK(u2f_msg(cid, U2F_AUTHENTICATE, U2F_AUTH_ENFORCE, (uint8_t *)&req,
+                  req_size, resp, &size) == U2F_SW_NO_ERROR,
+          "AUTHENTICATE status");
+    CHECK(size > 1 + U2F_CTR_SIZE, "AUTHENTICATE response of %u bytes",
+          (unsigned)size);
+    CHECK(resp[0] & U2F_AUTH_FLAG_TUP, "user presence flag");
+
+    memcpy(msg, req.appId, U2F_APPID_SIZE);
+    memcpy(&msg[U2F_APPID_SIZE], resp, 1 + U2F_CTR_SIZE);
+    memcpy(&msg[U2F_APPID_SIZE + 1 + U2F_CTR_SIZE], req.chal, U2F_CHAL_SIZE);
+
+    CHECK(signature_verify(p_key, msg, sizeof(msg), &resp[1 + U2F_CTR_SIZE],
+                           size - 1 - U2F_CTR_SIZE), "authentication signature");
+
+    uint32_t counter = uint32_big_decode(&resp[1]);
+
+    printf("AUTHENTICATE: counter %u, signature verified\n", counter);
+
+    return counter;
+}
+
+
+/**
+ * @brief Sign with comb, out of a nonce pool filled as the main loop does
+ *        while idle, and check the signatures.
+ */
+static void scenario_nonces(uint32_t cid, EC_KEY * p_key,
+                            uint8_t const * p_app_id,
+                            uint8_t const * p_key_handle, uint8_t kh_size)
+{
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_COMB)
+    u2f_crypto_backend_id_t backend = u2f_crypto_backend_get(U2F_CRYPTO_OP_SIGN);
+    u2f_crypto_comb_stats_t before, after;
+
+    CHECK(u2f_crypto_backend_select(U2F_CRYPTO_OP_SIGN,
+                                    U2F_CRYPTO_BACKEND_COMB) == NRF_SUCCESS,
+          "comb not selected");
+
+    while(u2f_crypto_process())
+    {
+    }
+
+    u2f_crypto_comb_stats_get(&before);
+    CHECK(before.pool_size > 0, "no nonce pool");
+    CHECK(before.pool_ready == before.pool_size, "nonce pool %u/%u filled",
+          (unsigned)before.pool_ready, (unsigned)before.pool_size);
+
+    for(uint32_t i = 0; i < before.pool_size; i++)
+    {
+        UNUSED_RETURN_VALUE(scenario_authenticate(cid, p_key, p_app_id,
+                                                  p_key_handle, kh_size));
+    }
+
+    u2f_crypto_comb_stats_get(&after);
+    CHECK(after.pool_hits - before.pool_hits == before.pool_size &&
+          after.pool_misses == before.pool_misses,
+          "%u signatures out of the pool, %u missed",
+          (unsigned)(after.pool_hits - before.pool_hits),
+          (unsigned)(after.pool_misses - before.pool_misses));
+
+    CHECK(u2f_crypto_backend_select(U2F_CRYPTO_OP_SIGN, backend) == NRF_SUCCESS,
+          "sign backend not restored");
+
+    printf("NONCES: %u signatures out of the comb pool verified\n",
+           (unsigned)before.pool_size);
+#else
+    UNUSED_PARAMETER(cid);
+    UNUSED_PARAMETER(p_key);
+    UNUSED_PARAMETER(p_app_id);
+    UNUSED_PARAMETER(p_key_handle);
+    UNUSED_PARAMETER(kh_size);
+#endif
+}
+
+
+/**
+ * @brief Register an Ed25519 credential with the vendor instruction, and
+ *        authenticate with it.
+ */
+static void scenario_ed25519(uint32_t cid, uint8_t const * p_app_id)
+{
+    U2F_REGISTER_REQ reg_req;
+    U2F_AUTHENTICATE_REQ auth_req;
+    uint8_t resp[MSG_MAX_SIZE];
+    uint8_t msg[U2F_APPID_SIZE + 1 + U2F_CTR_SIZE + U2F_CHAL_SIZE];
+    uint8_t const zero[U2F_EC_KEY_SIZE] = { 0 };
+    size_t size;
+    uint8_t kh_size;
+    EVP_PKEY * p_key;
+    EVP_MD_CTX * p_ctx;
+
+    memset(reg_req.chal, 0xC3, sizeof(reg_req.chal));
+    memcpy(reg_req.appId, p_app_id, sizeof(reg_req.appId));
+
+    CHECK(u2f_apdu(cid, U2F_VENDOR_REGISTER_ALG, 0, U2F_CRYPTO_ALG_COUNT,
+                   (uint8_t *)&reg_req, sizeof(reg_req), resp, &size) ==
+          U2F_SW_WRONG_DATA, "REGISTER of an unknown algorithm");
+
+    m_user_present = true;
+    CHECK(u2f_apdu(cid, U2F_VENDOR_REGISTER_ALG, 0, U2F_CRYPTO_ALG_ED25519,
+                   (uint8_t *)&reg_req, sizeof(reg_req), resp, &size) ==
+          U2F_SW_NO_ERROR, "Ed25519 REGISTER status");
+
+    CHECK(resp[1] == U2F_POINT_ED25519, "Ed25519 point format");
+    CHECK(memcmp(&resp[2 + U2F_EC_KEY_SIZE], zero, sizeof(zero)) == 0,
+          "Ed25519 point y");
+    attestation_verify(&reg_req, resp, size);
+
+    p_key = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL, &resp[2],
+                                        U2F_CRYPTO_ED25519_PUBLIC_KEY_SIZE);
+    CHECK(p_key != NULL, "Ed25519 public key");
+
+    kh_size = resp[1 + U2F_EC_POINT_SIZE];
+    memset(auth_req.chal, 0xA7, sizeof(auth_req.chal));
+    memcpy(auth_req.appId, p_app_id, sizeof(auth_req.appId));
+    auth_req.keyHandleLen = kh_size;
+    memcpy(auth_req.keyHandle, &resp[2 + U2F_EC_POINT_SIZE], kh_size);
+
+    m_user_present = true;
+    CHECK(u2f_msg(cid, U2F_AUTHENTICATE, U2F_AUTH_ENFORCE, (uint8_t *)&auth_req,
+                  offsetof(U2F_AUTHENTICATE_REQ, keyHandle) + kh_size,
+                  resp, &size) == U2F_SW_NO_ERROR,
+          "Ed25519 AUTHENTICATE status");
+    CHECK(size == 1 + U2F_CTR_SIZE + U2F_CRYPTO_ED25519_SIGNATURE_SIZE,
+          "Ed25519 AUTHENTICATE response of %u bytes", (unsigned)size);
+
+    memcpy(msg, auth_req.appId, U2F_APPID_SIZE);
+    memcpy(&msg[U2F_APPID_SIZE], resp, 1 + U2F_CTR_SIZE);
+    memcpy(&msg[U2F_APPID_SIZE + 1 + U2F_CTR_SIZE], auth_req.chal,
+           U2F_CHAL_SIZE);
+
+    p_ctx = EVP_MD_CTX_new();
+    CHECK(p_ctx != NULL &&
+          EVP_DigestVerifyInit(p_ctx, NULL, NULL, NULL, p_key) == 1 &&
+          EVP_DigestVerify(p_ctx, &resp[1 + U2F_CTR_SIZE],
+                           U2F_CRYPTO_ED25519_SIGNATURE_SIZE,
+                           msg, sizeof(msg)) == 1,
+          "Ed25519 authentication signature");
+    EVP_MD_CTX_free(p_ctx);
+    EVP_PKEY_free(p_key);
+
+    printf("ED25519: key handle of %u bytes, signature verified\n", kh_size);
+}
+
+
+/**
+ * @brief Error paths of the frame layer.
+ */
+static void scenario_errors(uint32_t cid)
+{
+    uint8_t data[100] = { 0 };
+
+    /* Unknown channel */
+    hid_send(0x01020304, U2FHID_PING, data, 8);
+    hid_error_expect(0x01020304, ERR_CHANNEL_BUSY);
+
+    /* Wrong key handle */
+    U2F_AUTHENTICATE_REQ req;
+    uint8_t resp[MSG_MAX_SIZE];
+    size_t size;
+
+    memset(&req, 0, sizeof(req));
+    req.keyHandleLen = 64;
+    m_user_present = true;
+    CHECK(u2f_msg(cid, U2F_AUTHENTICATE, U2F_AUTH_ENFORCE, (uint8_t *)&req,
+                  offsetof(U2F_AUTHENTICATE_REQ, keyHandle) + 64,
+                  resp, &size) == U2F_SW_WRONG_DATA, "bad key handle status");
+    m_user_present = false;
+
+    /* Message timeout: the continuation frames never come */
+    U2FHID_FRAME frame;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.cid = cid;
+    frame.init.cmd = U2FHID_PING;
+    frame.init.bcntl = sizeof(data);
+    CHECK(host_usbd_out_report((uint8_t *)&frame, sizeof(frame)) == NRF_SUCCESS,
+          "OUT report refused");
+    host_clock_skip_ms(U2FHID_TRANS_TIMEOUT);
+    hid_error_expect(cid, ERR_MSG_TIMEOUT);
+
+    printf("ERRORS: unknown channel, bad key handle and timeout handled\n");
+}
+
+
+/**
+ * @brief Run the scenario against the device.
+ */
+static void scenario_run(void)
+{
+    uint8_t app_id[U2F_APPID_SIZE];
+    uint8_t key_handle[U2F_MAX_KH_SIZE];
+    uint8_t kh_size;
+
+    SHA256((uint8_t const *)"https://example.com", 19, app_id);
+
+    uint32_t cid = scenario_init();
+
+    scenario_ping(cid);
+    scenario_version(cid);
+
+    EC_KEY * p_key = scenario_register(cid, app_id, key_handle, &kh_size);
+
+    uint32_t counter = scenario_authenticate(cid, p_key, app_id, key_handle,
+                                             kh_size);
+    CHECK(scenario_authenticate(cid, p_key, app_id, key_handle, kh_size) ==
+          counter + 1, "counter not incremented");
+    scenario_nonces(cid, p_key, app_id, key_handle, kh_size);
+    EC_KEY_free(p_key);
+
+    scenario_ed25519(cid, app_id);
+    scenario_errors(cid);
+
+    printf("PASS\n");
+}
+
+
+/**
+ * @brief Print a report, 16 bytes a line.
+ */
+static void report_dump(char const * p_title, uint8_t const * p_report)
+{
+    fprintf(stderr, "%s:\n", p_title);
+    for(size_t i = 0; i < HOST_USBD_REPORT_SIZE; i++)
+    {
+        fprintf(stderr, "%s%02x", (i % 16 == 0) ? "  " : " ", p_report[i]);
+        if(i % 16 == 15)
+        {
+            fprintf(stderr, "\n");
+        }
+    }
+}
+
+
+/**
+ * @brief Replay @p p_capture, and check the IN reports of the device.
+ *
+ * The device clock is moved to the time of each record, so that the timers
+ * expire at the same points of the traffic as when it was recorded. The
+ * replay itself runs as fast as the device answers, and is timed.
+ */
+static void capture_replay(hid_capture_t const * p_capture)
+{
+    uint8_t report[HOST_USBD_REPORT_SIZE];
+    size_t out_count = 0, in_count = 0;
+    struct timespec start, end;
+
+    m_user_always_present = true;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(size_t i = 0; i < p_capture->count; i++)
+    {
+        hid_capture_record_t const * p_record = &p_capture->p_records[i];
+
+        switch(p_record->type)
+        {
+            case HID_CAPTURE_OUT:
+                host_clock_set_ns(p_record->time_ns);
+                UNUSED_RETURN_VALUE(app_timer_host_process());
+                CHECK(host_usbd_out_report(p_record->report,
+                                           sizeof(p_record->report)) == NRF_SUCCESS,
+                      "record %zu: OUT report refused", i);
+                out_count++;
+                break;
+
+            case HID_CAPTURE_IN:
+                CHECK(host_usbd_in_report_get(report),
+                      "record %zu: no IN report", i);
+                if(memcmp(report, p_record->report, sizeof(report)) != 0)
+                {
+                    report_dump("expected", p_record->report);
+                    report_dump("got", report);
+                    CHECK(false, "record %zu: IN report differs", i);
+                }
+                in_count++;
+                break;
+
+            default:
+                host_clock_set_ns(p_record->time_ns);
+                UNUSED_RETURN_VALUE(app_timer_host_process());
+                break;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if(host_usbd_in_report_get(report))
+    {
+        report_dump("got", report);
+        CHECK(false, "IN report after the end of the capture");
+    }
+
+    double elapsed_ms = (end.tv_sec - start.tv_sec) * 1e3 +
+                        (end.tv_nsec - start.tv_nsec) / 1e6;
+
+    printf("REPLAY: %zu OUT and %zu IN reports in %.3f ms, %.0f reports/s\n",
+           out_count, in_count, elapsed_ms,
+           (elapsed_ms > 0) ? (out_count + in_count) * 1e3 / elapsed_ms : 0);
+    printf("PASS\n");
+}
+
+
+static void stop_handler(int sig)
+{
+    m_stop = 1;
+}
+
+
+/**
+ * @brief Serve the clients of the socket at @p p_path until interrupted.
+ */
+static void socket_serve(char const * p_path)
+{
+    CHECK(hid_socket_open(p_path) == NRF_SUCCESS, "cannot listen on %s", p_path);
+
+    signal(SIGINT, stop_handler);
+    signal(SIGTERM, stop_handler);
+
+    m_user_always_present = true;
+
+    printf("Listening on %s\n", p_path);
+    fflush(stdout);
+
+    while(!m_stop)
+    {
+        /* As the main loop of the target. Not while recording: the idle
+         * time, hence the random numbers drawn, would differ on replay. */
+        bool crypto_busy = !hid_capture_is_open() && !u2f_worker_is_busy() &&
+                           u2f_crypto_process();
+
+        UNUSED_RETURN_VALUE(hid_socket_process(crypto_busy ? 0 : HID_SOCKET_TICK_MS));
+        u2f_trace_flush();
+        u2f_impl_process();
+        u2f_stats_process();
+    }
+
+    hid_socket_close();
+}
+
+
+static void usage(char const * p_name)
+{
+    fprintf(stderr,
+            "Usage: %s [-u socket [-r capture] | -p capture] [-f image]\n"
+            "          [-t trace] [-v level] [-s] [-c line]...\n"
+            "  -u socket serve a virtual HID device on a Unix socket, instead\n"
+            "            of running the test scenario; user presence is always\n"
+            "            confirmed\n"
+            "  -r capture record the reports served to a capture file\n"
+            "  -p capture replay a capture file, and check the IN reports\n"
+            "  -f image  back the flash data storage with a file\n"
+            "  -t trace  write the binary event trace to a file\n"
+            "  -v level  log level, 0 (off) to 4 (debug)\n"
+            "  -s        dump the statistics at the end\n"
+            "  -c line   run a CLI command line at the end, e.g. \"bench all\"\n",
+            p_name);
+}
+
+
+int main(int argc, char * argv[])
+{
+    ret_code_t ret;
+    FILE * p_trace = NULL;
+    char const * p_socket = NULL;
+    char const * p_record = NULL;
+    char const * p_replay = NULL;
+    char const * p_image = NULL;
+    char const * p_lines[8];
+    size_t line_count = 0;
+    hid_capture_t capture;
+    bool stats = false;
+    int opt;
+
+    while((opt = getopt(argc, argv, "u:r:p:f:t:v:sc:h")) != -1)
+    {
+        switch(opt)
+        {
+            case 'u':
+                p_socket = optarg;
+                break;
+
+            case 'r':
+                p_record = optarg;
+                break;
+
+            case 'p':
+                p_replay = optarg;
+                break;
+
+            case 'f':
+                p_image = optarg;
+                fds_host_image_set(optarg);
+                break;
+
+            case 't':
+                p_trace = fopen(optarg, "wb");
+                CHECK(p_trace != NULL, "cannot open %s", optarg);
+                SEGGER_RTT_host_output_set(U2F_TRACE_RTT_CHANNEL, p_trace);
+                break;
+
+            case 'v':
+                nrf_log_host_level_set((uint8_t)atoi(optarg));
+                break;
+
+            case 's':
+                stats = true;
+                break;
+
+            case 'c':
+                CHECK(line_count < ARRAY_SIZE(p_lines), "too many -c");
+                p_lines[line_count++] = optarg;
+                break;
+
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    /* A capture replays against the device it was recorded on: empty
+     * flash, stopped clock and seeded random numbers. */
+    if(p_record != NULL || p_replay != NULL)
+    {
+        CHECK(p_image == NULL, "-f cannot be used with a capture");
+    }
+
+    if(p_record != NULL)
+    {
+        uint32_t seed = (uint32_t)time(NULL) ^ (uint32_t)getpid();
+
+        CHECK(p_socket != NULL, "-r needs -u");
+        CHECK(hid_capture_open(p_record, seed) == NRF_SUCCESS,
+              "cannot open %s", p_record);
+        nrf_crypto_host_rng_seed(seed);
+    }
+
+    if(p_replay != NULL)
+    {
+        CHECK(p_socket == NULL, "-p cannot be used with -u");
+        ret = hid_capture_load(p_replay, &capture);
+        CHECK(ret == NRF_SUCCESS, "cannot load %s: error 0x%04x", p_replay,
+              (unsigned)ret);
+        host_clock_stop();
+        nrf_crypto_host_rng_seed(capture.seed);
+    }
+
+    ret = app_timer_init();
+    APP_ERROR_CHECK(ret);
+
+    ret = timer_platform_init();
+    APP_ERROR_CHECK(ret);
+
+    ret = u2f_hid_init();
+    APP_ERROR_CHECK(ret);
+
+    if(p_socket != NULL)
+    {
+        socket_serve(p_socket);
+        hid_capture_close();
+    }
+    else if(p_replay != NULL)
+    {
+        capture_replay(&capture);
+        hid_capture_free(&capture);
+    }
+    else
+    {
+        scenario_run();
+    }
+
+    u2f_trace_flush();
+
+    if(stats)
+    {
+        UNUSED_RETURN_VALUE(nrf_cli_host_exec(stdout, "stats latency"));
+        UNUSED_RETURN_VALUE(nrf_cli_host_exec(stdout, "stats usb"));
+    }
+
+    for(size_t i = 0; i < line_count; i++)
+    {
+        CHECK(nrf_cli_host_exec(stdout, p_lines[i]) == NRF_SUCCESS,
+              "unknown command: %s", p_lines[i]);
+    }
+
+    if(p_trace != NULL)
+    {
+        fclose(p_trace);
+    }
+
+    return EXIT_SUCCESS;
+}
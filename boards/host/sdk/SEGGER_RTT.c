@@ -0,0 +1,79 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file SEGGER_RTT.c
+ * @brief Host stand-in of SEGGER RTT, the up channels write to files.
+ *
+ * A channel without a file accepts and discards everything, like a target
+ * with no debugger attached in skip mode.
+ */
+
+#include <stdio.h>
+
+#include "SEGGER_RTT.h"
+#include "nrf_host.h"
+
+
+static FILE * m_up_files[SEGGER_RTT_MAX_NUM_UP_BUFFERS];
+
+
+void SEGGER_RTT_host_output_set(unsigned channel, FILE * p_file)
+{
+    if(channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+    {
+        m_up_files[channel] = p_file;
+    }
+}
+
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char * sName,
+                              void * pBuffer, unsigned BufferSize,
+                              unsigned Flags)
+{
+    return (BufferIndex < SEGGER_RTT_MAX_NUM_UP_BUFFERS) ? 0 : -1;
+}
+
+
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void * pBuffer,
+                          unsigned NumBytes)
+{
+    if(BufferIndex >= SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+    {
+        return 0;
+    }
+
+    if(m_up_files[BufferIndex] != NULL)
+    {
+        return (unsigned)fwrite(pBuffer, 1, NumBytes, m_up_files[BufferIndex]);
+    }
+
+    return NumBytes;
+}
@@ -0,0 +1,279 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file app_timer.c
+ * @brief Host stand-in of the nRF5 SDK app_timer and of the RTC.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "nrf.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+#include "nrf_host.h"
+
+
+/** Timers created, linked through p_next. */
+static app_timer_t * m_p_timers;
+
+/** Time skipped by @ref host_clock_skip_ms. */
+static uint64_t m_skipped_ns;
+
+/** The clock only moves when told to, see @ref host_clock_stop. */
+static bool m_stopped;
+
+/** Time of the stopped clock. */
+static uint64_t m_stopped_ns;
+
+
+uint64_t host_clock_ns(void)
+{
+    static uint64_t start_ns;
+    struct timespec ts;
+
+    if(m_stopped)
+    {
+        return m_stopped_ns;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    uint64_t now_ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+
+    if(start_ns == 0)
+    {
+        start_ns = now_ns;
+    }
+
+    return now_ns - start_ns + m_skipped_ns;
+}
+
+
+void host_clock_skip_ms(uint32_t ms)
+{
+    if(m_stopped)
+    {
+        m_stopped_ns += (uint64_t)ms * 1000000ULL;
+    }
+    else
+    {
+        m_skipped_ns += (uint64_t)ms * 1000000ULL;
+    }
+    app_timer_host_process();
+}
+
+
+void host_clock_stop(void)
+{
+    m_stopped_ns = host_clock_ns();
+    m_stopped = true;
+}
+
+
+bool host_clock_is_stopped(void)
+{
+    return m_stopped;
+}
+
+
+void host_clock_set_ns(uint64_t ns)
+{
+    if(m_stopped && ns > m_stopped_ns)
+    {
+        m_stopped_ns = ns;
+    }
+}
+
+
+/**
+ * @brief RTC ticks since start, without the 24-bit wrap.
+ */
+static uint64_t rtc_ticks_get(void)
+{
+    return (host_clock_ns() / 1000) * APP_TIMER_CLOCK_FREQ / 1000000;
+}
+
+
+static app_timer_t * expired_timer_get(uint64_t now)
+{
+    for(app_timer_t * p_timer = m_p_timers; p_timer != NULL;
+        p_timer = p_timer->p_next)
+    {
+        if(p_timer->active && p_timer->end_ticks <= now)
+        {
+            return p_timer;
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * @brief RTC interrupt handler, runs the expired timers.
+ */
+void RTC1_IRQHandler(void)
+{
+    app_timer_t * p_timer;
+
+    while((p_timer = expired_timer_get(rtc_ticks_get())) != NULL)
+    {
+        if(p_timer->mode == APP_TIMER_MODE_REPEATED)
+        {
+            p_timer->end_ticks += p_timer->repeat_period;
+        }
+        else
+        {
+            p_timer->active = false;
+        }
+
+        p_timer->p_timeout_handler(p_timer->p_context);
+    }
+}
+
+
+bool app_timer_host_process(void)
+{
+    if(expired_timer_get(rtc_ticks_get()) == NULL)
+    {
+        return false;
+    }
+
+    NVIC_SetPendingIRQ(RTC1_IRQn);
+
+    return true;
+}
+
+
+ret_code_t app_timer_init(void)
+{
+    m_p_timers = NULL;
+
+    NVIC_SetPriority(RTC1_IRQn, APP_TIMER_CONFIG_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(RTC1_IRQn);
+    NVIC_EnableIRQ(RTC1_IRQn);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                            app_timer_mode_t            mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    if(p_timer_id == NULL || timeout_handler == NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    app_timer_t * p_timer = *p_timer_id;
+
+    if(p_timer->active)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    p_timer->p_timeout_handler = timeout_handler;
+    p_timer->mode = mode;
+
+    CRITICAL_REGION_ENTER();
+    app_timer_t * p_it = m_p_timers;
+    while(p_it != NULL && p_it != p_timer)
+    {
+        p_it = p_it->p_next;
+    }
+    if(p_it == NULL)
+    {
+        p_timer->p_next = m_p_timers;
+        m_p_timers = p_timer;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks,
+                           void * p_context)
+{
+    if(timeout_ticks < APP_TIMER_MIN_TIMEOUT_TICKS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if(timer_id->p_timeout_handler == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    CRITICAL_REGION_ENTER();
+    timer_id->p_context = p_context;
+    timer_id->repeat_period = timeout_ticks;
+    timer_id->end_ticks = rtc_ticks_get() + timeout_ticks;
+    timer_id->active = true;
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    timer_id->active = false;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_timer_stop_all(void)
+{
+    for(app_timer_t * p_timer = m_p_timers; p_timer != NULL;
+        p_timer = p_timer->p_next)
+    {
+        p_timer->active = false;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_cnt_get(void)
+{
+    return (uint32_t)(rtc_ticks_get() & APP_TIMER_MAX_CNT_VAL);
+}
+
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from)
+{
+    return ((ticks_to - ticks_from) & APP_TIMER_MAX_CNT_VAL);
+}
@@ -0,0 +1,108 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file app_timer.h
+ * @brief Host stand-in of the nRF5 SDK app_timer.
+ *
+ * The RTC counter follows the host clock at APP_TIMER_CLOCK_FREQ. The
+ * timers run in the RTC1 interrupt, from @ref app_timer_host_process.
+ */
+
+#ifndef APP_TIMER_H__
+#define APP_TIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sdk_config.h"
+#include "sdk_errors.h"
+#include "app_util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define APP_TIMER_CLOCK_FREQ            32768
+#define APP_TIMER_MIN_TIMEOUT_TICKS     5
+#define APP_TIMER_MAX_CNT_VAL           0x00FFFFFF
+
+#define APP_TIMER_TICKS(MS)                                 \
+            ((uint32_t)ROUNDED_DIV(                         \
+            (MS) * (uint64_t)APP_TIMER_CLOCK_FREQ,          \
+            1000 * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1)))
+
+typedef void (*app_timer_timeout_handler_t)(void * p_context);
+
+typedef enum
+{
+    APP_TIMER_MODE_SINGLE_SHOT,
+    APP_TIMER_MODE_REPEATED
+} app_timer_mode_t;
+
+typedef struct app_timer_s
+{
+    struct app_timer_s        * p_next;
+    app_timer_timeout_handler_t p_timeout_handler;
+    void                      * p_context;
+    app_timer_mode_t            mode;
+    bool                        active;
+    uint64_t                    end_ticks;
+    uint32_t                    repeat_period;
+} app_timer_t;
+
+typedef app_timer_t * app_timer_id_t;
+
+#define APP_TIMER_DEF(timer_id)                                  \
+    static app_timer_t CONCAT_2(timer_id,_data) = { 0 };         \
+    static const app_timer_id_t timer_id = &CONCAT_2(timer_id,_data)
+
+ret_code_t app_timer_init(void);
+
+ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                            app_timer_mode_t            mode,
+                            app_timer_timeout_handler_t timeout_handler);
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks,
+                           void * p_context);
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id);
+
+ret_code_t app_timer_stop_all(void);
+
+uint32_t app_timer_cnt_get(void);
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_TIMER_H__
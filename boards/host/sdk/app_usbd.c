@@ -0,0 +1,343 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file app_usbd.c
+ * @brief Host stand-in of the nRF5 SDK USB device library and HID generic
+ *        class, with the USB host side used by the test driver.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf.h"
+#include "app_util_platform.h"
+#include "nrf_queue.h"
+#include "app_usbd.h"
+#include "app_usbd_hid_generic.h"
+#include "nrf_host.h"
+
+
+/**
+ * @brief Maximum number of class instances.
+ */
+#define APP_USBD_HOST_CLASS_COUNT   4
+
+/**
+ * @brief Depth of the event queue.
+ */
+#define APP_USBD_HOST_EVENT_QUEUE_SIZE  32
+
+
+NRF_QUEUE_DEF(app_usbd_internal_evt_t, m_event_queue,
+              APP_USBD_HOST_EVENT_QUEUE_SIZE, NRF_QUEUE_MODE_NO_OVERFLOW);
+
+static app_usbd_config_t const * m_p_config;
+
+static app_usbd_class_inst_t const * m_classes[APP_USBD_HOST_CLASS_COUNT];
+
+static size_t m_class_count;
+
+static bool m_enabled;
+
+static bool m_started;
+
+
+static ret_code_t event_queue_put(app_usbd_internal_evt_t const * p_event)
+{
+    ret_code_t ret = nrf_queue_push(&m_event_queue, p_event);
+
+    if(m_p_config != NULL && m_p_config->ev_isr_handler != NULL)
+    {
+        m_p_config->ev_isr_handler(p_event, ret == NRF_SUCCESS);
+    }
+
+    return (ret == NRF_SUCCESS) ? NRF_SUCCESS : NRF_ERROR_BUSY;
+}
+
+
+static void state_event_put(app_usbd_event_type_t type)
+{
+    app_usbd_internal_evt_t event = { .type = type };
+
+    UNUSED_RETURN_VALUE(event_queue_put(&event));
+}
+
+
+ret_code_t app_usbd_init(app_usbd_config_t const * p_config)
+{
+    m_p_config = p_config;
+    m_class_count = 0;
+    m_enabled = false;
+    m_started = false;
+    nrf_queue_reset(&m_event_queue);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_usbd_class_append(app_usbd_class_inst_t const * p_cinst)
+{
+    if(m_class_count >= APP_USBD_HOST_CLASS_COUNT)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    m_classes[m_class_count++] = p_cinst;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_usbd_power_events_enable(void)
+{
+    /* The cable is always plugged in */
+    state_event_put(APP_USBD_EVT_POWER_DETECTED);
+    state_event_put(APP_USBD_EVT_POWER_READY);
+
+    return NRF_SUCCESS;
+}
+
+
+void app_usbd_enable(void)
+{
+    m_enabled = true;
+}
+
+
+void app_usbd_disable(void)
+{
+    m_enabled = false;
+}
+
+
+void app_usbd_start(void)
+{
+    m_started = true;
+    state_event_put(APP_USBD_EVT_STARTED);
+}
+
+
+void app_usbd_stop(void)
+{
+    m_started = false;
+    state_event_put(APP_USBD_EVT_STOPPED);
+}
+
+
+bool app_usbd_suspend_req(void)
+{
+    return true;
+}
+
+
+bool app_usbd_event_queue_process(void)
+{
+    app_usbd_internal_evt_t event;
+
+    if(nrf_queue_pop(&m_event_queue, &event) != NRF_SUCCESS)
+    {
+        return false;
+    }
+
+    for(size_t i = 0; i < m_class_count; i++)
+    {
+        m_classes[i]->event_handler(m_classes[i], &event);
+    }
+
+    if(event.type != APP_USBD_EVT_DRV_EPTRANSFER && m_p_config != NULL &&
+       m_p_config->ev_state_proc != NULL)
+    {
+        m_p_config->ev_state_proc(event.type);
+    }
+
+    return true;
+}
+
+
+bool nrf_drv_usbd_is_enabled(void)
+{
+    return m_enabled;
+}
+
+
+bool nrf_drv_usbd_is_started(void)
+{
+    return m_started;
+}
+
+
+void app_usbd_hid_generic_host_event_handler(app_usbd_class_inst_t const * p_inst,
+                                             app_usbd_internal_evt_t const * p_event)
+{
+    app_usbd_hid_generic_t const * p_generic = app_usbd_hid_generic_class_get(p_inst);
+    app_usbd_hid_generic_ctx_t * p_ctx = p_generic->p_ctx;
+
+    switch(p_event->type)
+    {
+        case APP_USBD_EVT_DRV_EPTRANSFER:
+            if(p_event->ep & 0x80)
+            {
+                p_generic->user_ev_handler(p_inst,
+                                           APP_USBD_HID_USER_EVT_IN_REPORT_DONE);
+            }
+            else
+            {
+                memcpy(p_ctx->out_report, p_event->data, p_event->size);
+                p_ctx->out_size = p_event->size;
+                p_generic->user_ev_handler(p_inst,
+                                           APP_USBD_HID_USER_EVT_OUT_REPORT_READY);
+            }
+            break;
+
+        case APP_USBD_EVT_DRV_RESET:
+        case APP_USBD_EVT_DRV_SUSPEND:
+        case APP_USBD_EVT_STOPPED:
+            p_ctx->in_busy = false;
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+ret_code_t app_usbd_hid_generic_in_report_set(app_usbd_hid_generic_t const * p_generic,
+                                              const void * p_buff,
+                                              size_t size)
+{
+    app_usbd_hid_generic_ctx_t * p_ctx = p_generic->p_ctx;
+
+    if(!m_started)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if(size > sizeof(p_ctx->in_report))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    if(p_ctx->in_busy)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    memcpy(p_ctx->in_report, p_buff, size);
+    p_ctx->in_size = size;
+    p_ctx->in_busy = true;
+
+    return NRF_SUCCESS;
+}
+
+
+const void * app_usbd_hid_generic_out_report_get(app_usbd_hid_generic_t const * p_generic,
+                                                 size_t * p_size)
+{
+    *p_size = p_generic->p_ctx->out_size;
+
+    return p_generic->p_ctx->out_report;
+}
+
+
+ret_code_t app_usbd_hid_generic_idle_report_set(app_usbd_hid_generic_t const * p_generic,
+                                                const void * p_buff,
+                                                size_t size)
+{
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t hid_generic_idle_handler_set(app_usbd_class_inst_t const * p_inst,
+                                        app_usbd_hid_idle_handler_t handler)
+{
+    app_usbd_hid_generic_class_get(p_inst)->p_ctx->idle_handler = handler;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t hid_generic_clear_buffer(app_usbd_class_inst_t const * p_inst)
+{
+    app_usbd_hid_generic_class_get(p_inst)->p_ctx->out_size = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t host_usbd_out_report(uint8_t const * p_report, size_t size)
+{
+    app_usbd_internal_evt_t event = {
+        .type = APP_USBD_EVT_DRV_EPTRANSFER,
+        .ep   = NRF_DRV_USBD_EPOUT1,
+        .size = MIN(size, sizeof(event.data)),
+    };
+
+    if(!m_started)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    memcpy(event.data, p_report, event.size);
+
+    return event_queue_put(&event);
+}
+
+
+bool host_usbd_in_report_get(uint8_t * p_report)
+{
+    app_usbd_internal_evt_t event = {
+        .type = APP_USBD_EVT_DRV_EPTRANSFER,
+        .ep   = NRF_DRV_USBD_EPIN1,
+    };
+
+    for(size_t i = 0; i < m_class_count; i++)
+    {
+        app_usbd_hid_generic_ctx_t * p_ctx =
+            app_usbd_hid_generic_class_get(m_classes[i])->p_ctx;
+
+        if(p_ctx->in_busy)
+        {
+            memcpy(p_report, p_ctx->in_report, p_ctx->in_size);
+            p_ctx->in_busy = false;
+            UNUSED_RETURN_VALUE(event_queue_put(&event));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void host_usbd_suspend(bool suspend)
+{
+    state_event_put(suspend ? APP_USBD_EVT_DRV_SUSPEND : APP_USBD_EVT_DRV_RESUME);
+}
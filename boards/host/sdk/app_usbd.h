@@ -0,0 +1,129 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file app_usbd.h
+ * @brief Host stand-in of the nRF5 SDK USB device library.
+ *
+ * There is no bus: the test driver plays the USB host through nrf_host.h.
+ * Its transfers and the bus state changes become events, queued and
+ * signalled to the ISR handler of the configuration like on the target, and
+ * handed to the classes and the state handler by
+ * app_usbd_event_queue_process().
+ */
+
+#ifndef APP_USBD_H__
+#define APP_USBD_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+#include "nrf_drv_usbd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    APP_USBD_EVT_DRV_SOF,
+    APP_USBD_EVT_DRV_RESET,
+    APP_USBD_EVT_DRV_SUSPEND,
+    APP_USBD_EVT_DRV_RESUME,
+    APP_USBD_EVT_DRV_WUREQ,
+    APP_USBD_EVT_DRV_SETUP,
+    APP_USBD_EVT_DRV_EPTRANSFER,
+    APP_USBD_EVT_INST_APPEND,
+    APP_USBD_EVT_INST_REMOVE,
+    APP_USBD_EVT_STARTED,
+    APP_USBD_EVT_STOPPED,
+    APP_USBD_EVT_POWER_DETECTED,
+    APP_USBD_EVT_POWER_REMOVED,
+    APP_USBD_EVT_POWER_READY,
+} app_usbd_event_type_t;
+
+/**
+ * @brief Internal event, the payload of EP transfers included.
+ */
+typedef struct
+{
+    app_usbd_event_type_t type;
+    nrf_drv_usbd_ep_t     ep;           //!< Endpoint of a transfer.
+    size_t                size;         //!< Size of an OUT transfer.
+    uint8_t               data[64];     //!< Data of an OUT transfer.
+} app_usbd_internal_evt_t;
+
+typedef void (*app_usbd_ev_isr_handler_t)(app_usbd_internal_evt_t const * const p_event,
+                                          bool queued);
+
+typedef void (*app_usbd_ev_state_proc_t)(app_usbd_event_type_t event);
+
+typedef struct
+{
+    app_usbd_ev_isr_handler_t ev_isr_handler;
+    app_usbd_ev_state_proc_t  ev_state_proc;
+} app_usbd_config_t;
+
+typedef struct app_usbd_class_inst_s app_usbd_class_inst_t;
+
+/**
+ * @brief Class instance, the events of all the endpoints go to every class.
+ */
+struct app_usbd_class_inst_s
+{
+    void (*event_handler)(app_usbd_class_inst_t const * p_inst,
+                          app_usbd_internal_evt_t const * p_event);
+};
+
+ret_code_t app_usbd_init(app_usbd_config_t const * p_config);
+
+ret_code_t app_usbd_class_append(app_usbd_class_inst_t const * p_cinst);
+
+ret_code_t app_usbd_power_events_enable(void);
+
+void app_usbd_enable(void);
+
+void app_usbd_disable(void);
+
+void app_usbd_start(void);
+
+void app_usbd_stop(void);
+
+bool app_usbd_suspend_req(void);
+
+bool app_usbd_event_queue_process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_USBD_H__
@@ -0,0 +1,172 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file app_usbd_hid_generic.h
+ * @brief Host stand-in of the nRF5 SDK HID generic class.
+ *
+ * One IN and one OUT report in flight, like the U2F interface uses it.
+ */
+
+#ifndef APP_USBD_HID_GENERIC_H__
+#define APP_USBD_HID_GENERIC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+#include "app_util.h"
+#include "app_usbd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    APP_USBD_HID_USER_EVT_SET_BOOT_PROTO,
+    APP_USBD_HID_USER_EVT_SET_REPORT_PROTO,
+    APP_USBD_HID_USER_EVT_OUT_REPORT_READY,
+    APP_USBD_HID_USER_EVT_IN_REPORT_DONE,
+} app_usbd_hid_user_event_t;
+
+typedef enum
+{
+    APP_USBD_HID_SUBCLASS_NONE = 0x00,
+    APP_USBD_HID_SUBCLASS_BOOT = 0x01,
+} app_usbd_hid_subclass_t;
+
+typedef enum
+{
+    APP_USBD_HID_PROTO_GENERIC  = 0x00,
+    APP_USBD_HID_PROTO_KEYBOARD = 0x01,
+    APP_USBD_HID_PROTO_MOUSE    = 0x02,
+} app_usbd_hid_protocol_t;
+
+typedef void (*app_usbd_hid_user_ev_handler_t)(app_usbd_class_inst_t const * p_inst,
+                                               app_usbd_hid_user_event_t event);
+
+typedef ret_code_t (*app_usbd_hid_idle_handler_t)(app_usbd_class_inst_t const * p_inst,
+                                                  uint8_t report_id);
+
+typedef struct
+{
+    size_t          size;
+    uint8_t const * p_data;
+} app_usbd_hid_subclass_desc_t;
+
+/**
+ * @brief Mutable part of the instance.
+ */
+typedef struct
+{
+    app_usbd_hid_idle_handler_t idle_handler;
+    bool     in_busy;                           //!< IN report not read yet.
+    size_t   in_size;
+    uint8_t  in_report[64];
+    size_t   out_size;
+    uint8_t  out_report[64];
+} app_usbd_hid_generic_ctx_t;
+
+typedef struct
+{
+    app_usbd_class_inst_t                 base;
+    app_usbd_hid_generic_ctx_t          * p_ctx;
+    app_usbd_hid_user_ev_handler_t        user_ev_handler;
+    app_usbd_hid_subclass_desc_t const ** pp_subclass_desc;
+    size_t                                subclass_desc_count;
+    uint8_t                               interface;
+} app_usbd_hid_generic_t;
+
+void app_usbd_hid_generic_host_event_handler(app_usbd_class_inst_t const * p_inst,
+                                             app_usbd_internal_evt_t const * p_event);
+
+#define APP_USBD_HID_GENERIC_SUBCLASS_REPORT_DESC(name, ...)            \
+    static uint8_t const CONCAT_2(name, _data)[] = __VA_ARGS__;         \
+    static const app_usbd_hid_subclass_desc_t name =                    \
+    {                                                                   \
+        sizeof(CONCAT_2(name, _data)),                                  \
+        CONCAT_2(name, _data)                                           \
+    }
+
+#define APP_USBD_HID_GENERIC_GLOBAL_DEF(instance_name,                  \
+                                        interface_number,               \
+                                        user_ev_handler_,                \
+                                        endpoint_list,                  \
+                                        subclass_descriptors,           \
+                                        report_in_queue_size,           \
+                                        report_out_maxsize,             \
+                                        subclass_boot,                  \
+                                        protocol)                       \
+    static app_usbd_hid_generic_ctx_t CONCAT_2(instance_name, _ctx);    \
+    static const app_usbd_hid_generic_t instance_name =                 \
+    {                                                                   \
+        .base = { .event_handler = app_usbd_hid_generic_host_event_handler }, \
+        .p_ctx = &CONCAT_2(instance_name, _ctx),                        \
+        .user_ev_handler = user_ev_handler_,                             \
+        .pp_subclass_desc = subclass_descriptors,                       \
+        .subclass_desc_count = ARRAY_SIZE(subclass_descriptors),        \
+        .interface = interface_number,                                  \
+    }
+
+static inline app_usbd_class_inst_t const *
+app_usbd_hid_generic_class_inst_get(app_usbd_hid_generic_t const * p_generic)
+{
+    return &p_generic->base;
+}
+
+static inline app_usbd_hid_generic_t const *
+app_usbd_hid_generic_class_get(app_usbd_class_inst_t const * p_inst)
+{
+    return CONTAINER_OF(p_inst, app_usbd_hid_generic_t const, base);
+}
+
+ret_code_t app_usbd_hid_generic_in_report_set(app_usbd_hid_generic_t const * p_generic,
+                                              const void * p_buff,
+                                              size_t size);
+
+const void * app_usbd_hid_generic_out_report_get(app_usbd_hid_generic_t const * p_generic,
+                                                 size_t * p_size);
+
+ret_code_t app_usbd_hid_generic_idle_report_set(app_usbd_hid_generic_t const * p_generic,
+                                                const void * p_buff,
+                                                size_t size);
+
+ret_code_t hid_generic_idle_handler_set(app_usbd_class_inst_t const * p_inst,
+                                        app_usbd_hid_idle_handler_t handler);
+
+ret_code_t hid_generic_clear_buffer(app_usbd_class_inst_t const * p_inst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_USBD_HID_GENERIC_H__
@@ -0,0 +1,153 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file app_util.h
+ * @brief Host stand-in of the nRF5 SDK utility macros.
+ */
+
+#ifndef APP_UTIL_H__
+#define APP_UTIL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "nrf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STRINGIFY_(val)         #val
+#define STRINGIFY(val)          STRINGIFY_(val)
+
+#define CONCAT_2_(p1, p2)       p1##p2
+#define CONCAT_2(p1, p2)        CONCAT_2_(p1, p2)
+#define CONCAT_3_(p1, p2, p3)   p1##p2##p3
+#define CONCAT_3(p1, p2, p3)    CONCAT_3_(p1, p2, p3)
+
+#define STATIC_ASSERT(EXPR, ...) _Static_assert(EXPR, "" __VA_ARGS__)
+
+#ifndef MIN
+#define MIN(a, b)               ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b)               ((a) < (b) ? (b) : (a))
+#endif
+
+#define CEIL_DIV(A, B)          (((A) + (B) - 1) / (B))
+#define ROUNDED_DIV(A, B)       (((A) + ((B) / 2)) / (B))
+#define ALIGN_NUM(alignment, number) \
+    (((number) - 1) + (alignment) - (((number) - 1) % (alignment)))
+
+#define ARRAY_SIZE(arr)         (sizeof(arr) / sizeof((arr)[0]))
+
+#define IS_POWER_OF_TWO(A)      (((A) != 0) && ((((A) - 1) & (A)) == 0))
+
+#define CONTAINER_OF(ptr, type, member) \
+    (type *)((char *)(ptr) - offsetof(type, member))
+
+#define NRF_MODULE_ENABLED(module) \
+        ((defined(module ## _ENABLED) && (module ## _ENABLED)) ? 1 : 0)
+
+#define UNUSED_VARIABLE(X)      ((void)(X))
+#define UNUSED_PARAMETER(X)     UNUSED_VARIABLE(X)
+#define UNUSED_RETURN_VALUE(X)  UNUSED_VARIABLE(X)
+
+#define BIT_0                   0x01
+#define MSB_16(a)               (((a) & 0xFF00) >> 8)
+#define LSB_16(a)               ((a) & 0x00FF)
+
+static inline uint8_t uint16_encode(uint16_t value, uint8_t * p_encoded_data)
+{
+    p_encoded_data[0] = (uint8_t) ((value & 0x00FF) >> 0);
+    p_encoded_data[1] = (uint8_t) ((value & 0xFF00) >> 8);
+    return sizeof(uint16_t);
+}
+
+static inline uint8_t uint16_big_encode(uint16_t value, uint8_t * p_encoded_data)
+{
+    p_encoded_data[0] = (uint8_t) ((value & 0xFF00) >> 8);
+    p_encoded_data[1] = (uint8_t) ((value & 0x00FF) >> 0);
+    return sizeof(uint16_t);
+}
+
+static inline uint8_t uint32_encode(uint32_t value, uint8_t * p_encoded_data)
+{
+    p_encoded_data[0] = (uint8_t) ((value & 0x000000FF) >> 0);
+    p_encoded_data[1] = (uint8_t) ((value & 0x0000FF00) >> 8);
+    p_encoded_data[2] = (uint8_t) ((value & 0x00FF0000) >> 16);
+    p_encoded_data[3] = (uint8_t) ((value & 0xFF000000) >> 24);
+    return sizeof(uint32_t);
+}
+
+static inline uint8_t uint32_big_encode(uint32_t value, uint8_t * p_encoded_data)
+{
+    p_encoded_data[0] = (uint8_t) ((value & 0xFF000000) >> 24);
+    p_encoded_data[1] = (uint8_t) ((value & 0x00FF0000) >> 16);
+    p_encoded_data[2] = (uint8_t) ((value & 0x0000FF00) >> 8);
+    p_encoded_data[3] = (uint8_t) ((value & 0x000000FF) >> 0);
+    return sizeof(uint32_t);
+}
+
+static inline uint16_t uint16_decode(const uint8_t * p_encoded_data)
+{
+    return ((((uint16_t)((uint8_t *)p_encoded_data)[0])) |
+            (((uint16_t)((uint8_t *)p_encoded_data)[1]) << 8 ));
+}
+
+static inline uint16_t uint16_big_decode(const uint8_t * p_encoded_data)
+{
+    return ((((uint16_t)((uint8_t *)p_encoded_data)[0]) << 8 ) |
+            (((uint16_t)((uint8_t *)p_encoded_data)[1])));
+}
+
+static inline uint32_t uint32_decode(const uint8_t * p_encoded_data)
+{
+    return ((((uint32_t)((uint8_t *)p_encoded_data)[0]) << 0)  |
+            (((uint32_t)((uint8_t *)p_encoded_data)[1]) << 8)  |
+            (((uint32_t)((uint8_t *)p_encoded_data)[2]) << 16) |
+            (((uint32_t)((uint8_t *)p_encoded_data)[3]) << 24 ));
+}
+
+static inline uint32_t uint32_big_decode(const uint8_t * p_encoded_data)
+{
+    return ((((uint32_t)((uint8_t *)p_encoded_data)[0]) << 24) |
+            (((uint32_t)((uint8_t *)p_encoded_data)[1]) << 16) |
+            (((uint32_t)((uint8_t *)p_encoded_data)[2]) << 8)  |
+            (((uint32_t)((uint8_t *)p_encoded_data)[3]) << 0) );
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_UTIL_H__
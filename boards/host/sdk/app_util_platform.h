@@ -0,0 +1,88 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file app_util_platform.h
+ * @brief Host stand-in of the nRF5 SDK platform utilities.
+ *
+ * A critical region holds back the emulated interrupts: an interrupt
+ * pended inside runs when the outermost region is left.
+ */
+
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include <stdint.h>
+
+#include "nrf.h"
+#include "app_util.h"
+#include "app_error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define _PRIO_SD_HIGH       0
+#define _PRIO_SD_MID        1
+#define _PRIO_APP_HIGH      2
+#define _PRIO_APP_MID       3
+#define _PRIO_SD_LOW        4
+#define _PRIO_SD_LOWEST     5
+#define _PRIO_APP_LOW       6
+#define _PRIO_APP_LOWEST    7
+#define _PRIO_THREAD        15
+
+#define APP_IRQ_PRIORITY_HIGHEST    _PRIO_SD_HIGH
+#define APP_IRQ_PRIORITY_HIGH       _PRIO_APP_HIGH
+#define APP_IRQ_PRIORITY_MID        _PRIO_APP_MID
+#define APP_IRQ_PRIORITY_LOW        _PRIO_APP_LOW
+#define APP_IRQ_PRIORITY_LOWEST     _PRIO_APP_LOWEST
+#define APP_IRQ_PRIORITY_THREAD     _PRIO_THREAD
+
+void app_util_critical_region_enter(uint8_t * p_nested);
+void app_util_critical_region_exit(uint8_t nested);
+
+#define CRITICAL_REGION_ENTER()                                 \
+    {                                                           \
+        uint8_t __CR_NESTED = 0;                                \
+        app_util_critical_region_enter(&__CR_NESTED);
+
+#define CRITICAL_REGION_EXIT()                                  \
+        app_util_critical_region_exit(__CR_NESTED);             \
+    }
+
+/** Priority of the running context, @ref APP_IRQ_PRIORITY_THREAD in main. */
+uint8_t current_int_priority_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_UTIL_PLATFORM_H__
@@ -0,0 +1,72 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file bsp.c
+ * @brief Host stand-in of the nRF5 SDK board support, LEDs only.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bsp.h"
+
+
+static uint32_t m_leds;
+
+
+void bsp_board_led_on(uint32_t led_idx)
+{
+    m_leds |= (1UL << led_idx);
+}
+
+
+void bsp_board_led_off(uint32_t led_idx)
+{
+    m_leds &= ~(1UL << led_idx);
+}
+
+
+void bsp_board_led_invert(uint32_t led_idx)
+{
+    m_leds ^= (1UL << led_idx);
+}
+
+
+void bsp_board_leds_off(void)
+{
+    m_leds = 0;
+}
+
+
+bool bsp_board_led_state_get(uint32_t led_idx)
+{
+    return (m_leds & (1UL << led_idx)) != 0;
+}
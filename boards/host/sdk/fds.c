@@ -0,0 +1,565 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file fds.c
+ * @brief Host stand-in of the nRF5 SDK Flash Data Storage.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fds.h"
+#include "app_util.h"
+#include "nrf_host.h"
+
+
+/**
+ * @brief Words of flash holding records, one virtual page is kept for
+ *        garbage collection like on the target.
+ */
+#define FDS_HOST_FLASH_WORDS    ((FDS_VIRTUAL_PAGES - 1) * FDS_VIRTUAL_PAGE_SIZE)
+
+/**
+ * @brief Size of a record header, in words.
+ */
+#define FDS_HEADER_SIZE         (sizeof(fds_header_t) / sizeof(uint32_t))
+
+#define FDS_ERASED_WORD         (0xFFFFFFFF)
+
+#define FDS_MAX_USERS           4
+
+
+static uint32_t m_flash[FDS_HOST_FLASH_WORDS];
+
+/** First free word. */
+static uint32_t m_write_offset;
+
+static uint32_t m_latest_record_id;
+
+static uint32_t m_gc_run_count;
+
+static uint32_t m_open_records;
+
+static bool m_initialized;
+
+static fds_cb_t m_users[FDS_MAX_USERS];
+
+static uint32_t m_user_count;
+
+static char const * m_p_image_path;
+
+
+void fds_host_image_set(char const * p_path)
+{
+    m_p_image_path = p_path;
+}
+
+
+static void image_load(void)
+{
+    FILE * p_file;
+
+    memset(m_flash, 0xFF, sizeof(m_flash));
+
+    if(m_p_image_path == NULL) return;
+
+    p_file = fopen(m_p_image_path, "rb");
+    if(p_file == NULL) return;
+
+    if(fread(m_flash, 1, sizeof(m_flash), p_file) != sizeof(m_flash))
+    {
+        /* Not an image of this configuration: start erased */
+        memset(m_flash, 0xFF, sizeof(m_flash));
+    }
+
+    fclose(p_file);
+}
+
+
+static void image_store(void)
+{
+    FILE * p_file;
+
+    if(m_p_image_path == NULL) return;
+
+    p_file = fopen(m_p_image_path, "wb");
+    if(p_file == NULL) return;
+
+    UNUSED_RETURN_VALUE(fwrite(m_flash, 1, sizeof(m_flash), p_file));
+    fclose(p_file);
+}
+
+
+static void event_send(fds_evt_t const * p_evt)
+{
+    image_store();
+
+    for(uint32_t i = 0; i < m_user_count; i++)
+    {
+        m_users[i](p_evt);
+    }
+}
+
+
+static fds_header_t const * header_get(uint32_t offset)
+{
+    return (fds_header_t const *)&m_flash[offset];
+}
+
+
+static bool offset_is_record(uint32_t offset)
+{
+    return (offset + FDS_HEADER_SIZE <= FDS_HOST_FLASH_WORDS) &&
+           (m_flash[offset] != FDS_ERASED_WORD);
+}
+
+
+static uint32_t record_size(uint32_t offset)
+{
+    return FDS_HEADER_SIZE + header_get(offset)->length_words;
+}
+
+
+/**
+ * @brief Find the position of a record, which moves on garbage collection.
+ */
+static bool record_offset_get(fds_record_desc_t * p_desc, uint32_t * p_offset)
+{
+    if(p_desc->gc_run_count == m_gc_run_count && p_desc->p_record != NULL)
+    {
+        *p_offset = (uint32_t)(p_desc->p_record - m_flash);
+        return true;
+    }
+
+    for(uint32_t offset = 0; offset_is_record(offset);
+        offset += record_size(offset))
+    {
+        fds_header_t const * p_header = header_get(offset);
+
+        if(p_header->record_key != FDS_RECORD_KEY_DIRTY &&
+           p_header->record_id == p_desc->record_id)
+        {
+            p_desc->p_record = &m_flash[offset];
+            p_desc->gc_run_count = m_gc_run_count;
+            *p_offset = offset;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+static ret_code_t record_append(fds_record_t const * p_record,
+                                fds_record_desc_t * p_desc)
+{
+    fds_header_t header;
+    uint32_t size = FDS_HEADER_SIZE + p_record->data.length_words;
+
+    if(p_record->key == FDS_RECORD_KEY_DIRTY ||
+       p_record->file_id == FDS_FILE_ID_INVALID)
+    {
+        return FDS_ERR_INVALID_ARG;
+    }
+
+    if(size > FDS_VIRTUAL_PAGE_SIZE)
+    {
+        return FDS_ERR_RECORD_TOO_LARGE;
+    }
+
+    if(m_write_offset + size > FDS_HOST_FLASH_WORDS)
+    {
+        return FDS_ERR_NO_SPACE_IN_FLASH;
+    }
+
+    header.record_key = p_record->key;
+    header.length_words = (uint16_t)p_record->data.length_words;
+    header.file_id = p_record->file_id;
+    header.crc16 = 0xFFFF;
+    header.record_id = ++m_latest_record_id;
+
+    memcpy(&m_flash[m_write_offset], &header, sizeof(header));
+    memcpy(&m_flash[m_write_offset + FDS_HEADER_SIZE], p_record->data.p_data,
+           p_record->data.length_words * sizeof(uint32_t));
+
+    if(p_desc != NULL)
+    {
+        p_desc->record_id = header.record_id;
+        p_desc->p_record = &m_flash[m_write_offset];
+        p_desc->gc_run_count = m_gc_run_count;
+        p_desc->record_is_open = false;
+    }
+
+    m_write_offset += size;
+
+    return FDS_SUCCESS;
+}
+
+
+static void record_dirty_set(uint32_t offset)
+{
+    ((fds_header_t *)&m_flash[offset])->record_key = FDS_RECORD_KEY_DIRTY;
+}
+
+
+ret_code_t fds_register(fds_cb_t cb)
+{
+    if(m_user_count >= FDS_MAX_USERS)
+    {
+        return FDS_ERR_USER_LIMIT_REACHED;
+    }
+
+    m_users[m_user_count++] = cb;
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_init(void)
+{
+    fds_evt_t evt = { .id = FDS_EVT_INIT, .result = FDS_SUCCESS };
+
+    image_load();
+
+    m_write_offset = 0;
+    m_latest_record_id = 0;
+    m_open_records = 0;
+
+    while(offset_is_record(m_write_offset))
+    {
+        m_latest_record_id = MAX(m_latest_record_id,
+                                 header_get(m_write_offset)->record_id);
+        m_write_offset += record_size(m_write_offset);
+    }
+
+    m_initialized = true;
+
+    event_send(&evt);
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_record_write(fds_record_desc_t * p_desc,
+                            fds_record_t const * p_record)
+{
+    fds_record_desc_t desc;
+    ret_code_t ret;
+
+    if(!m_initialized) return FDS_ERR_NOT_INITIALIZED;
+    if(p_record == NULL) return FDS_ERR_NULL_ARG;
+
+    ret = record_append(p_record, &desc);
+    if(ret != FDS_SUCCESS) return ret;
+
+    if(p_desc != NULL)
+    {
+        *p_desc = desc;
+    }
+
+    fds_evt_t evt = {
+        .id = FDS_EVT_WRITE,
+        .result = FDS_SUCCESS,
+        .write = {
+            .record_id = desc.record_id,
+            .file_id = p_record->file_id,
+            .record_key = p_record->key,
+        },
+    };
+    event_send(&evt);
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_record_update(fds_record_desc_t * p_desc,
+                             fds_record_t const * p_record)
+{
+    fds_record_desc_t desc;
+    uint32_t old_offset;
+    ret_code_t ret;
+
+    if(!m_initialized) return FDS_ERR_NOT_INITIALIZED;
+    if(p_desc == NULL || p_record == NULL) return FDS_ERR_NULL_ARG;
+
+    if(!record_offset_get(p_desc, &old_offset))
+    {
+        return FDS_ERR_NOT_FOUND;
+    }
+
+    ret = record_append(p_record, &desc);
+    if(ret != FDS_SUCCESS) return ret;
+
+    record_dirty_set(old_offset);
+    *p_desc = desc;
+
+    fds_evt_t evt = {
+        .id = FDS_EVT_UPDATE,
+        .result = FDS_SUCCESS,
+        .write = {
+            .record_id = desc.record_id,
+            .file_id = p_record->file_id,
+            .record_key = p_record->key,
+            .is_record_updated = true,
+        },
+    };
+    event_send(&evt);
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_record_delete(fds_record_desc_t * p_desc)
+{
+    uint32_t offset;
+
+    if(!m_initialized) return FDS_ERR_NOT_INITIALIZED;
+    if(p_desc == NULL) return FDS_ERR_NULL_ARG;
+
+    if(!record_offset_get(p_desc, &offset))
+    {
+        return FDS_ERR_NOT_FOUND;
+    }
+
+    fds_evt_t evt = {
+        .id = FDS_EVT_DEL_RECORD,
+        .result = FDS_SUCCESS,
+        .del = {
+            .record_id = p_desc->record_id,
+            .file_id = header_get(offset)->file_id,
+            .record_key = header_get(offset)->record_key,
+        },
+    };
+
+    record_dirty_set(offset);
+    event_send(&evt);
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_file_delete(uint16_t file_id)
+{
+    if(!m_initialized) return FDS_ERR_NOT_INITIALIZED;
+
+    for(uint32_t offset = 0; offset_is_record(offset);
+        offset += record_size(offset))
+    {
+        if(header_get(offset)->file_id == file_id)
+        {
+            record_dirty_set(offset);
+        }
+    }
+
+    fds_evt_t evt = {
+        .id = FDS_EVT_DEL_FILE,
+        .result = FDS_SUCCESS,
+        .del = { .file_id = file_id },
+    };
+    event_send(&evt);
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_gc(void)
+{
+    uint32_t read = 0;
+    uint32_t write = 0;
+
+    if(!m_initialized) return FDS_ERR_NOT_INITIALIZED;
+
+    while(offset_is_record(read))
+    {
+        uint32_t size = record_size(read);
+
+        if(header_get(read)->record_key != FDS_RECORD_KEY_DIRTY)
+        {
+            memmove(&m_flash[write], &m_flash[read], size * sizeof(uint32_t));
+            write += size;
+        }
+        read += size;
+    }
+
+    memset(&m_flash[write], 0xFF, (FDS_HOST_FLASH_WORDS - write) * sizeof(uint32_t));
+    m_write_offset = write;
+    m_gc_run_count++;
+
+    fds_evt_t evt = { .id = FDS_EVT_GC, .result = FDS_SUCCESS };
+    event_send(&evt);
+
+    return FDS_SUCCESS;
+}
+
+
+/**
+ * @brief Find the next valid record matching the file and key.
+ *
+ * The token holds the offset of the next record to look at.
+ */
+static ret_code_t record_find(bool match_file, uint16_t file_id,
+                              bool match_key, uint16_t record_key,
+                              fds_record_desc_t * p_desc,
+                              fds_find_token_t * p_token)
+{
+    uint32_t offset;
+
+    if(!m_initialized) return FDS_ERR_NOT_INITIALIZED;
+    if(p_desc == NULL || p_token == NULL) return FDS_ERR_NULL_ARG;
+
+    offset = (p_token->p_addr == NULL) ? 0 :
+             (uint32_t)(p_token->p_addr - m_flash) + record_size(
+                        (uint32_t)(p_token->p_addr - m_flash));
+
+    for(; offset_is_record(offset); offset += record_size(offset))
+    {
+        fds_header_t const * p_header = header_get(offset);
+
+        if(p_header->record_key == FDS_RECORD_KEY_DIRTY) continue;
+        if(match_file && p_header->file_id != file_id) continue;
+        if(match_key && p_header->record_key != record_key) continue;
+
+        p_token->p_addr = &m_flash[offset];
+        p_desc->record_id = p_header->record_id;
+        p_desc->p_record = &m_flash[offset];
+        p_desc->gc_run_count = m_gc_run_count;
+        p_desc->record_is_open = false;
+
+        return FDS_SUCCESS;
+    }
+
+    return FDS_ERR_NOT_FOUND;
+}
+
+
+ret_code_t fds_record_iterate(fds_record_desc_t * p_desc,
+                              fds_find_token_t * p_token)
+{
+    return record_find(false, 0, false, 0, p_desc, p_token);
+}
+
+
+ret_code_t fds_record_find(uint16_t file_id, uint16_t record_key,
+                           fds_record_desc_t * p_desc,
+                           fds_find_token_t * p_token)
+{
+    return record_find(true, file_id, true, record_key, p_desc, p_token);
+}
+
+
+ret_code_t fds_record_find_by_key(uint16_t record_key,
+                                  fds_record_desc_t * p_desc,
+                                  fds_find_token_t * p_token)
+{
+    return record_find(false, 0, true, record_key, p_desc, p_token);
+}
+
+
+ret_code_t fds_record_find_in_file(uint16_t file_id,
+                                   fds_record_desc_t * p_desc,
+                                   fds_find_token_t * p_token)
+{
+    return record_find(true, file_id, false, 0, p_desc, p_token);
+}
+
+
+ret_code_t fds_record_open(fds_record_desc_t * p_desc,
+                           fds_flash_record_t * p_flash_record)
+{
+    uint32_t offset;
+
+    if(p_desc == NULL || p_flash_record == NULL) return FDS_ERR_NULL_ARG;
+
+    if(!record_offset_get(p_desc, &offset))
+    {
+        return FDS_ERR_NOT_FOUND;
+    }
+
+    p_flash_record->p_header = header_get(offset);
+    p_flash_record->p_data = &m_flash[offset + FDS_HEADER_SIZE];
+
+    if(!p_desc->record_is_open)
+    {
+        p_desc->record_is_open = true;
+        m_open_records++;
+    }
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_record_close(fds_record_desc_t * p_desc)
+{
+    if(p_desc == NULL) return FDS_ERR_NULL_ARG;
+
+    if(!p_desc->record_is_open)
+    {
+        return FDS_ERR_NO_OPEN_RECORDS;
+    }
+
+    p_desc->record_is_open = false;
+    m_open_records--;
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_stat(fds_stat_t * p_stat)
+{
+    if(!m_initialized) return FDS_ERR_NOT_INITIALIZED;
+    if(p_stat == NULL) return FDS_ERR_NULL_ARG;
+
+    memset(p_stat, 0, sizeof(fds_stat_t));
+
+    for(uint32_t offset = 0; offset_is_record(offset);
+        offset += record_size(offset))
+    {
+        if(header_get(offset)->record_key == FDS_RECORD_KEY_DIRTY)
+        {
+            p_stat->dirty_records++;
+            p_stat->freeable_words += (uint16_t)record_size(offset);
+        }
+        else
+        {
+            p_stat->valid_records++;
+        }
+    }
+
+    p_stat->pages_available = FDS_VIRTUAL_PAGES - 1;
+    p_stat->open_records = (uint16_t)m_open_records;
+    p_stat->words_used = (uint16_t)m_write_offset;
+    p_stat->largest_contig = (uint16_t)MIN(FDS_HOST_FLASH_WORDS - m_write_offset,
+                                           FDS_VIRTUAL_PAGE_SIZE);
+
+    return FDS_SUCCESS;
+}
@@ -0,0 +1,209 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file fds.h
+ * @brief Host stand-in of the nRF5 SDK Flash Data Storage.
+ *
+ * The flash is a word array, optionally backed by an image file, see
+ * fds_host_image_set(). Records are appended with the header layout of the
+ * SDK, updates and deletions leave dirty records until fds_gc(). As with
+ * the NVMC backend of the target, operations complete and their event is
+ * sent before the call returns.
+ */
+
+#ifndef FDS_H__
+#define FDS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sdk_config.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FDS_FILE_ID_INVALID     (0xFFFF)
+#define FDS_RECORD_KEY_DIRTY    (0x0000)
+
+#define NRF_ERROR_FDS_ERR_BASE  (0x8600)
+
+enum
+{
+    FDS_SUCCESS = NRF_SUCCESS,
+    FDS_ERR_OPERATION_TIMEOUT = NRF_ERROR_FDS_ERR_BASE,
+    FDS_ERR_NOT_INITIALIZED,
+    FDS_ERR_UNALIGNED_ADDR,
+    FDS_ERR_INVALID_ARG,
+    FDS_ERR_NULL_ARG,
+    FDS_ERR_NO_OPEN_RECORDS,
+    FDS_ERR_NO_SPACE_IN_FLASH,
+    FDS_ERR_NO_SPACE_IN_QUEUES,
+    FDS_ERR_RECORD_TOO_LARGE,
+    FDS_ERR_NOT_FOUND,
+    FDS_ERR_NO_PAGES,
+    FDS_ERR_USER_LIMIT_REACHED,
+    FDS_ERR_CRC_CHECK_FAILED,
+    FDS_ERR_BUSY,
+    FDS_ERR_INTERNAL,
+};
+
+typedef struct
+{
+    uint16_t record_key;
+    uint16_t length_words;
+    uint16_t file_id;
+    uint16_t crc16;
+    uint32_t record_id;
+} fds_header_t;
+
+typedef struct
+{
+    uint32_t         record_id;
+    uint32_t const * p_record;
+    uint32_t         gc_run_count;
+    bool             record_is_open;
+} fds_record_desc_t;
+
+typedef struct
+{
+    fds_header_t const * p_header;
+    void         const * p_data;
+} fds_flash_record_t;
+
+typedef struct
+{
+    uint16_t file_id;
+    uint16_t key;
+    struct
+    {
+        void     const * p_data;
+        uint32_t         length_words;
+    } data;
+} fds_record_t;
+
+typedef struct
+{
+    uint32_t const * p_addr;
+    uint16_t         page;
+} fds_find_token_t;
+
+typedef enum
+{
+    FDS_EVT_INIT,
+    FDS_EVT_WRITE,
+    FDS_EVT_UPDATE,
+    FDS_EVT_DEL_RECORD,
+    FDS_EVT_DEL_FILE,
+    FDS_EVT_GC
+} fds_evt_id_t;
+
+typedef struct
+{
+    fds_evt_id_t id;
+    ret_code_t   result;
+    union
+    {
+        struct
+        {
+            uint32_t record_id;
+            uint16_t file_id;
+            uint16_t record_key;
+            bool     is_record_updated;
+        } write;
+        struct
+        {
+            uint32_t record_id;
+            uint16_t file_id;
+            uint16_t record_key;
+        } del;
+    };
+} fds_evt_t;
+
+typedef struct
+{
+    uint16_t pages_available;
+    uint16_t open_records;
+    uint16_t valid_records;
+    uint16_t dirty_records;
+    uint16_t words_reserved;
+    uint16_t words_used;
+    uint16_t largest_contig;
+    uint16_t freeable_words;
+    bool     corruption;
+} fds_stat_t;
+
+typedef void (*fds_cb_t)(fds_evt_t const * p_evt);
+
+ret_code_t fds_register(fds_cb_t cb);
+
+ret_code_t fds_init(void);
+
+ret_code_t fds_record_write(fds_record_desc_t * p_desc,
+                            fds_record_t const * p_record);
+
+ret_code_t fds_record_update(fds_record_desc_t * p_desc,
+                             fds_record_t const * p_record);
+
+ret_code_t fds_record_delete(fds_record_desc_t * p_desc);
+
+ret_code_t fds_file_delete(uint16_t file_id);
+
+ret_code_t fds_gc(void);
+
+ret_code_t fds_record_iterate(fds_record_desc_t * p_desc,
+                              fds_find_token_t * p_token);
+
+ret_code_t fds_record_find(uint16_t file_id, uint16_t record_key,
+                           fds_record_desc_t * p_desc,
+                           fds_find_token_t * p_token);
+
+ret_code_t fds_record_find_by_key(uint16_t record_key,
+                                  fds_record_desc_t * p_desc,
+                                  fds_find_token_t * p_token);
+
+ret_code_t fds_record_find_in_file(uint16_t file_id,
+                                   fds_record_desc_t * p_desc,
+                                   fds_find_token_t * p_token);
+
+ret_code_t fds_record_open(fds_record_desc_t * p_desc,
+                           fds_flash_record_t * p_flash_record);
+
+ret_code_t fds_record_close(fds_record_desc_t * p_desc);
+
+ret_code_t fds_stat(fds_stat_t * p_stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FDS_H__
@@ -0,0 +1,155 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf.h
+ * @brief Host stand-in of the nRF52840 device header.
+ *
+ * The NVIC is emulated by nrf_nvic.c: pending an enabled interrupt of a
+ * higher priority than the running context calls its handler right away,
+ * like a preemption on the target. The DWT cycle counter follows the host
+ * monotonic clock, scaled to SystemCoreClock.
+ */
+
+#ifndef NRF_H__
+#define NRF_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef NRF52840_XXAA
+#define NRF52840_XXAA
+#endif
+
+#define __STATIC_INLINE     static inline
+#define __INLINE            inline
+#define __WEAK              __attribute__((weak))
+#define __ALIGN(n)          __attribute__((aligned(n)))
+
+typedef enum
+{
+    RNG_IRQn            = 13,
+    RTC1_IRQn           = 17,
+    SWI0_EGU0_IRQn      = 20,
+    SWI1_EGU1_IRQn      = 21,
+    SWI2_EGU2_IRQn      = 22,
+    SWI3_EGU3_IRQn      = 23,
+    SWI4_EGU4_IRQn      = 24,
+    SWI5_EGU5_IRQn      = 25,
+    RTC2_IRQn           = 36,
+    USBD_IRQn           = 39,
+    CRYPTOCELL_IRQn     = 42,
+} IRQn_Type;
+
+/** Number of interrupt lines of the emulated NVIC. */
+#define HOST_NVIC_IRQ_COUNT     48
+
+void NVIC_SetPriority(IRQn_Type irqn, uint32_t priority);
+uint32_t NVIC_GetPriority(IRQn_Type irqn);
+void NVIC_EnableIRQ(IRQn_Type irqn);
+void NVIC_DisableIRQ(IRQn_Type irqn);
+void NVIC_SetPendingIRQ(IRQn_Type irqn);
+void NVIC_ClearPendingIRQ(IRQn_Type irqn);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type irqn);
+
+extern uint32_t SystemCoreClock;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+
+/** Refresh the emulated cycle counter and return the DWT registers. */
+DWT_Type * host_dwt_get(void);
+
+extern CoreDebug_Type host_core_debug;
+
+#define DWT         (host_dwt_get())
+#define CoreDebug   (&host_core_debug)
+
+/** Main stack pointer, within the emulated stack, see nrf_nvic.c. */
+uint32_t host_msp_get(void);
+
+__STATIC_INLINE uint32_t __get_MSP(void)
+{
+    return host_msp_get();
+}
+
+__STATIC_INLINE uint32_t __CLZ(uint32_t value)
+{
+    return (value == 0) ? 32 : (uint32_t)__builtin_clz(value);
+}
+
+__STATIC_INLINE void __DMB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+__STATIC_INLINE void __DSB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+__STATIC_INLINE void __ISB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+__STATIC_INLINE void __SEV(void)
+{
+}
+
+/** Wait for event: runs the expired app_timer timers. */
+void host_wfe(void);
+
+__STATIC_INLINE void __WFE(void)
+{
+    host_wfe();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_H__
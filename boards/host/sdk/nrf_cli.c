@@ -0,0 +1,197 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_cli.c
+ * @brief Host stand-in of the nRF5 SDK command line interface.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "nrf_cli.h"
+#include "nrf_host.h"
+
+
+/**
+ * @brief Maximum number of arguments of a command line.
+ */
+#define NRF_CLI_HOST_ARGC_MAX   12
+
+/**
+ * @brief Maximum length of a command line.
+ */
+#define NRF_CLI_HOST_LINE_MAX   128
+
+
+static nrf_cli_host_cmd_t * m_p_cmds;
+
+
+void nrf_cli_host_register(nrf_cli_host_cmd_t * p_cmd)
+{
+    p_cmd->p_next = m_p_cmds;
+    m_p_cmds = p_cmd;
+}
+
+
+void nrf_cli_fprintf(nrf_cli_t const * p_cli, uint8_t color,
+                     char const * p_fmt, ...)
+{
+    va_list args;
+
+    va_start(args, p_fmt);
+    vfprintf(p_cli->p_file, p_fmt, args);
+    va_end(args);
+}
+
+
+bool nrf_cli_help_requested(nrf_cli_t const * p_cli)
+{
+    return p_cli->help_requested;
+}
+
+
+void nrf_cli_help_print(nrf_cli_t const * p_cli,
+                        nrf_cli_getopt_option_t const * p_opt,
+                        size_t opt_len)
+{
+    nrf_cli_static_entry_t const * p_entry = p_cli->p_active;
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%s - %s\n",
+                    p_entry->p_syntax, p_entry->p_help);
+
+    for(size_t i = 0; i < opt_len; i++)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  %s, %s: %s\n",
+                        p_opt[i].p_optname_short, p_opt[i].p_optname,
+                        p_opt[i].p_help);
+    }
+
+    if(p_entry->p_subcmd == NULL)
+    {
+        return;
+    }
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Subcommands:\n");
+    for(nrf_cli_static_entry_t const * p_sub = p_entry->p_subcmd->u.p_static;
+        p_sub->p_syntax != NULL; p_sub++)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  %-10s: %s\n",
+                        p_sub->p_syntax, p_sub->p_help);
+    }
+}
+
+
+static nrf_cli_static_entry_t const * subcmd_find(nrf_cli_static_entry_t const * p_entry,
+                                                  char const * p_syntax)
+{
+    if(p_entry->p_subcmd == NULL)
+    {
+        return NULL;
+    }
+
+    for(nrf_cli_static_entry_t const * p_sub = p_entry->p_subcmd->u.p_static;
+        p_sub->p_syntax != NULL; p_sub++)
+    {
+        if(strcmp(p_sub->p_syntax, p_syntax) == 0)
+        {
+            return p_sub;
+        }
+    }
+
+    return NULL;
+}
+
+
+ret_code_t nrf_cli_host_exec(FILE * p_file, char const * p_line)
+{
+    char line[NRF_CLI_HOST_LINE_MAX];
+    char * argv[NRF_CLI_HOST_ARGC_MAX];
+    size_t argc = 0;
+    nrf_cli_t cli = { .p_file = p_file };
+
+    strncpy(line, p_line, sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+
+    for(char * p_tok = strtok(line, " \t\r\n");
+        p_tok != NULL && argc < NRF_CLI_HOST_ARGC_MAX;
+        p_tok = strtok(NULL, " \t\r\n"))
+    {
+        if(strcmp(p_tok, "-h") == 0 || strcmp(p_tok, "--help") == 0)
+        {
+            cli.help_requested = true;
+        }
+        else
+        {
+            argv[argc++] = p_tok;
+        }
+    }
+
+    if(argc == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    for(nrf_cli_host_cmd_t * p_cmd = m_p_cmds; p_cmd != NULL;
+        p_cmd = p_cmd->p_next)
+    {
+        if(strcmp(p_cmd->p_entry->p_syntax, argv[0]) != 0)
+        {
+            continue;
+        }
+
+        size_t level = 0;
+        nrf_cli_static_entry_t const * p_sub;
+
+        cli.p_active = p_cmd->p_entry;
+        while(level + 1 < argc &&
+              (p_sub = subcmd_find(cli.p_active, argv[level + 1])) != NULL)
+        {
+            cli.p_active = p_sub;
+            level++;
+        }
+
+        if(cli.p_active->handler != NULL)
+        {
+            cli.p_active->handler(&cli, argc - level, &argv[level]);
+        }
+        else
+        {
+            nrf_cli_help_print(&cli, NULL, 0);
+        }
+
+        return NRF_SUCCESS;
+    }
+
+    return NRF_ERROR_NOT_FOUND;
+}
@@ -0,0 +1,167 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_cli.h
+ * @brief Host stand-in of the nRF5 SDK command line interface.
+ *
+ * Commands register the same way as on the target. There is no terminal:
+ * the test driver runs command lines with nrf_cli_host_exec().
+ */
+
+#ifndef NRF_CLI_H__
+#define NRF_CLI_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "sdk_errors.h"
+#include "app_util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NRF_CLI_DEFAULT     0
+#define NRF_CLI_NORMAL      1
+#define NRF_CLI_INFO        2
+#define NRF_CLI_OPTION      3
+#define NRF_CLI_WARNING     4
+#define NRF_CLI_ERROR       5
+
+typedef struct nrf_cli nrf_cli_t;
+typedef struct nrf_cli_static_entry nrf_cli_static_entry_t;
+
+typedef void (*nrf_cli_cmd_handler)(nrf_cli_t const * p_cli,
+                                    size_t            argc,
+                                    char            **argv);
+
+typedef struct
+{
+    bool is_dynamic;
+    union
+    {
+        nrf_cli_static_entry_t const * p_static;
+    } u;
+} nrf_cli_cmd_entry_t;
+
+struct nrf_cli_static_entry
+{
+    char const                * p_syntax;
+    char const                * p_help;
+    nrf_cli_cmd_entry_t const * p_subcmd;
+    nrf_cli_cmd_handler         handler;
+};
+
+/**
+ * @brief Host CLI instance, the state of the command being run.
+ */
+struct nrf_cli
+{
+    FILE                         * p_file;
+    nrf_cli_static_entry_t const * p_active;
+    bool                           help_requested;
+};
+
+typedef struct
+{
+    char const * p_optname;
+    char const * p_optname_short;
+    char const * p_help;
+} nrf_cli_getopt_option_t;
+
+/**
+ * @brief Registered root command.
+ */
+typedef struct nrf_cli_host_cmd
+{
+    nrf_cli_static_entry_t const * p_entry;
+    struct nrf_cli_host_cmd      * p_next;
+} nrf_cli_host_cmd_t;
+
+void nrf_cli_host_register(nrf_cli_host_cmd_t * p_cmd);
+
+#define NRF_CLI_CMD(_syntax, _subcmd, _help, _handler)  \
+{                                                       \
+    .p_syntax = (const char *) STRINGIFY(_syntax),      \
+    .p_help  = (const char *) _help,                    \
+    .p_subcmd = _subcmd,                                \
+    .handler = _handler                                 \
+}
+
+#define NRF_CLI_SUBCMD_SET_END { NULL }
+
+#define NRF_CLI_CREATE_STATIC_SUBCMD_SET(name)                      \
+    static nrf_cli_static_entry_t const CONCAT_2(name, _raw)[];     \
+    static nrf_cli_cmd_entry_t const name =                         \
+    {                                                               \
+        .is_dynamic = false,                                        \
+        .u = { .p_static = CONCAT_2(name, _raw) }                   \
+    };                                                              \
+    static nrf_cli_static_entry_t const CONCAT_2(name, _raw)[] =
+
+#define NRF_CLI_CMD_REGISTER(syntax, subcmd, help, handler)                 \
+    static nrf_cli_static_entry_t const CONCAT_3(nrf_cli_, syntax, _raw) =  \
+        NRF_CLI_CMD(syntax, subcmd, help, handler);                         \
+    static nrf_cli_host_cmd_t CONCAT_3(nrf_cli_, syntax, _reg) =            \
+        { .p_entry = &CONCAT_3(nrf_cli_, syntax, _raw) };                   \
+    static void __attribute__((constructor))                                \
+    CONCAT_3(nrf_cli_, syntax, _ctor)(void)                                 \
+    {                                                                       \
+        nrf_cli_host_register(&CONCAT_3(nrf_cli_, syntax, _reg));           \
+    }                                                                       \
+    extern nrf_cli_host_cmd_t * const CONCAT_3(nrf_cli_, syntax, _unused)
+
+void nrf_cli_fprintf(nrf_cli_t const * p_cli, uint8_t color,
+                     char const * p_fmt, ...)
+                     __attribute__((format(printf, 3, 4)));
+
+#define nrf_cli_print(_p_cli, _ft, ...) \
+        nrf_cli_fprintf(_p_cli, NRF_CLI_DEFAULT, _ft "\n", ##__VA_ARGS__)
+#define nrf_cli_info(_p_cli, _ft, ...) \
+        nrf_cli_fprintf(_p_cli, NRF_CLI_INFO, _ft "\n", ##__VA_ARGS__)
+#define nrf_cli_warn(_p_cli, _ft, ...) \
+        nrf_cli_fprintf(_p_cli, NRF_CLI_WARNING, _ft "\n", ##__VA_ARGS__)
+#define nrf_cli_error(_p_cli, _ft, ...) \
+        nrf_cli_fprintf(_p_cli, NRF_CLI_ERROR, _ft "\n", ##__VA_ARGS__)
+
+bool nrf_cli_help_requested(nrf_cli_t const * p_cli);
+
+void nrf_cli_help_print(nrf_cli_t const * p_cli,
+                        nrf_cli_getopt_option_t const * p_opt,
+                        size_t opt_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_CLI_H__
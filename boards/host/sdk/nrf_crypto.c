@@ -0,0 +1,1082 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_crypto.c
+ * @brief Host stand-in of the nRF5 SDK crypto library, over OpenSSL.
+ *
+ * Uses the libcrypto 1.1 low level interfaces, still available in 3.x.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <openssl/aes.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+
+#include "app_util.h"
+#include "cc310_backend_mutex.h"
+#include "cc310_backend_shared.h"
+#include "nrf_crypto.h"
+#include "nrf_host.h"
+
+
+#define CONTEXT_INIT_VALUE      (0x12345678)
+
+const nrf_crypto_hash_info_t g_nrf_crypto_hash_sha256_info =
+{
+    .hash_mode   = NRF_CRYPTO_HASH_MODE_SHA256,
+    .digest_size = NRF_CRYPTO_HASH_SIZE_SHA256,
+};
+
+const nrf_crypto_hmac_info_t g_nrf_crypto_hmac_sha256_info =
+{
+    .type        = NRF_CRYPTO_HMAC_SHA256_TYPE,
+    .digest_size = NRF_CRYPTO_HMAC_SHA256_RESULT_SIZE,
+};
+
+const nrf_crypto_aes_info_t g_nrf_crypto_aes_ecb_128_info =
+{
+    .mode     = NRF_CRYPTO_AES_MODE_ECB,
+    .key_size = 128,
+};
+
+const nrf_crypto_ecc_curve_info_t g_nrf_crypto_ecc_secp256r1_curve_info =
+{
+    .curve_type           = NRF_CRYPTO_ECC_SECP256R1_CURVE_TYPE,
+    .raw_private_key_size = NRF_CRYPTO_ECC_SECP256R1_RAW_PRIVATE_KEY_SIZE,
+    .raw_public_key_size  = NRF_CRYPTO_ECC_SECP256R1_RAW_PUBLIC_KEY_SIZE,
+};
+
+const nrf_crypto_ecc_curve_info_t g_nrf_crypto_ecc_ed25519_curve_info =
+{
+    .curve_type           = NRF_CRYPTO_ECC_ED25519_CURVE_TYPE,
+    .raw_private_key_size = NRF_CRYPTO_ECC_ED25519_RAW_PRIVATE_KEY_SIZE,
+    .raw_public_key_size  = NRF_CRYPTO_ECC_ED25519_RAW_PUBLIC_KEY_SIZE,
+};
+
+STATIC_ASSERT(sizeof(((nrf_crypto_hash_context_t *)0)->state) >= sizeof(SHA256_CTX));
+
+static bool m_initialized;
+
+/** Users holding the CryptoCell on, and when it is ready. */
+static uint32_t m_cc310_users;
+static uint64_t m_cc310_ready_ns;
+
+nrf_mtx_t g_cc310_mutex;
+
+static EC_GROUP * m_p_group;
+
+
+void cc310_backend_enable(void)
+{
+    if(m_cc310_users++ == 0)
+    {
+        m_cc310_ready_ns = host_clock_ns() + HOST_CC310_STARTUP_US * 1000ULL;
+    }
+}
+
+
+void cc310_backend_disable(void)
+{
+    if(m_cc310_users > 0)
+    {
+        m_cc310_users--;
+    }
+}
+
+
+/**
+ * @brief Wait for the CryptoCell to power up, at the start of an operation.
+ *
+ * The clock only moves when told to while it is stopped, so the model is
+ * skipped then.
+ */
+static void cc310_ready_wait(void)
+{
+    uint64_t ready_ns = m_cc310_ready_ns;
+
+    if(host_clock_is_stopped()) return;
+
+    if(m_cc310_users == 0)
+    {
+        ready_ns = host_clock_ns() + HOST_CC310_STARTUP_US * 1000ULL;
+    }
+
+    while(host_clock_ns() < ready_ns)
+    {
+        /* Powering up */
+    }
+}
+
+
+ret_code_t nrf_crypto_init(void)
+{
+    if(m_p_group == NULL)
+    {
+        m_p_group = EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1);
+        if(m_p_group == NULL)
+        {
+            return NRF_ERROR_CRYPTO_INTERNAL;
+        }
+    }
+
+    nrf_mtx_init(&g_cc310_mutex);
+    m_initialized = true;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_uninit(void)
+{
+    m_initialized = false;
+
+    return NRF_SUCCESS;
+}
+
+
+bool nrf_crypto_is_initialized(void)
+{
+    return m_initialized;
+}
+
+
+char const * nrf_crypto_error_string_get(ret_code_t error)
+{
+    switch(error)
+    {
+        case NRF_SUCCESS:                               return "Success";
+        case NRF_ERROR_CRYPTO_NOT_INITIALIZED:          return "Not initialized";
+        case NRF_ERROR_CRYPTO_CONTEXT_NULL:             return "Context NULL";
+        case NRF_ERROR_CRYPTO_CONTEXT_NOT_INITIALIZED:  return "Context not initialized";
+        case NRF_ERROR_CRYPTO_INPUT_NULL:               return "Input NULL";
+        case NRF_ERROR_CRYPTO_INPUT_LENGTH:             return "Input length";
+        case NRF_ERROR_CRYPTO_OUTPUT_NULL:              return "Output NULL";
+        case NRF_ERROR_CRYPTO_OUTPUT_LENGTH:            return "Output length";
+        case NRF_ERROR_CRYPTO_INTERNAL:                 return "Internal error";
+        case NRF_ERROR_CRYPTO_ECDSA_INVALID_SIGNATURE:  return "Invalid signature";
+        default:                                        return "Unknown error";
+    }
+}
+
+
+/** Key of the seeded generator, see @ref nrf_crypto_host_rng_seed. */
+static uint8_t m_rng_key[SHA256_DIGEST_LENGTH];
+
+/** Blocks drawn from the seeded generator. */
+static uint64_t m_rng_counter;
+
+
+/**
+ * @brief Seeded generator: SHA-256 of the key and a block counter.
+ */
+static int host_rand_bytes(unsigned char * p_buf, int num)
+{
+    uint8_t block[SHA256_DIGEST_LENGTH];
+    SHA256_CTX ctx;
+
+    while(num > 0)
+    {
+        int len = MIN(num, (int)sizeof(block));
+
+        SHA256_Init(&ctx);
+        SHA256_Update(&ctx, m_rng_key, sizeof(m_rng_key));
+        SHA256_Update(&ctx, &m_rng_counter, sizeof(m_rng_counter));
+        SHA256_Final(block, &ctx);
+        m_rng_counter++;
+
+        memcpy(p_buf, block, len);
+        p_buf += len;
+        num -= len;
+    }
+
+    return 1;
+}
+
+
+static int host_rand_status(void)
+{
+    return 1;
+}
+
+
+static RAND_METHOD const m_host_rand_method =
+{
+    .bytes      = host_rand_bytes,
+    .pseudorand = host_rand_bytes,
+    .status     = host_rand_status,
+};
+
+
+void nrf_crypto_host_rng_seed(uint32_t seed)
+{
+    SHA256((uint8_t const *)&seed, sizeof(seed), m_rng_key);
+    m_rng_counter = 0;
+    RAND_set_rand_method(&m_host_rand_method);
+}
+
+
+ret_code_t nrf_crypto_rng_vector_generate(uint8_t * const p_target,
+                                          size_t size)
+{
+    if(p_target == NULL) return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+
+    cc310_ready_wait();
+
+    return (RAND_bytes(p_target, (int)size) == 1) ? NRF_SUCCESS :
+                                                    NRF_ERROR_CRYPTO_INTERNAL;
+}
+
+
+ret_code_t nrf_crypto_hash_init(nrf_crypto_hash_context_t * const p_context,
+                                nrf_crypto_hash_info_t const * p_info)
+{
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+    if(p_info == NULL) return NRF_ERROR_CRYPTO_INVALID_PARAM;
+
+    cc310_ready_wait();
+
+    p_context->p_info = p_info;
+    SHA256_Init((SHA256_CTX *)p_context->state);
+    p_context->init_value = CONTEXT_INIT_VALUE;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_hash_update(nrf_crypto_hash_context_t * const p_context,
+                                  uint8_t const * p_data,
+                                  size_t data_size)
+{
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+    if(p_context->init_value != CONTEXT_INIT_VALUE)
+    {
+        return NRF_ERROR_CRYPTO_CONTEXT_NOT_INITIALIZED;
+    }
+    if(p_data == NULL && data_size != 0) return NRF_ERROR_CRYPTO_INPUT_NULL;
+
+    cc310_ready_wait();
+
+    SHA256_Update((SHA256_CTX *)p_context->state, p_data, data_size);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_hash_finalize(nrf_crypto_hash_context_t * const p_context,
+                                    uint8_t * p_digest,
+                                    size_t * const p_digest_size)
+{
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+    if(p_context->init_value != CONTEXT_INIT_VALUE)
+    {
+        return NRF_ERROR_CRYPTO_CONTEXT_NOT_INITIALIZED;
+    }
+    if(p_digest == NULL || p_digest_size == NULL)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    }
+    if(*p_digest_size < NRF_CRYPTO_HASH_SIZE_SHA256)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_LENGTH;
+    }
+
+    cc310_ready_wait();
+
+    SHA256_Final(p_digest, (SHA256_CTX *)p_context->state);
+    *p_digest_size = NRF_CRYPTO_HASH_SIZE_SHA256;
+    p_context->init_value = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_hash_calculate(nrf_crypto_hash_context_t * const p_context,
+                                     nrf_crypto_hash_info_t const * p_info,
+                                     uint8_t const * p_data,
+                                     size_t data_size,
+                                     uint8_t * p_digest,
+                                     size_t * const p_digest_size)
+{
+    nrf_crypto_hash_context_t context;
+    nrf_crypto_hash_context_t * p_ctx = (p_context != NULL) ? p_context : &context;
+    ret_code_t ret;
+
+    ret = nrf_crypto_hash_init(p_ctx, p_info);
+    if(ret != NRF_SUCCESS) return ret;
+
+    ret = nrf_crypto_hash_update(p_ctx, p_data, data_size);
+    if(ret != NRF_SUCCESS) return ret;
+
+    return nrf_crypto_hash_finalize(p_ctx, p_digest, p_digest_size);
+}
+
+
+ret_code_t nrf_crypto_hmac_init(nrf_crypto_hmac_context_t * const p_context,
+                                nrf_crypto_hmac_info_t const * p_info,
+                                uint8_t const * p_key,
+                                size_t key_size)
+{
+    uint8_t pad[SHA256_CBLOCK];
+    uint8_t key[SHA256_CBLOCK] = {0};
+
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+    if(p_info == NULL) return NRF_ERROR_CRYPTO_INVALID_PARAM;
+    if(p_key == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+
+    cc310_ready_wait();
+
+    if(key_size > sizeof(key))
+    {
+        SHA256(p_key, key_size, key);
+    }
+    else
+    {
+        memcpy(key, p_key, key_size);
+    }
+
+    for(size_t i = 0; i < sizeof(pad); i++) pad[i] = key[i] ^ 0x36;
+    SHA256_Init(&p_context->inner);
+    SHA256_Update(&p_context->inner, pad, sizeof(pad));
+
+    for(size_t i = 0; i < sizeof(pad); i++) pad[i] = key[i] ^ 0x5c;
+    SHA256_Init(&p_context->outer);
+    SHA256_Update(&p_context->outer, pad, sizeof(pad));
+
+    memset(key, 0, sizeof(key));
+    memset(pad, 0, sizeof(pad));
+
+    p_context->p_info = p_info;
+    p_context->init_value = CONTEXT_INIT_VALUE;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_hmac_update(nrf_crypto_hmac_context_t * const p_context,
+                                  uint8_t const * p_data,
+                                  size_t data_size)
+{
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+    if(p_context->init_value != CONTEXT_INIT_VALUE)
+    {
+        return NRF_ERROR_CRYPTO_CONTEXT_NOT_INITIALIZED;
+    }
+    if(p_data == NULL && data_size != 0) return NRF_ERROR_CRYPTO_INPUT_NULL;
+
+    cc310_ready_wait();
+
+    SHA256_Update(&p_context->inner, p_data, data_size);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_hmac_finalize(nrf_crypto_hmac_context_t * const p_context,
+                                    uint8_t * p_digest,
+                                    size_t * const p_digest_size)
+{
+    uint8_t inner[SHA256_DIGEST_LENGTH];
+
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+    if(p_context->init_value != CONTEXT_INIT_VALUE)
+    {
+        return NRF_ERROR_CRYPTO_CONTEXT_NOT_INITIALIZED;
+    }
+    if(p_digest == NULL || p_digest_size == NULL)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    }
+    if(*p_digest_size < NRF_CRYPTO_HMAC_SHA256_RESULT_SIZE)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_LENGTH;
+    }
+
+    cc310_ready_wait();
+
+    SHA256_Final(inner, &p_context->inner);
+    SHA256_Update(&p_context->outer, inner, sizeof(inner));
+    SHA256_Final(p_digest, &p_context->outer);
+    *p_digest_size = NRF_CRYPTO_HMAC_SHA256_RESULT_SIZE;
+    p_context->init_value = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_hmac_calculate(nrf_crypto_hmac_context_t * const p_context,
+                                     nrf_crypto_hmac_info_t const * p_info,
+                                     uint8_t * p_digest,
+                                     size_t * const p_digest_size,
+                                     uint8_t const * p_key,
+                                     size_t key_size,
+                                     uint8_t const * p_data,
+                                     size_t data_size)
+{
+    nrf_crypto_hmac_context_t context;
+    nrf_crypto_hmac_context_t * p_ctx = (p_context != NULL) ? p_context : &context;
+    ret_code_t ret;
+
+    ret = nrf_crypto_hmac_init(p_ctx, p_info, p_key, key_size);
+    if(ret != NRF_SUCCESS) return ret;
+
+    ret = nrf_crypto_hmac_update(p_ctx, p_data, data_size);
+    if(ret != NRF_SUCCESS) return ret;
+
+    return nrf_crypto_hmac_finalize(p_ctx, p_digest, p_digest_size);
+}
+
+
+ret_code_t nrf_crypto_aes_init(nrf_crypto_aes_context_t * const p_context,
+                               nrf_crypto_aes_info_t const * const p_info,
+                               nrf_crypto_operation_t operation)
+{
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+    if(p_info == NULL) return NRF_ERROR_CRYPTO_INVALID_PARAM;
+
+    p_context->p_info = p_info;
+    p_context->operation = operation;
+    p_context->init_value = CONTEXT_INIT_VALUE;
+    p_context->key_set = false;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_aes_uninit(nrf_crypto_aes_context_t * const p_context)
+{
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+
+    p_context->init_value = 0;
+    p_context->key_set = false;
+    memset(&p_context->key, 0, sizeof(p_context->key));
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_aes_key_set(nrf_crypto_aes_context_t * const p_context,
+                                  uint8_t * p_key)
+{
+    int ret;
+
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+    if(p_context->init_value != CONTEXT_INIT_VALUE)
+    {
+        return NRF_ERROR_CRYPTO_CONTEXT_NOT_INITIALIZED;
+    }
+    if(p_key == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+
+    cc310_ready_wait();
+
+    if(p_context->operation == NRF_CRYPTO_ENCRYPT)
+    {
+        ret = AES_set_encrypt_key(p_key, (int)p_context->p_info->key_size,
+                                  &p_context->key);
+    }
+    else
+    {
+        ret = AES_set_decrypt_key(p_key, (int)p_context->p_info->key_size,
+                                  &p_context->key);
+    }
+    if(ret != 0) return NRF_ERROR_CRYPTO_KEY_SIZE;
+
+    p_context->key_set = true;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_aes_update(nrf_crypto_aes_context_t * const p_context,
+                                 uint8_t * p_data_in,
+                                 size_t data_size,
+                                 uint8_t * p_data_out)
+{
+    if(p_context == NULL) return NRF_ERROR_CRYPTO_CONTEXT_NULL;
+    if(p_context->init_value != CONTEXT_INIT_VALUE)
+    {
+        return NRF_ERROR_CRYPTO_CONTEXT_NOT_INITIALIZED;
+    }
+    if(!p_context->key_set) return NRF_ERROR_CRYPTO_INTERNAL;
+    if(p_data_in == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+    if(p_data_out == NULL) return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    if(data_size % NRF_CRYPTO_AES_BLOCK_SIZE != 0)
+    {
+        return NRF_ERROR_CRYPTO_INPUT_LENGTH;
+    }
+
+    cc310_ready_wait();
+
+    for(size_t offset = 0; offset < data_size; offset += NRF_CRYPTO_AES_BLOCK_SIZE)
+    {
+        AES_ecb_encrypt(p_data_in + offset, p_data_out + offset,
+                        &p_context->key,
+                        (p_context->operation == NRF_CRYPTO_ENCRYPT) ?
+                        AES_ENCRYPT : AES_DECRYPT);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_aes_crypt(nrf_crypto_aes_context_t * const p_context,
+                                nrf_crypto_aes_info_t const * const p_info,
+                                nrf_crypto_operation_t operation,
+                                uint8_t * p_key,
+                                uint8_t * p_iv,
+                                uint8_t * p_data_in,
+                                size_t data_size,
+                                uint8_t * p_data_out,
+                                size_t * p_data_out_size)
+{
+    AES_KEY key;
+    int ret;
+
+    if(p_info == NULL) return NRF_ERROR_CRYPTO_INVALID_PARAM;
+    if(p_key == NULL || p_data_in == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+    if(p_data_out == NULL || p_data_out_size == NULL)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    }
+    if(data_size % NRF_CRYPTO_AES_BLOCK_SIZE != 0)
+    {
+        return NRF_ERROR_CRYPTO_INPUT_LENGTH;
+    }
+    if(*p_data_out_size < data_size)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_LENGTH;
+    }
+
+    cc310_ready_wait();
+
+    if(operation == NRF_CRYPTO_ENCRYPT)
+    {
+        ret = AES_set_encrypt_key(p_key, (int)p_info->key_size, &key);
+    }
+    else
+    {
+        ret = AES_set_decrypt_key(p_key, (int)p_info->key_size, &key);
+    }
+    if(ret != 0) return NRF_ERROR_CRYPTO_KEY_SIZE;
+
+    for(size_t offset = 0; offset < data_size; offset += NRF_CRYPTO_AES_BLOCK_SIZE)
+    {
+        AES_ecb_encrypt(p_data_in + offset, p_data_out + offset, &key,
+                        (operation == NRF_CRYPTO_ENCRYPT) ? AES_ENCRYPT : AES_DECRYPT);
+    }
+
+    *p_data_out_size = data_size;
+
+    return NRF_SUCCESS;
+}
+
+
+/**
+ * @brief Build an OpenSSL key from raw key values, either may be NULL.
+ */
+static EC_KEY * ec_key_from_raw(uint8_t const * p_private, uint8_t const * p_public)
+{
+    EC_KEY * p_key = EC_KEY_new();
+    bool ok = (p_key != NULL) && (m_p_group != NULL) &&
+              (EC_KEY_set_group(p_key, m_p_group) == 1);
+
+    if(ok && p_private != NULL)
+    {
+        BIGNUM * p_bn = BN_bin2bn(p_private,
+                                  NRF_CRYPTO_ECC_SECP256R1_RAW_PRIVATE_KEY_SIZE,
+                                  NULL);
+        ok = (p_bn != NULL) && (EC_KEY_set_private_key(p_key, p_bn) == 1);
+        BN_clear_free(p_bn);
+    }
+
+    if(ok && p_public != NULL)
+    {
+        uint8_t point[NRF_CRYPTO_ECC_SECP256R1_RAW_PUBLIC_KEY_SIZE + 1];
+
+        point[0] = POINT_CONVERSION_UNCOMPRESSED;
+        memcpy(&point[1], p_public, NRF_CRYPTO_ECC_SECP256R1_RAW_PUBLIC_KEY_SIZE);
+        ok = (EC_KEY_oct2key(p_key, point, sizeof(point), NULL) == 1);
+    }
+
+    if(!ok)
+    {
+        EC_KEY_free(p_key);
+        return NULL;
+    }
+
+    return p_key;
+}
+
+
+ret_code_t nrf_crypto_ecc_key_pair_generate(
+    nrf_crypto_ecc_key_pair_generate_context_t * p_context,
+    nrf_crypto_ecc_curve_info_t const * p_curve_info,
+    nrf_crypto_ecc_private_key_t * p_private_key,
+    nrf_crypto_ecc_public_key_t * p_public_key)
+{
+    uint8_t point[NRF_CRYPTO_ECC_SECP256R1_RAW_PUBLIC_KEY_SIZE + 1];
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    EC_KEY * p_key;
+
+    if(!m_initialized) return NRF_ERROR_CRYPTO_NOT_INITIALIZED;
+    if(p_curve_info == NULL) return NRF_ERROR_CRYPTO_INVALID_PARAM;
+    if(p_curve_info->curve_type != NRF_CRYPTO_ECC_SECP256R1_CURVE_TYPE)
+    {
+        return NRF_ERROR_CRYPTO_FEATURE_UNAVAILABLE;
+    }
+    if(p_private_key == NULL || p_public_key == NULL)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    }
+
+    cc310_ready_wait();
+
+    p_key = ec_key_from_raw(NULL, NULL);
+    if(p_key == NULL) return NRF_ERROR_CRYPTO_INTERNAL;
+
+    if(EC_KEY_generate_key(p_key) == 1 &&
+       BN_bn2binpad(EC_KEY_get0_private_key(p_key), p_private_key->key,
+                    sizeof(p_private_key->key)) == sizeof(p_private_key->key) &&
+       EC_POINT_point2oct(m_p_group, EC_KEY_get0_public_key(p_key),
+                          POINT_CONVERSION_UNCOMPRESSED, point, sizeof(point),
+                          NULL) == sizeof(point))
+    {
+        memcpy(p_public_key->key, &point[1], sizeof(p_public_key->key));
+        p_private_key->p_info = p_curve_info;
+        p_public_key->p_info = p_curve_info;
+        ret = NRF_SUCCESS;
+    }
+
+    EC_KEY_free(p_key);
+
+    return ret;
+}
+
+
+/**
+ * @brief Public key of an Ed25519 private key, the seed of RFC 8032.
+ */
+static ret_code_t ed25519_public_key_calculate(
+    nrf_crypto_ecc_private_key_t const * p_private_key,
+    nrf_crypto_ecc_public_key_t * p_public_key)
+{
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    size_t size = NRF_CRYPTO_ECC_ED25519_RAW_PUBLIC_KEY_SIZE;
+    EVP_PKEY * p_key;
+
+    p_key = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL,
+                                         p_private_key->key,
+                                         NRF_CRYPTO_ECC_ED25519_RAW_PRIVATE_KEY_SIZE);
+    if(p_key != NULL &&
+       EVP_PKEY_get_raw_public_key(p_key, p_public_key->key, &size) == 1)
+    {
+        p_public_key->p_info = p_private_key->p_info;
+        ret = NRF_SUCCESS;
+    }
+
+    EVP_PKEY_free(p_key);
+
+    return ret;
+}
+
+
+ret_code_t nrf_crypto_ecc_public_key_calculate(
+    nrf_crypto_ecc_public_key_calculate_context_t * p_context,
+    nrf_crypto_ecc_private_key_t const * p_private_key,
+    nrf_crypto_ecc_public_key_t * p_public_key)
+{
+    uint8_t point[NRF_CRYPTO_ECC_SECP256R1_RAW_PUBLIC_KEY_SIZE + 1];
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    EC_POINT * p_point;
+    BIGNUM * p_d;
+
+    if(!m_initialized) return NRF_ERROR_CRYPTO_NOT_INITIALIZED;
+    if(p_private_key == NULL || p_private_key->p_info == NULL)
+    {
+        return NRF_ERROR_CRYPTO_ECC_KEY_NOT_INITIALIZED;
+    }
+    if(p_public_key == NULL) return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+
+    cc310_ready_wait();
+
+    if(p_private_key->p_info->curve_type == NRF_CRYPTO_ECC_ED25519_CURVE_TYPE)
+    {
+        return ed25519_public_key_calculate(p_private_key, p_public_key);
+    }
+
+    p_point = EC_POINT_new(m_p_group);
+    p_d = BN_bin2bn(p_private_key->key, sizeof(p_private_key->key), NULL);
+
+    if(p_point != NULL && p_d != NULL &&
+       EC_POINT_mul(m_p_group, p_point, p_d, NULL, NULL, NULL) == 1 &&
+       EC_POINT_point2oct(m_p_group, p_point, POINT_CONVERSION_UNCOMPRESSED,
+                          point, sizeof(point), NULL) == sizeof(point))
+    {
+        memcpy(p_public_key->key, &point[1], sizeof(p_public_key->key));
+        p_public_key->p_info = p_private_key->p_info;
+        ret = NRF_SUCCESS;
+    }
+
+    BN_clear_free(p_d);
+    EC_POINT_free(p_point);
+
+    return ret;
+}
+
+
+ret_code_t nrf_crypto_ecc_private_key_from_raw(
+    nrf_crypto_ecc_curve_info_t const * p_curve_info,
+    nrf_crypto_ecc_private_key_t * p_private_key,
+    uint8_t const * p_raw_data,
+    size_t raw_data_size)
+{
+    if(p_curve_info == NULL || p_private_key == NULL)
+    {
+        return NRF_ERROR_CRYPTO_INVALID_PARAM;
+    }
+    if(p_raw_data == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+    if(raw_data_size != p_curve_info->raw_private_key_size)
+    {
+        return NRF_ERROR_CRYPTO_INPUT_LENGTH;
+    }
+    if(!m_initialized) return NRF_ERROR_CRYPTO_NOT_INITIALIZED;
+
+    /* 0 < d < n, any Ed25519 seed is valid */
+    if(p_curve_info->curve_type == NRF_CRYPTO_ECC_SECP256R1_CURVE_TYPE)
+    {
+        BIGNUM * p_d = BN_bin2bn(p_raw_data, (int)raw_data_size, NULL);
+        bool valid = (p_d != NULL) && !BN_is_zero(p_d) &&
+                     (BN_cmp(p_d, EC_GROUP_get0_order(m_p_group)) < 0);
+
+        BN_clear_free(p_d);
+        if(!valid) return NRF_ERROR_CRYPTO_ECC_INVALID_KEY;
+    }
+
+    p_private_key->p_info = p_curve_info;
+    memcpy(p_private_key->key, p_raw_data, raw_data_size);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_ecc_private_key_to_raw(
+    nrf_crypto_ecc_private_key_t const * p_private_key,
+    uint8_t * p_raw_data,
+    size_t * p_raw_data_size)
+{
+    if(p_private_key == NULL || p_private_key->p_info == NULL)
+    {
+        return NRF_ERROR_CRYPTO_ECC_KEY_NOT_INITIALIZED;
+    }
+    if(p_raw_data == NULL || p_raw_data_size == NULL)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    }
+    if(*p_raw_data_size < p_private_key->p_info->raw_private_key_size)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_LENGTH;
+    }
+
+    memcpy(p_raw_data, p_private_key->key, p_private_key->p_info->raw_private_key_size);
+    *p_raw_data_size = p_private_key->p_info->raw_private_key_size;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_ecc_public_key_from_raw(
+    nrf_crypto_ecc_curve_info_t const * p_curve_info,
+    nrf_crypto_ecc_public_key_t * p_public_key,
+    uint8_t const * p_raw_data,
+    size_t raw_data_size)
+{
+    if(p_curve_info == NULL || p_public_key == NULL)
+    {
+        return NRF_ERROR_CRYPTO_INVALID_PARAM;
+    }
+    if(p_raw_data == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+    if(raw_data_size != p_curve_info->raw_public_key_size)
+    {
+        return NRF_ERROR_CRYPTO_INPUT_LENGTH;
+    }
+
+    p_public_key->p_info = p_curve_info;
+    memcpy(p_public_key->key, p_raw_data, raw_data_size);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_ecc_public_key_to_raw(
+    nrf_crypto_ecc_public_key_t const * p_public_key,
+    uint8_t * p_raw_data,
+    size_t * p_raw_data_size)
+{
+    if(p_public_key == NULL || p_public_key->p_info == NULL)
+    {
+        return NRF_ERROR_CRYPTO_ECC_KEY_NOT_INITIALIZED;
+    }
+    if(p_raw_data == NULL || p_raw_data_size == NULL)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    }
+    if(*p_raw_data_size < p_public_key->p_info->raw_public_key_size)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_LENGTH;
+    }
+
+    memcpy(p_raw_data, p_public_key->key, p_public_key->p_info->raw_public_key_size);
+    *p_raw_data_size = p_public_key->p_info->raw_public_key_size;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_ecc_private_key_free(nrf_crypto_ecc_private_key_t * p_private_key)
+{
+    if(p_private_key == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+
+    memset(p_private_key, 0, sizeof(nrf_crypto_ecc_private_key_t));
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_ecc_public_key_free(nrf_crypto_ecc_public_key_t * p_public_key)
+{
+    if(p_public_key == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+
+    memset(p_public_key, 0, sizeof(nrf_crypto_ecc_public_key_t));
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_crypto_ecdsa_sign(nrf_crypto_ecdsa_sign_context_t * p_context,
+                                 nrf_crypto_ecc_private_key_t const * p_private_key,
+                                 uint8_t const * p_hash,
+                                 size_t hash_size,
+                                 uint8_t * p_signature,
+                                 size_t * p_signature_size)
+{
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    EC_KEY * p_key;
+    ECDSA_SIG * p_sig;
+
+    if(!m_initialized) return NRF_ERROR_CRYPTO_NOT_INITIALIZED;
+    if(p_private_key == NULL || p_private_key->p_info == NULL)
+    {
+        return NRF_ERROR_CRYPTO_ECC_KEY_NOT_INITIALIZED;
+    }
+    if(p_hash == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+    if(p_signature == NULL || p_signature_size == NULL)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    }
+    if(*p_signature_size < NRF_CRYPTO_ECDSA_SECP256R1_SIGNATURE_SIZE)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_LENGTH;
+    }
+
+    cc310_ready_wait();
+
+    p_key = ec_key_from_raw(p_private_key->key, NULL);
+    if(p_key == NULL) return NRF_ERROR_CRYPTO_INTERNAL;
+
+    p_sig = ECDSA_do_sign(p_hash, (int)hash_size, p_key);
+    if(p_sig != NULL &&
+       BN_bn2binpad(ECDSA_SIG_get0_r(p_sig), p_signature, 32) == 32 &&
+       BN_bn2binpad(ECDSA_SIG_get0_s(p_sig), p_signature + 32, 32) == 32)
+    {
+        *p_signature_size = NRF_CRYPTO_ECDSA_SECP256R1_SIGNATURE_SIZE;
+        ret = NRF_SUCCESS;
+    }
+
+    ECDSA_SIG_free(p_sig);
+    EC_KEY_free(p_key);
+
+    return ret;
+}
+
+
+ret_code_t nrf_crypto_ecdsa_verify(nrf_crypto_ecdsa_verify_context_t * p_context,
+                                   nrf_crypto_ecc_public_key_t const * p_public_key,
+                                   uint8_t const * p_hash,
+                                   size_t hash_size,
+                                   uint8_t const * p_signature,
+                                   size_t signature_size)
+{
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    EC_KEY * p_key;
+    ECDSA_SIG * p_sig;
+
+    if(!m_initialized) return NRF_ERROR_CRYPTO_NOT_INITIALIZED;
+    if(p_public_key == NULL || p_public_key->p_info == NULL)
+    {
+        return NRF_ERROR_CRYPTO_ECC_KEY_NOT_INITIALIZED;
+    }
+    if(p_hash == NULL || p_signature == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+    if(signature_size != NRF_CRYPTO_ECDSA_SECP256R1_SIGNATURE_SIZE)
+    {
+        return NRF_ERROR_CRYPTO_INPUT_LENGTH;
+    }
+
+    cc310_ready_wait();
+
+    p_key = ec_key_from_raw(NULL, p_public_key->key);
+    if(p_key == NULL) return NRF_ERROR_CRYPTO_ECC_INVALID_KEY;
+
+    p_sig = ECDSA_SIG_new();
+    if(p_sig != NULL)
+    {
+        BIGNUM * p_r = BN_bin2bn(p_signature, 32, NULL);
+        BIGNUM * p_s = BN_bin2bn(p_signature + 32, 32, NULL);
+
+        if(p_r != NULL && p_s != NULL && ECDSA_SIG_set0(p_sig, p_r, p_s) == 1)
+        {
+            ret = (ECDSA_do_verify(p_hash, (int)hash_size, p_sig, p_key) == 1) ?
+                  NRF_SUCCESS : NRF_ERROR_CRYPTO_ECDSA_INVALID_SIGNATURE;
+        }
+        else
+        {
+            BN_free(p_r);
+            BN_free(p_s);
+        }
+    }
+
+    ECDSA_SIG_free(p_sig);
+    EC_KEY_free(p_key);
+
+    return ret;
+}
+
+
+ret_code_t nrf_crypto_eddsa_sign(nrf_crypto_eddsa_sign_context_t * p_context,
+                                 nrf_crypto_ecc_private_key_t const * p_private_key,
+                                 uint8_t const * p_message,
+                                 size_t message_size,
+                                 uint8_t * p_signature,
+                                 size_t * p_signature_size)
+{
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    EVP_MD_CTX * p_ctx;
+    EVP_PKEY * p_key;
+
+    if(!m_initialized) return NRF_ERROR_CRYPTO_NOT_INITIALIZED;
+    if(p_private_key == NULL || p_private_key->p_info == NULL)
+    {
+        return NRF_ERROR_CRYPTO_ECC_KEY_NOT_INITIALIZED;
+    }
+    if(p_private_key->p_info->curve_type != NRF_CRYPTO_ECC_ED25519_CURVE_TYPE)
+    {
+        return NRF_ERROR_CRYPTO_INVALID_PARAM;
+    }
+    if(p_message == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+    if(p_signature == NULL || p_signature_size == NULL)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    }
+    if(*p_signature_size < NRF_CRYPTO_EDDSA_ED25519_SIGNATURE_SIZE)
+    {
+        return NRF_ERROR_CRYPTO_OUTPUT_LENGTH;
+    }
+
+    cc310_ready_wait();
+
+    p_key = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL,
+                                         p_private_key->key,
+                                         NRF_CRYPTO_ECC_ED25519_RAW_PRIVATE_KEY_SIZE);
+    p_ctx = EVP_MD_CTX_new();
+
+    if(p_key != NULL && p_ctx != NULL &&
+       EVP_DigestSignInit(p_ctx, NULL, NULL, NULL, p_key) == 1 &&
+       EVP_DigestSign(p_ctx, p_signature, p_signature_size,
+                      p_message, message_size) == 1)
+    {
+        ret = NRF_SUCCESS;
+    }
+
+    EVP_MD_CTX_free(p_ctx);
+    EVP_PKEY_free(p_key);
+
+    return ret;
+}
+
+
+ret_code_t nrf_crypto_eddsa_verify(nrf_crypto_eddsa_verify_context_t * p_context,
+                                   nrf_crypto_ecc_public_key_t const * p_public_key,
+                                   uint8_t const * p_message,
+                                   size_t message_size,
+                                   uint8_t const * p_signature,
+                                   size_t signature_size)
+{
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    EVP_MD_CTX * p_ctx;
+    EVP_PKEY * p_key;
+
+    if(!m_initialized) return NRF_ERROR_CRYPTO_NOT_INITIALIZED;
+    if(p_public_key == NULL || p_public_key->p_info == NULL)
+    {
+        return NRF_ERROR_CRYPTO_ECC_KEY_NOT_INITIALIZED;
+    }
+    if(p_message == NULL || p_signature == NULL) return NRF_ERROR_CRYPTO_INPUT_NULL;
+    if(signature_size != NRF_CRYPTO_EDDSA_ED25519_SIGNATURE_SIZE)
+    {
+        return NRF_ERROR_CRYPTO_INPUT_LENGTH;
+    }
+
+    cc310_ready_wait();
+
+    p_key = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL,
+                                        p_public_key->key,
+                                        NRF_CRYPTO_ECC_ED25519_RAW_PUBLIC_KEY_SIZE);
+    p_ctx = EVP_MD_CTX_new();
+
+    if(p_key != NULL && p_ctx != NULL &&
+       EVP_DigestVerifyInit(p_ctx, NULL, NULL, NULL, p_key) == 1)
+    {
+        ret = (EVP_DigestVerify(p_ctx, p_signature, signature_size,
+                                p_message, message_size) == 1) ?
+              NRF_SUCCESS : NRF_ERROR_CRYPTO_ECDSA_INVALID_SIGNATURE;
+    }
+
+    EVP_MD_CTX_free(p_ctx);
+    EVP_PKEY_free(p_key);
+
+    return ret;
+}
@@ -0,0 +1,104 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_crypto_aes.h
+ * @brief Host stand-in of the nRF5 SDK crypto AES, ECB 128 only.
+ */
+
+#ifndef NRF_CRYPTO_AES_H__
+#define NRF_CRYPTO_AES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <openssl/aes.h>
+
+#include "sdk_errors.h"
+#include "nrf_crypto_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NRF_CRYPTO_AES_BLOCK_SIZE   (16)
+
+typedef enum
+{
+    NRF_CRYPTO_AES_MODE_ECB,
+} nrf_crypto_aes_mode_t;
+
+typedef struct
+{
+    nrf_crypto_aes_mode_t mode;
+    uint32_t              key_size;     //!< Key size in bits.
+} nrf_crypto_aes_info_t;
+
+typedef struct
+{
+    nrf_crypto_aes_info_t const * p_info;
+    nrf_crypto_operation_t        operation;
+    uint32_t                      init_value;
+    AES_KEY                       key;          //!< Expanded by nrf_crypto_aes_key_set().
+    bool                          key_set;
+} nrf_crypto_aes_context_t;
+
+extern const nrf_crypto_aes_info_t g_nrf_crypto_aes_ecb_128_info;
+
+ret_code_t nrf_crypto_aes_init(nrf_crypto_aes_context_t * const p_context,
+                               nrf_crypto_aes_info_t const * const p_info,
+                               nrf_crypto_operation_t operation);
+
+ret_code_t nrf_crypto_aes_uninit(nrf_crypto_aes_context_t * const p_context);
+
+ret_code_t nrf_crypto_aes_key_set(nrf_crypto_aes_context_t * const p_context,
+                                  uint8_t * p_key);
+
+ret_code_t nrf_crypto_aes_update(nrf_crypto_aes_context_t * const p_context,
+                                 uint8_t * p_data_in,
+                                 size_t data_size,
+                                 uint8_t * p_data_out);
+
+ret_code_t nrf_crypto_aes_crypt(nrf_crypto_aes_context_t * const p_context,
+                                nrf_crypto_aes_info_t const * const p_info,
+                                nrf_crypto_operation_t operation,
+                                uint8_t * p_key,
+                                uint8_t * p_iv,
+                                uint8_t * p_data_in,
+                                size_t data_size,
+                                uint8_t * p_data_out,
+                                size_t * p_data_out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_CRYPTO_AES_H__
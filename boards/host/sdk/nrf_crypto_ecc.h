@@ -0,0 +1,138 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_crypto_ecc.h
+ * @brief Host stand-in of the nRF5 SDK crypto ECC, secp256r1 and Ed25519.
+ *
+ * Keys hold their raw value, there is nothing to free. A secp256r1 private
+ * key out of [1, n - 1] is refused when imported, as CC310 does. Ed25519
+ * keys are only imported and computed, not generated.
+ */
+
+#ifndef NRF_CRYPTO_ECC_H__
+#define NRF_CRYPTO_ECC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NRF_CRYPTO_ECC_SECP256R1_RAW_PRIVATE_KEY_SIZE   (32)
+#define NRF_CRYPTO_ECC_SECP256R1_RAW_PUBLIC_KEY_SIZE    (64)
+#define NRF_CRYPTO_ECC_ED25519_RAW_PRIVATE_KEY_SIZE     (32)
+#define NRF_CRYPTO_ECC_ED25519_RAW_PUBLIC_KEY_SIZE      (32)
+
+typedef enum
+{
+    NRF_CRYPTO_ECC_SECP256R1_CURVE_TYPE,
+    NRF_CRYPTO_ECC_ED25519_CURVE_TYPE,
+} nrf_crypto_ecc_curve_type_t;
+
+typedef struct
+{
+    nrf_crypto_ecc_curve_type_t curve_type;
+    uint8_t                     raw_private_key_size;
+    uint8_t                     raw_public_key_size;
+} nrf_crypto_ecc_curve_info_t;
+
+typedef uint8_t nrf_crypto_ecc_secp256r1_raw_private_key_t
+    [NRF_CRYPTO_ECC_SECP256R1_RAW_PRIVATE_KEY_SIZE];
+typedef uint8_t nrf_crypto_ecc_secp256r1_raw_public_key_t
+    [NRF_CRYPTO_ECC_SECP256R1_RAW_PUBLIC_KEY_SIZE];
+typedef uint8_t nrf_crypto_ecc_ed25519_raw_private_key_t
+    [NRF_CRYPTO_ECC_ED25519_RAW_PRIVATE_KEY_SIZE];
+typedef uint8_t nrf_crypto_ecc_ed25519_raw_public_key_t
+    [NRF_CRYPTO_ECC_ED25519_RAW_PUBLIC_KEY_SIZE];
+
+typedef struct
+{
+    nrf_crypto_ecc_curve_info_t const * p_info;
+    uint8_t key[NRF_CRYPTO_ECC_SECP256R1_RAW_PRIVATE_KEY_SIZE];
+} nrf_crypto_ecc_private_key_t;
+
+typedef struct
+{
+    nrf_crypto_ecc_curve_info_t const * p_info;
+    uint8_t key[NRF_CRYPTO_ECC_SECP256R1_RAW_PUBLIC_KEY_SIZE];
+} nrf_crypto_ecc_public_key_t;
+
+typedef uint32_t nrf_crypto_ecc_key_pair_generate_context_t;
+typedef uint32_t nrf_crypto_ecc_public_key_calculate_context_t;
+
+extern const nrf_crypto_ecc_curve_info_t g_nrf_crypto_ecc_secp256r1_curve_info;
+extern const nrf_crypto_ecc_curve_info_t g_nrf_crypto_ecc_ed25519_curve_info;
+
+ret_code_t nrf_crypto_ecc_key_pair_generate(
+    nrf_crypto_ecc_key_pair_generate_context_t * p_context,
+    nrf_crypto_ecc_curve_info_t const * p_curve_info,
+    nrf_crypto_ecc_private_key_t * p_private_key,
+    nrf_crypto_ecc_public_key_t * p_public_key);
+
+ret_code_t nrf_crypto_ecc_public_key_calculate(
+    nrf_crypto_ecc_public_key_calculate_context_t * p_context,
+    nrf_crypto_ecc_private_key_t const * p_private_key,
+    nrf_crypto_ecc_public_key_t * p_public_key);
+
+ret_code_t nrf_crypto_ecc_private_key_from_raw(
+    nrf_crypto_ecc_curve_info_t const * p_curve_info,
+    nrf_crypto_ecc_private_key_t * p_private_key,
+    uint8_t const * p_raw_data,
+    size_t raw_data_size);
+
+ret_code_t nrf_crypto_ecc_private_key_to_raw(
+    nrf_crypto_ecc_private_key_t const * p_private_key,
+    uint8_t * p_raw_data,
+    size_t * p_raw_data_size);
+
+ret_code_t nrf_crypto_ecc_public_key_from_raw(
+    nrf_crypto_ecc_curve_info_t const * p_curve_info,
+    nrf_crypto_ecc_public_key_t * p_public_key,
+    uint8_t const * p_raw_data,
+    size_t raw_data_size);
+
+ret_code_t nrf_crypto_ecc_public_key_to_raw(
+    nrf_crypto_ecc_public_key_t const * p_public_key,
+    uint8_t * p_raw_data,
+    size_t * p_raw_data_size);
+
+ret_code_t nrf_crypto_ecc_private_key_free(nrf_crypto_ecc_private_key_t * p_private_key);
+
+ret_code_t nrf_crypto_ecc_public_key_free(nrf_crypto_ecc_public_key_t * p_public_key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_CRYPTO_ECC_H__
@@ -0,0 +1,75 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_crypto_eddsa.h
+ * @brief Host stand-in of the nRF5 SDK crypto EdDSA, Ed25519.
+ */
+
+#ifndef NRF_CRYPTO_EDDSA_H__
+#define NRF_CRYPTO_EDDSA_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+#include "nrf_crypto_ecc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NRF_CRYPTO_EDDSA_ED25519_SIGNATURE_SIZE     (64)
+
+typedef uint8_t nrf_crypto_eddsa_ed25519_signature_t
+    [NRF_CRYPTO_EDDSA_ED25519_SIGNATURE_SIZE];
+
+typedef uint32_t nrf_crypto_eddsa_sign_context_t;
+typedef uint32_t nrf_crypto_eddsa_verify_context_t;
+
+ret_code_t nrf_crypto_eddsa_sign(nrf_crypto_eddsa_sign_context_t * p_context,
+                                 nrf_crypto_ecc_private_key_t const * p_private_key,
+                                 uint8_t const * p_message,
+                                 size_t message_size,
+                                 uint8_t * p_signature,
+                                 size_t * p_signature_size);
+
+ret_code_t nrf_crypto_eddsa_verify(nrf_crypto_eddsa_verify_context_t * p_context,
+                                   nrf_crypto_ecc_public_key_t const * p_public_key,
+                                   uint8_t const * p_message,
+                                   size_t message_size,
+                                   uint8_t const * p_signature,
+                                   size_t signature_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_CRYPTO_EDDSA_H__
@@ -0,0 +1,99 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_crypto_hmac.h
+ * @brief Host stand-in of the nRF5 SDK crypto HMAC, SHA-256 only.
+ */
+
+#ifndef NRF_CRYPTO_HMAC_H__
+#define NRF_CRYPTO_HMAC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <openssl/sha.h>
+
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NRF_CRYPTO_HMAC_SHA256_RESULT_SIZE  (32)
+
+typedef enum
+{
+    NRF_CRYPTO_HMAC_SHA256_TYPE,
+} nrf_crypto_hmac_type_t;
+
+typedef struct
+{
+    nrf_crypto_hmac_type_t type;
+    uint32_t               digest_size;
+} nrf_crypto_hmac_info_t;
+
+typedef struct
+{
+    nrf_crypto_hmac_info_t const * p_info;
+    uint32_t                       init_value;
+    SHA256_CTX                     inner;
+    SHA256_CTX                     outer;
+} nrf_crypto_hmac_context_t;
+
+extern const nrf_crypto_hmac_info_t g_nrf_crypto_hmac_sha256_info;
+
+ret_code_t nrf_crypto_hmac_init(nrf_crypto_hmac_context_t * const p_context,
+                                nrf_crypto_hmac_info_t const * p_info,
+                                uint8_t const * p_key,
+                                size_t key_size);
+
+ret_code_t nrf_crypto_hmac_update(nrf_crypto_hmac_context_t * const p_context,
+                                  uint8_t const * p_data,
+                                  size_t data_size);
+
+ret_code_t nrf_crypto_hmac_finalize(nrf_crypto_hmac_context_t * const p_context,
+                                    uint8_t * p_digest,
+                                    size_t * const p_digest_size);
+
+ret_code_t nrf_crypto_hmac_calculate(nrf_crypto_hmac_context_t * const p_context,
+                                     nrf_crypto_hmac_info_t const * p_info,
+                                     uint8_t * p_digest,
+                                     size_t * const p_digest_size,
+                                     uint8_t const * p_key,
+                                     size_t key_size,
+                                     uint8_t const * p_data,
+                                     size_t data_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_CRYPTO_HMAC_H__
@@ -0,0 +1,208 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_host.h
+ * @brief Controls of the host stand-ins, used by the test driver.
+ *
+ * The firmware sources see the SDK interfaces only. This header gives the
+ * driver the other end of them: the USB host side of the HID generic class,
+ * the flash image behind FDS, the clock and the RTT channels.
+ */
+
+#ifndef NRF_HOST_H__
+#define NRF_HOST_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Size of a HID report exchanged with the test driver.
+ */
+#define HOST_USBD_REPORT_SIZE   64
+
+
+/**
+ * @brief Nanoseconds since the first call, including the skipped time.
+ */
+uint64_t host_clock_ns(void);
+
+
+/**
+ * @brief Move the clock forward, as if @p ms had elapsed.
+ *
+ * Lets a test reach the protocol timeouts without waiting for them.
+ * The timers that expire are run.
+ */
+void host_clock_skip_ms(uint32_t ms);
+
+
+/**
+ * @brief Stop the clock at its current time.
+ *
+ * The time then only moves with @ref host_clock_skip_ms and
+ * @ref host_clock_set_ns, so that a run can be repeated exactly. The cycle
+ * counter stops as well.
+ */
+void host_clock_stop(void);
+
+
+/**
+ * @brief Tell whether the clock is stopped, see @ref host_clock_stop.
+ */
+bool host_clock_is_stopped(void);
+
+
+/**
+ * @brief Move the stopped clock forward to @p ns.
+ *
+ * The timers that expire are not run, see @ref app_timer_host_process.
+ * Does nothing if the clock runs, or is already past @p ns.
+ */
+void host_clock_set_ns(uint64_t ns);
+
+
+/**
+ * @brief Run the app_timer timers that expired.
+ *
+ * @retval true  Timers expired, and were run.
+ * @retval false No timer expired.
+ */
+bool app_timer_host_process(void);
+
+
+/**
+ * @brief Deliver the RNG values generated since the last call.
+ *
+ * Runs the RNG interrupt handler for each. When the clock is stopped, the
+ * RNG delivers its values without waiting, as fast as they are read.
+ */
+void host_rng_process(void);
+
+
+/**
+ * @brief Send an OUT report to the device.
+ *
+ * Runs the USBD event handlers, and so the frame layer, before returning
+ * unless called from an interrupt handler or a critical region.
+ *
+ * @param[in] p_report  Report, @ref HOST_USBD_REPORT_SIZE bytes.
+ * @param[in] size      Report size.
+ *
+ * @retval NRF_SUCCESS          Report delivered.
+ * @retval NRF_ERROR_BUSY       Device event queue full.
+ * @retval NRF_ERROR_INVALID_STATE  Device not started.
+ */
+ret_code_t host_usbd_out_report(uint8_t const * p_report, size_t size);
+
+
+/**
+ * @brief Read the pending IN report of the device.
+ *
+ * Completes the IN transfer, which lets the device queue the next report.
+ *
+ * @param[out] p_report Buffer of @ref HOST_USBD_REPORT_SIZE bytes.
+ *
+ * @retval true  A report was read.
+ * @retval false No IN report pending.
+ */
+bool host_usbd_in_report_get(uint8_t * p_report);
+
+
+/**
+ * @brief Suspend or resume the bus.
+ */
+void host_usbd_suspend(bool suspend);
+
+
+/**
+ * @brief Back FDS with a file.
+ *
+ * Must be called before fds_init(). The records are loaded from @p p_path
+ * if it exists, and the file is rewritten after every operation.
+ *
+ * @param[in] p_path    Image file, NULL to keep the records in RAM only.
+ */
+void fds_host_image_set(char const * p_path);
+
+
+/**
+ * @brief Direct an RTT up channel to a file.
+ *
+ * @param[in] channel   RTT up channel.
+ * @param[in] p_file    Output, NULL to discard the data.
+ */
+void SEGGER_RTT_host_output_set(unsigned channel, FILE * p_file);
+
+
+/**
+ * @brief Print the NRF_LOG messages up to @p level on stderr.
+ *
+ * @param[in] level     0 (off, default) to 4 (debug).
+ */
+void nrf_log_host_level_set(uint8_t level);
+
+
+/**
+ * @brief Run a CLI command line, as typed on the UART terminal.
+ *
+ * @param[in] p_file    Output of the command.
+ * @param[in] p_line    Command line, e.g. "stats latency".
+ *
+ * @retval NRF_SUCCESS          Command run.
+ * @retval NRF_ERROR_NOT_FOUND  Unknown command.
+ */
+ret_code_t nrf_cli_host_exec(FILE * p_file, char const * p_line);
+
+
+/**
+ * @brief Draw the random numbers from a generator seeded with @p seed.
+ *
+ * Covers nrf_crypto_rng as well as the numbers OpenSSL draws for the key
+ * pairs and the signature nonces, so that the same requests get the same
+ * responses. For tests only: the numbers are predictable.
+ *
+ * @param[in] seed      Seed of the generator.
+ */
+void nrf_crypto_host_rng_seed(uint32_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_HOST_H__
@@ -0,0 +1,71 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_log.c
+ * @brief Host stand-in of the nRF5 SDK logger, prints on stderr.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "nrf_log.h"
+#include "nrf_host.h"
+
+
+static uint8_t m_level = NRF_LOG_SEVERITY_NONE;
+
+
+void nrf_log_host_level_set(uint8_t level)
+{
+    m_level = level;
+}
+
+
+void nrf_log_host_printf(uint8_t level, char const * p_module,
+                         char const * p_format, ...)
+{
+    static char const * const severity_names[] = {
+        "", "error", "warning", "info", "debug"
+    };
+    va_list args;
+
+    if(level > m_level)
+    {
+        return;
+    }
+
+    fprintf(stderr, "<%s> %s: ", severity_names[level], p_module);
+    va_start(args, p_format);
+    vfprintf(stderr, p_format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
@@ -0,0 +1,100 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_log.h
+ * @brief Host stand-in of the nRF5 SDK logger.
+ *
+ * The compile-time levels work as on the target: NRF_LOG_LEVEL, set by the
+ * module before including this file, drops the messages above it. The
+ * messages compiled in are printed on stderr up to the level set with
+ * nrf_log_host_level_set().
+ */
+
+#ifndef NRF_LOG_H_
+#define NRF_LOG_H_
+
+#include <stdint.h>
+
+#include "sdk_config.h"
+#include "app_util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef NRF_LOG_LEVEL
+#define NRF_LOG_LEVEL           NRF_LOG_DEFAULT_LEVEL
+#endif
+
+#ifndef NRF_LOG_MODULE_NAME
+#define NRF_LOG_MODULE_NAME     app
+#endif
+
+#define NRF_LOG_SEVERITY_NONE       0
+#define NRF_LOG_SEVERITY_ERROR      1
+#define NRF_LOG_SEVERITY_WARNING    2
+#define NRF_LOG_SEVERITY_INFO       3
+#define NRF_LOG_SEVERITY_DEBUG      4
+
+void nrf_log_host_printf(uint8_t level, char const * p_module,
+                         char const * p_format, ...)
+                         __attribute__((format(printf, 3, 4)));
+
+#define NRF_LOG_MODULE_REGISTER()                                   \
+    static char const m_nrf_log_module_name[] __attribute__((unused)) = \
+        STRINGIFY(NRF_LOG_MODULE_NAME)
+
+#define NRF_LOG_INTERNAL(level, ...)                                \
+    do                                                              \
+    {                                                               \
+        if(NRF_LOG_ENABLED && (NRF_LOG_LEVEL >= (level)))           \
+        {                                                           \
+            nrf_log_host_printf((level), m_nrf_log_module_name,     \
+                                __VA_ARGS__);                       \
+        }                                                           \
+    } while(0)
+
+#define NRF_LOG_ERROR(...)      NRF_LOG_INTERNAL(NRF_LOG_SEVERITY_ERROR, __VA_ARGS__)
+#define NRF_LOG_WARNING(...)    NRF_LOG_INTERNAL(NRF_LOG_SEVERITY_WARNING, __VA_ARGS__)
+#define NRF_LOG_INFO(...)       NRF_LOG_INTERNAL(NRF_LOG_SEVERITY_INFO, __VA_ARGS__)
+#define NRF_LOG_DEBUG(...)      NRF_LOG_INTERNAL(NRF_LOG_SEVERITY_DEBUG, __VA_ARGS__)
+
+#define NRF_LOG_HEXDUMP_INFO(p_data, len)   UNUSED_VARIABLE(p_data)
+#define NRF_LOG_HEXDUMP_DEBUG(p_data, len)  UNUSED_VARIABLE(p_data)
+
+#define NRF_LOG_PROCESS()       false
+#define NRF_LOG_FLUSH()         do { } while(0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_LOG_H_
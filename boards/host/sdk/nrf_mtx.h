@@ -0,0 +1,69 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_mtx.h
+ * @brief Host stand-in of the nRF5 SDK mutex.
+ */
+
+#ifndef NRF_MTX_H__
+#define NRF_MTX_H__
+
+#include <stdbool.h>
+
+#include "app_util.h"
+#include "nrf_atomic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef nrf_atomic_flag_t nrf_mtx_t;
+
+static inline void nrf_mtx_init(nrf_mtx_t * p_mtx)
+{
+    *p_mtx = 0;
+}
+
+static inline bool nrf_mtx_trylock(nrf_mtx_t * p_mtx)
+{
+    return nrf_atomic_flag_set_fetch(p_mtx) == 0;
+}
+
+static inline void nrf_mtx_unlock(nrf_mtx_t * p_mtx)
+{
+    UNUSED_RETURN_VALUE(nrf_atomic_flag_clear_fetch(p_mtx));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_MTX_H__
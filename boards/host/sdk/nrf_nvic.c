@@ -0,0 +1,273 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_nvic.c
+ * @brief Host emulation of the NVIC, the DWT cycle counter and the stack.
+ *
+ * There is a single thread. Pending an interrupt runs every enabled and
+ * pending handler of a higher priority than the running context before
+ * returning, which is where the target would preempt. A critical region
+ * defers them to its end.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nrf.h"
+#include "app_util_platform.h"
+#include "app_error.h"
+#include "nrf_host.h"
+
+
+/**
+ * @brief Words of the emulated main stack, painted by u2f_stats.
+ */
+#define HOST_STACK_WORDS    2048
+
+uint32_t SystemCoreClock = 64000000;
+
+CoreDebug_Type host_core_debug;
+
+static DWT_Type m_dwt;
+
+/**
+ * @brief Emulated stack, between the linker symbols of the target.
+ *
+ * The host build is not position independent, so that the addresses fit
+ * in the 32-bit stack pointer.
+ */
+uint32_t m_host_stack[HOST_STACK_WORDS] __asm__("__StackLimit");
+__asm__(".globl __StackTop\n"
+        ".set __StackTop, __StackLimit + 4 * " STRINGIFY(HOST_STACK_WORDS));
+
+extern uint32_t __StackTop;
+
+
+typedef void (*irq_handler_t)(void);
+
+void RNG_IRQHandler(void) __WEAK;
+void RTC1_IRQHandler(void) __WEAK;
+void SWI0_EGU0_IRQHandler(void) __WEAK;
+void SWI1_EGU1_IRQHandler(void) __WEAK;
+void SWI2_EGU2_IRQHandler(void) __WEAK;
+void SWI3_EGU3_IRQHandler(void) __WEAK;
+void SWI4_EGU4_IRQHandler(void) __WEAK;
+void SWI5_EGU5_IRQHandler(void) __WEAK;
+void RTC2_IRQHandler(void) __WEAK;
+void USBD_IRQHandler(void) __WEAK;
+void CRYPTOCELL_IRQHandler(void) __WEAK;
+
+
+typedef struct
+{
+    irq_handler_t handler;
+    uint8_t       priority;
+    bool          enabled;
+    bool          pending;
+} host_irq_t;
+
+static host_irq_t m_irqs[HOST_NVIC_IRQ_COUNT];
+
+/** Priority of the running context. */
+static uint8_t m_current_priority = APP_IRQ_PRIORITY_THREAD;
+
+/** Critical region nesting. */
+static uint32_t m_critical_nesting;
+
+
+static irq_handler_t irq_handler_get(IRQn_Type irqn)
+{
+    switch(irqn)
+    {
+        case RNG_IRQn:          return RNG_IRQHandler;
+        case RTC1_IRQn:         return RTC1_IRQHandler;
+        case SWI0_EGU0_IRQn:    return SWI0_EGU0_IRQHandler;
+        case SWI1_EGU1_IRQn:    return SWI1_EGU1_IRQHandler;
+        case SWI2_EGU2_IRQn:    return SWI2_EGU2_IRQHandler;
+        case SWI3_EGU3_IRQn:    return SWI3_EGU3_IRQHandler;
+        case SWI4_EGU4_IRQn:    return SWI4_EGU4_IRQHandler;
+        case SWI5_EGU5_IRQn:    return SWI5_EGU5_IRQHandler;
+        case RTC2_IRQn:         return RTC2_IRQHandler;
+        case USBD_IRQn:         return USBD_IRQHandler;
+        case CRYPTOCELL_IRQn:   return CRYPTOCELL_IRQHandler;
+        default:                return NULL;
+    }
+}
+
+
+/**
+ * @brief Run the pending interrupts that preempt the running context.
+ */
+static void irq_dispatch(void)
+{
+    while(m_critical_nesting == 0)
+    {
+        host_irq_t * p_next = NULL;
+
+        for(size_t i = 0; i < HOST_NVIC_IRQ_COUNT; i++)
+        {
+            host_irq_t * p_irq = &m_irqs[i];
+
+            if(p_irq->pending && p_irq->enabled &&
+               p_irq->priority < m_current_priority &&
+               (p_next == NULL || p_irq->priority < p_next->priority))
+            {
+                p_next = p_irq;
+            }
+        }
+
+        if(p_next == NULL) return;
+
+        uint8_t saved = m_current_priority;
+
+        p_next->pending = false;
+        m_current_priority = p_next->priority;
+        if(p_next->handler != NULL)
+        {
+            p_next->handler();
+        }
+        m_current_priority = saved;
+    }
+}
+
+
+static host_irq_t * irq_get(IRQn_Type irqn)
+{
+    if((uint32_t)irqn >= HOST_NVIC_IRQ_COUNT)
+    {
+        APP_ERROR_HANDLER(NRF_ERROR_INVALID_PARAM);
+    }
+
+    host_irq_t * p_irq = &m_irqs[irqn];
+    p_irq->handler = irq_handler_get(irqn);
+    return p_irq;
+}
+
+
+void NVIC_SetPriority(IRQn_Type irqn, uint32_t priority)
+{
+    irq_get(irqn)->priority = (uint8_t)priority;
+}
+
+
+uint32_t NVIC_GetPriority(IRQn_Type irqn)
+{
+    return irq_get(irqn)->priority;
+}
+
+
+void NVIC_EnableIRQ(IRQn_Type irqn)
+{
+    irq_get(irqn)->enabled = true;
+    irq_dispatch();
+}
+
+
+void NVIC_DisableIRQ(IRQn_Type irqn)
+{
+    irq_get(irqn)->enabled = false;
+}
+
+
+void NVIC_SetPendingIRQ(IRQn_Type irqn)
+{
+    irq_get(irqn)->pending = true;
+    irq_dispatch();
+}
+
+
+void NVIC_ClearPendingIRQ(IRQn_Type irqn)
+{
+    irq_get(irqn)->pending = false;
+}
+
+
+uint32_t NVIC_GetPendingIRQ(IRQn_Type irqn)
+{
+    return irq_get(irqn)->pending ? 1 : 0;
+}
+
+
+void app_util_critical_region_enter(uint8_t * p_nested)
+{
+    m_critical_nesting++;
+    *p_nested = 1;
+}
+
+
+void app_util_critical_region_exit(uint8_t nested)
+{
+    UNUSED_PARAMETER(nested);
+
+    if(--m_critical_nesting == 0)
+    {
+        irq_dispatch();
+    }
+}
+
+
+uint8_t current_int_priority_get(void)
+{
+    return m_current_priority;
+}
+
+
+DWT_Type * host_dwt_get(void)
+{
+    m_dwt.CYCCNT = (uint32_t)(host_clock_ns() * (SystemCoreClock / 1000000)
+                              / 1000);
+    return &m_dwt;
+}
+
+
+uint32_t host_msp_get(void)
+{
+    return (uint32_t)(uintptr_t)&__StackTop;
+}
+
+
+void host_wfe(void)
+{
+    host_rng_process();
+    app_timer_host_process();
+}
+
+
+void app_error_handler(ret_code_t error_code, uint32_t line_num,
+                       const uint8_t * p_file_name)
+{
+    fprintf(stderr, "Fatal error 0x%04x at %s:%u\n",
+            (unsigned)error_code, (char const *)p_file_name,
+            (unsigned)line_num);
+    abort();
+}
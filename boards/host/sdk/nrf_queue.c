@@ -0,0 +1,171 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_queue.c
+ * @brief Host stand-in of the nRF5 SDK queue library.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_queue.h"
+#include "app_util_platform.h"
+
+
+static size_t nrf_queue_next_idx(nrf_queue_t const * p_queue, size_t idx)
+{
+    return (idx < p_queue->size) ? (idx + 1) : 0;
+}
+
+
+static size_t queue_utilization_get(nrf_queue_t const * p_queue)
+{
+    size_t front = p_queue->p_cb->front;
+    size_t back  = p_queue->p_cb->back;
+
+    return (back >= front) ? (back - front) : (p_queue->size + 1 - front + back);
+}
+
+
+ret_code_t nrf_queue_push(nrf_queue_t const * p_queue, void const * p_element)
+{
+    ret_code_t status = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+    bool is_full = nrf_queue_is_full(p_queue);
+
+    if(!is_full || p_queue->mode == NRF_QUEUE_MODE_OVERFLOW)
+    {
+        if(is_full)
+        {
+            p_queue->p_cb->front = nrf_queue_next_idx(p_queue,
+                                                      p_queue->p_cb->front);
+        }
+
+        memcpy((uint8_t *)p_queue->p_buffer +
+               p_queue->p_cb->back * p_queue->element_size,
+               p_element, p_queue->element_size);
+        p_queue->p_cb->back = nrf_queue_next_idx(p_queue, p_queue->p_cb->back);
+
+        size_t utilization = queue_utilization_get(p_queue);
+        if(p_queue->p_cb->max_utilization < utilization)
+        {
+            p_queue->p_cb->max_utilization = utilization;
+        }
+    }
+    else
+    {
+        status = NRF_ERROR_NO_MEM;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return status;
+}
+
+
+ret_code_t nrf_queue_generic_pop(nrf_queue_t const * p_queue,
+                                 void              * p_element,
+                                 bool                just_peek)
+{
+    ret_code_t status = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+    if(!nrf_queue_is_empty(p_queue))
+    {
+        memcpy(p_element, (uint8_t *)p_queue->p_buffer +
+               p_queue->p_cb->front * p_queue->element_size,
+               p_queue->element_size);
+        if(!just_peek)
+        {
+            p_queue->p_cb->front = nrf_queue_next_idx(p_queue,
+                                                      p_queue->p_cb->front);
+        }
+    }
+    else
+    {
+        status = NRF_ERROR_NOT_FOUND;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return status;
+}
+
+
+void nrf_queue_reset(nrf_queue_t const * p_queue)
+{
+    CRITICAL_REGION_ENTER();
+    memset(p_queue->p_cb, 0, sizeof(nrf_queue_cb_t));
+    CRITICAL_REGION_EXIT();
+}
+
+
+bool nrf_queue_is_full(nrf_queue_t const * p_queue)
+{
+    return (nrf_queue_next_idx(p_queue, p_queue->p_cb->back) ==
+            p_queue->p_cb->front);
+}
+
+
+bool nrf_queue_is_empty(nrf_queue_t const * p_queue)
+{
+    return (p_queue->p_cb->front == p_queue->p_cb->back);
+}
+
+
+size_t nrf_queue_utilization_get(nrf_queue_t const * p_queue)
+{
+    size_t utilization;
+
+    CRITICAL_REGION_ENTER();
+    utilization = queue_utilization_get(p_queue);
+    CRITICAL_REGION_EXIT();
+
+    return utilization;
+}
+
+
+size_t nrf_queue_available_get(nrf_queue_t const * p_queue)
+{
+    return p_queue->size - nrf_queue_utilization_get(p_queue);
+}
+
+
+size_t nrf_queue_max_utilization_get(nrf_queue_t const * p_queue)
+{
+    return p_queue->p_cb->max_utilization;
+}
+
+
+void nrf_queue_max_utilization_reset(nrf_queue_t const * p_queue)
+{
+    p_queue->p_cb->max_utilization = 0;
+}
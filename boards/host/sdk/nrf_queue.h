@@ -0,0 +1,114 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_queue.h
+ * @brief Host stand-in of the nRF5 SDK queue library.
+ */
+
+#ifndef NRF_QUEUE_H__
+#define NRF_QUEUE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+#include "app_util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    NRF_QUEUE_MODE_OVERFLOW,
+    NRF_QUEUE_MODE_NO_OVERFLOW,
+} nrf_queue_mode_t;
+
+typedef struct
+{
+    volatile size_t front;
+    volatile size_t back;
+    size_t          max_utilization;
+} nrf_queue_cb_t;
+
+typedef struct
+{
+    nrf_queue_cb_t * p_cb;
+    void           * p_buffer;
+    size_t           size;
+    size_t           element_size;
+    nrf_queue_mode_t mode;
+} nrf_queue_t;
+
+#define NRF_QUEUE_DEF(_type, _name, _size, _mode)                   \
+    static _type             CONCAT_2(_name, _nrf_queue_buffer[(_size) + 1]); \
+    static nrf_queue_cb_t    CONCAT_2(_name, _nrf_queue_cb);        \
+    static const nrf_queue_t _name =                                \
+        {                                                           \
+            .p_cb           = &CONCAT_2(_name, _nrf_queue_cb),      \
+            .p_buffer       = CONCAT_2(_name,_nrf_queue_buffer),    \
+            .size           = (_size),                              \
+            .element_size   = sizeof(_type),                        \
+            .mode           = _mode,                                \
+        }
+
+ret_code_t nrf_queue_push(nrf_queue_t const * p_queue, void const * p_element);
+
+ret_code_t nrf_queue_generic_pop(nrf_queue_t const * p_queue,
+                                 void              * p_element,
+                                 bool                just_peek);
+
+#define nrf_queue_pop(_p_queue, _p_element)     \
+    nrf_queue_generic_pop((_p_queue), (_p_element), false)
+
+#define nrf_queue_peek(_p_queue, _p_element)    \
+    nrf_queue_generic_pop((_p_queue), (_p_element), true)
+
+void nrf_queue_reset(nrf_queue_t const * p_queue);
+
+bool nrf_queue_is_full(nrf_queue_t const * p_queue);
+
+bool nrf_queue_is_empty(nrf_queue_t const * p_queue);
+
+size_t nrf_queue_utilization_get(nrf_queue_t const * p_queue);
+
+size_t nrf_queue_available_get(nrf_queue_t const * p_queue);
+
+size_t nrf_queue_max_utilization_get(nrf_queue_t const * p_queue);
+
+void nrf_queue_max_utilization_reset(nrf_queue_t const * p_queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_QUEUE_H__
@@ -0,0 +1,159 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_rng.c
+ * @brief Host stand-in of the RNG peripheral.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "nrf.h"
+#include "nrf_rng.h"
+#include "nrf_crypto_rng.h"
+#include "app_util_platform.h"
+#include "nrf_host.h"
+
+
+/** Time to generate a value, nRF52840 product specification. */
+#define RNG_VALUE_NS            30000
+#define RNG_VALUE_BC_NS         120000
+
+
+static struct
+{
+    bool     started;
+    bool     int_enabled;
+    bool     bias_correction;
+    bool     valrdy;
+    uint8_t  value;
+    uint64_t next_ns;           //!< Time of the next value, clock running.
+} m_rng;
+
+
+static uint64_t value_ns(void)
+{
+    return m_rng.bias_correction ? RNG_VALUE_BC_NS : RNG_VALUE_NS;
+}
+
+
+void host_rng_process(void)
+{
+    bool stopped = host_clock_is_stopped();
+    uint64_t now = host_clock_ns();
+
+    while(m_rng.started && !m_rng.valrdy &&
+          (stopped || m_rng.next_ns <= now))
+    {
+        if(nrf_crypto_rng_vector_generate(&m_rng.value, 1) != NRF_SUCCESS)
+        {
+            return;
+        }
+
+        m_rng.valrdy = true;
+        m_rng.next_ns += value_ns();
+
+        if(m_rng.int_enabled)
+        {
+            /* Runs the handler, which may read the value and come back. */
+            NVIC_SetPendingIRQ(RNG_IRQn);
+        }
+    }
+}
+
+
+void nrf_rng_task_trigger(nrf_rng_task_t task)
+{
+    switch(task)
+    {
+        case NRF_RNG_TASK_START:
+            if(!m_rng.started)
+            {
+                m_rng.started = true;
+                m_rng.next_ns = host_clock_ns() + value_ns();
+                host_rng_process();
+            }
+            break;
+
+        case NRF_RNG_TASK_STOP:
+            m_rng.started = false;
+            break;
+    }
+}
+
+
+void nrf_rng_event_clear(nrf_rng_event_t event)
+{
+    m_rng.valrdy = false;
+    host_rng_process();
+}
+
+
+bool nrf_rng_event_get(nrf_rng_event_t event)
+{
+    return m_rng.valrdy;
+}
+
+
+void nrf_rng_int_enable(uint32_t mask)
+{
+    if(mask & NRF_RNG_INT_VALRDY_MASK)
+    {
+        m_rng.int_enabled = true;
+    }
+}
+
+
+void nrf_rng_int_disable(uint32_t mask)
+{
+    if(mask & NRF_RNG_INT_VALRDY_MASK)
+    {
+        m_rng.int_enabled = false;
+    }
+}
+
+
+uint8_t nrf_rng_random_value_get(void)
+{
+    return m_rng.value;
+}
+
+
+void nrf_rng_error_correction_enable(void)
+{
+    m_rng.bias_correction = true;
+}
+
+
+void nrf_rng_error_correction_disable(void)
+{
+    m_rng.bias_correction = false;
+}
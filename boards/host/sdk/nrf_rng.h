@@ -0,0 +1,80 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file nrf_rng.h
+ * @brief Host stand-in of the nrfx RNG HAL.
+ *
+ * The random values come from the generator behind nrf_crypto_rng, one
+ * every 120 us of the host clock with bias correction, 30 us without, as
+ * on the nRF52840. When the clock is stopped, the next value is ready as
+ * soon as the last one is read, so that a replay draws the same numbers.
+ * See host_rng_process() in nrf_host.h.
+ */
+
+#ifndef NRF_RNG_H__
+#define NRF_RNG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "nrf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    NRF_RNG_TASK_START,
+    NRF_RNG_TASK_STOP,
+} nrf_rng_task_t;
+
+typedef enum
+{
+    NRF_RNG_EVENT_VALRDY,
+} nrf_rng_event_t;
+
+#define NRF_RNG_INT_VALRDY_MASK     (1UL << 0)
+
+void nrf_rng_task_trigger(nrf_rng_task_t task);
+void nrf_rng_event_clear(nrf_rng_event_t event);
+bool nrf_rng_event_get(nrf_rng_event_t event);
+void nrf_rng_int_enable(uint32_t mask);
+void nrf_rng_int_disable(uint32_t mask);
+uint8_t nrf_rng_random_value_get(void);
+void nrf_rng_error_correction_enable(void);
+void nrf_rng_error_correction_disable(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_RNG_H__
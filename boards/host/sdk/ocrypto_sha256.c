@@ -0,0 +1,64 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file ocrypto_sha256.c
+ * @brief Host stand-in of the SHA-256 of the Oberon library, over OpenSSL.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ocrypto_sha256.h"
+
+
+void ocrypto_sha256_init(ocrypto_sha256_ctx * ctx)
+{
+    SHA256_Init(&ctx->ctx);
+}
+
+
+void ocrypto_sha256_update(ocrypto_sha256_ctx * ctx, const uint8_t * in,
+                           size_t in_len)
+{
+    SHA256_Update(&ctx->ctx, in, in_len);
+}
+
+
+void ocrypto_sha256_final(ocrypto_sha256_ctx * ctx, uint8_t r[32])
+{
+    SHA256_Final(r, &ctx->ctx);
+}
+
+
+void ocrypto_sha256(uint8_t r[32], const uint8_t * in, size_t in_len)
+{
+    SHA256(in, in_len, r);
+}
@@ -0,0 +1,75 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file sdk_errors.h
+ * @brief Host stand-in of the nRF5 SDK error codes.
+ */
+
+#ifndef SDK_ERRORS_H__
+#define SDK_ERRORS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t ret_code_t;
+
+#define NRF_ERROR_BASE_NUM              (0x0)
+#define NRF_ERROR_SDK_COMMON_ERROR_BASE (NRF_ERROR_BASE_NUM + 0x8000)
+#define NRF_ERROR_CRYPTO_ERR_BASE       (0x8500)
+
+#define NRF_SUCCESS                     (NRF_ERROR_BASE_NUM + 0)
+#define NRF_ERROR_INTERNAL              (NRF_ERROR_BASE_NUM + 3)
+#define NRF_ERROR_NO_MEM                (NRF_ERROR_BASE_NUM + 4)
+#define NRF_ERROR_NOT_FOUND             (NRF_ERROR_BASE_NUM + 5)
+#define NRF_ERROR_NOT_SUPPORTED         (NRF_ERROR_BASE_NUM + 6)
+#define NRF_ERROR_INVALID_PARAM         (NRF_ERROR_BASE_NUM + 7)
+#define NRF_ERROR_INVALID_STATE         (NRF_ERROR_BASE_NUM + 8)
+#define NRF_ERROR_INVALID_LENGTH        (NRF_ERROR_BASE_NUM + 9)
+#define NRF_ERROR_INVALID_FLAGS         (NRF_ERROR_BASE_NUM + 10)
+#define NRF_ERROR_INVALID_DATA          (NRF_ERROR_BASE_NUM + 11)
+#define NRF_ERROR_DATA_SIZE             (NRF_ERROR_BASE_NUM + 12)
+#define NRF_ERROR_TIMEOUT               (NRF_ERROR_BASE_NUM + 13)
+#define NRF_ERROR_NULL                  (NRF_ERROR_BASE_NUM + 14)
+#define NRF_ERROR_FORBIDDEN             (NRF_ERROR_BASE_NUM + 15)
+#define NRF_ERROR_INVALID_ADDR          (NRF_ERROR_BASE_NUM + 16)
+#define NRF_ERROR_BUSY                  (NRF_ERROR_BASE_NUM + 17)
+#define NRF_ERROR_RESOURCES             (NRF_ERROR_BASE_NUM + 19)
+
+#define NRF_ERROR_MODULE_NOT_INITIALIZED    (NRF_ERROR_SDK_COMMON_ERROR_BASE + 0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SDK_ERRORS_H__
@@ -0,0 +1,333 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file u2f_crypto_host.c
+ * @brief u2f_crypto backend of the host build, over OpenSSL.
+ *
+ * Calls libcrypto directly, without the nrf_crypto stand-in, so that the
+ * backends can be told apart in the benchmarks of the host build.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <openssl/aes.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/sha.h>
+
+#include "nrf_crypto_error.h"
+
+#include "u2f_crypto.h"
+#include "u2f_crypto_backend.h"
+
+
+static EC_GROUP * m_p_group;
+
+
+static ret_code_t host_init(void)
+{
+    if(m_p_group == NULL)
+    {
+        m_p_group = EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1);
+    }
+
+    return (m_p_group != NULL) ? NRF_SUCCESS : NRF_ERROR_CRYPTO_INTERNAL;
+}
+
+
+static ret_code_t host_keygen(uint8_t * p_private_key, uint8_t * p_public_key)
+{
+    uint8_t point[U2F_CRYPTO_PUBLIC_KEY_SIZE + 1];
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    EC_KEY * p_key = EC_KEY_new();
+
+    if(p_key != NULL &&
+       EC_KEY_set_group(p_key, m_p_group) == 1 &&
+       EC_KEY_generate_key(p_key) == 1 &&
+       BN_bn2binpad(EC_KEY_get0_private_key(p_key), p_private_key,
+                    U2F_CRYPTO_PRIVATE_KEY_SIZE) == U2F_CRYPTO_PRIVATE_KEY_SIZE &&
+       EC_POINT_point2oct(m_p_group, EC_KEY_get0_public_key(p_key),
+                          POINT_CONVERSION_UNCOMPRESSED, point, sizeof(point),
+                          NULL) == sizeof(point))
+    {
+        memcpy(p_public_key, &point[1], U2F_CRYPTO_PUBLIC_KEY_SIZE);
+        ret = NRF_SUCCESS;
+    }
+
+    EC_KEY_free(p_key);
+
+    return ret;
+}
+
+
+static ret_code_t host_public_key(uint8_t const * p_private_key,
+                                  uint8_t * p_public_key)
+{
+    uint8_t point[U2F_CRYPTO_PUBLIC_KEY_SIZE + 1];
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    BIGNUM * p_d = BN_bin2bn(p_private_key, U2F_CRYPTO_PRIVATE_KEY_SIZE, NULL);
+    EC_POINT * p_point = EC_POINT_new(m_p_group);
+
+    if(p_d == NULL || p_point == NULL)
+    {
+        ret = NRF_ERROR_CRYPTO_INTERNAL;
+    }
+    else if(BN_is_zero(p_d) || BN_cmp(p_d, EC_GROUP_get0_order(m_p_group)) >= 0)
+    {
+        ret = NRF_ERROR_CRYPTO_ECC_INVALID_KEY;
+    }
+    else if(EC_POINT_mul(m_p_group, p_point, p_d, NULL, NULL, NULL) == 1 &&
+            EC_POINT_point2oct(m_p_group, p_point, POINT_CONVERSION_UNCOMPRESSED,
+                               point, sizeof(point), NULL) == sizeof(point))
+    {
+        memcpy(p_public_key, &point[1], U2F_CRYPTO_PUBLIC_KEY_SIZE);
+        ret = NRF_SUCCESS;
+    }
+
+    EC_POINT_free(p_point);
+    BN_clear_free(p_d);
+
+    return ret;
+}
+
+
+static ret_code_t host_sign(uint8_t const * p_private_key,
+                            uint8_t const * p_hash,
+                            uint8_t * p_signature)
+{
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    EC_KEY * p_key = EC_KEY_new();
+    BIGNUM * p_d = BN_bin2bn(p_private_key, U2F_CRYPTO_PRIVATE_KEY_SIZE, NULL);
+    ECDSA_SIG * p_sig = NULL;
+
+    if(p_key != NULL && p_d != NULL &&
+       EC_KEY_set_group(p_key, m_p_group) == 1 &&
+       EC_KEY_set_private_key(p_key, p_d) == 1)
+    {
+        p_sig = ECDSA_do_sign(p_hash, U2F_CRYPTO_HASH_SIZE, p_key);
+    }
+
+    if(p_sig != NULL &&
+       BN_bn2binpad(ECDSA_SIG_get0_r(p_sig), p_signature, 32) == 32 &&
+       BN_bn2binpad(ECDSA_SIG_get0_s(p_sig), p_signature + 32, 32) == 32)
+    {
+        ret = NRF_SUCCESS;
+    }
+
+    ECDSA_SIG_free(p_sig);
+    BN_clear_free(p_d);
+    EC_KEY_free(p_key);
+
+    return ret;
+}
+
+
+static ret_code_t host_eddsa_public_key(uint8_t const * p_private_key,
+                                        uint8_t * p_public_key)
+{
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    size_t len = U2F_CRYPTO_ED25519_PUBLIC_KEY_SIZE;
+    EVP_PKEY * p_key = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL,
+                                      p_private_key, U2F_CRYPTO_PRIVATE_KEY_SIZE);
+
+    if(p_key != NULL &&
+       EVP_PKEY_get_raw_public_key(p_key, p_public_key, &len) == 1 &&
+       len == U2F_CRYPTO_ED25519_PUBLIC_KEY_SIZE)
+    {
+        ret = NRF_SUCCESS;
+    }
+
+    EVP_PKEY_free(p_key);
+
+    return ret;
+}
+
+
+static ret_code_t host_eddsa_sign(uint8_t const * p_private_key,
+                                  uint8_t const * p_message, size_t size,
+                                  uint8_t * p_signature)
+{
+    ret_code_t ret = NRF_ERROR_CRYPTO_INTERNAL;
+    size_t len = U2F_CRYPTO_ED25519_SIGNATURE_SIZE;
+    EVP_MD_CTX * p_ctx = EVP_MD_CTX_new();
+    EVP_PKEY * p_key = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL,
+                                      p_private_key, U2F_CRYPTO_PRIVATE_KEY_SIZE);
+
+    if(p_ctx != NULL && p_key != NULL &&
+       EVP_DigestSignInit(p_ctx, NULL, NULL, NULL, p_key) == 1 &&
+       EVP_DigestSign(p_ctx, p_signature, &len, p_message, size) == 1 &&
+       len == U2F_CRYPTO_ED25519_SIGNATURE_SIZE)
+    {
+        ret = NRF_SUCCESS;
+    }
+
+    EVP_PKEY_free(p_key);
+    EVP_MD_CTX_free(p_ctx);
+
+    return ret;
+}
+
+
+static ret_code_t host_hash(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                            uint8_t * p_digest)
+{
+    SHA256_CTX ctx;
+
+    SHA256_Init(&ctx);
+    for(size_t i = 0; i < count; i++)
+    {
+        SHA256_Update(&ctx, p_chunks[i].p_data, p_chunks[i].size);
+    }
+    SHA256_Final(p_digest, &ctx);
+
+    return NRF_SUCCESS;
+}
+
+
+/**
+ * @brief Expanded wrapping key, kept across requests.
+ */
+static AES_KEY m_wrap_key;
+static AES_KEY m_unwrap_key;
+static bool m_wrap_key_loaded;
+
+/**
+ * @brief HMAC states after the inner and outer padded key.
+ */
+static SHA256_CTX m_mac_inner;
+static SHA256_CTX m_mac_outer;
+
+
+static ret_code_t host_wrap_key_set(uint8_t const * p_key,
+                                    uint8_t const * p_mac_key)
+{
+    m_wrap_key_loaded = false;
+
+    if(AES_set_encrypt_key(p_key, 128, &m_wrap_key) != 0 ||
+       AES_set_decrypt_key(p_key, 128, &m_unwrap_key) != 0)
+    {
+        return NRF_ERROR_CRYPTO_INTERNAL;
+    }
+
+    uint8_t pad[SHA256_CBLOCK];
+
+    memset(pad, 0x36, sizeof(pad));
+    for(size_t i = 0; i < U2F_CRYPTO_MAC_KEY_SIZE; i++) pad[i] ^= p_mac_key[i];
+    SHA256_Init(&m_mac_inner);
+    SHA256_Update(&m_mac_inner, pad, sizeof(pad));
+
+    memset(pad, 0x5c, sizeof(pad));
+    for(size_t i = 0; i < U2F_CRYPTO_MAC_KEY_SIZE; i++) pad[i] ^= p_mac_key[i];
+    SHA256_Init(&m_mac_outer);
+    SHA256_Update(&m_mac_outer, pad, sizeof(pad));
+
+    memset(pad, 0, sizeof(pad));
+
+    m_wrap_key_loaded = true;
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t host_aes_ecb(int enc, AES_KEY const * p_key,
+                               uint8_t const * p_in, uint8_t * p_out,
+                               size_t size)
+{
+    if(!m_wrap_key_loaded) return NRF_ERROR_INVALID_STATE;
+
+    for(size_t i = 0; i < size; i += U2F_CRYPTO_WRAP_BLOCK_SIZE)
+    {
+        AES_ecb_encrypt(p_in + i, p_out + i, p_key, enc);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t host_wrap(uint8_t const * p_in, uint8_t * p_out, size_t size)
+{
+    return host_aes_ecb(AES_ENCRYPT, &m_wrap_key, p_in, p_out, size);
+}
+
+
+static ret_code_t host_unwrap(uint8_t const * p_in, uint8_t * p_out, size_t size)
+{
+    return host_aes_ecb(AES_DECRYPT, &m_unwrap_key, p_in, p_out, size);
+}
+
+
+static ret_code_t host_mac(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                           uint8_t * p_mac)
+{
+    SHA256_CTX ctx;
+    uint8_t inner[SHA256_DIGEST_LENGTH];
+
+    if(!m_wrap_key_loaded) return NRF_ERROR_INVALID_STATE;
+
+    ctx = m_mac_inner;
+    for(size_t i = 0; i < count; i++)
+    {
+        SHA256_Update(&ctx, p_chunks[i].p_data, p_chunks[i].size);
+    }
+    SHA256_Final(inner, &ctx);
+
+    ctx = m_mac_outer;
+    SHA256_Update(&ctx, inner, sizeof(inner));
+    SHA256_Final(p_mac, &ctx);
+
+    return NRF_SUCCESS;
+}
+
+
+u2f_crypto_backend_t const g_u2f_crypto_host =
+{
+    .p_name = "host",
+    .init   = host_init,
+    .keygen = host_keygen,
+    .sign   = host_sign,
+
+    .public_key = host_public_key,
+    .hash   = host_hash,
+
+    .wrap_key_set = host_wrap_key_set,
+    .wrap         = host_wrap,
+    .unwrap       = host_unwrap,
+    .mac          = host_mac,
+
+    .eddsa_public_key = host_eddsa_public_key,
+    .eddsa_sign       = host_eddsa_sign,
+};
@@ -5648,6 +5648,260 @@
 // </h> 
 //==========================================================
 
+// <h> nRF_U2F 
+
+// <i> Compile-time log ceilings of the U2F modules. Logs above the level
+// <i> are not compiled in. Release builds (make RELEASE=1) lower them to
+// <i> Warning, which removes the per-command logs from the hot path.
+//==========================================================
+// <e> U2F_HID_CONFIG_LOG_ENABLED - Enables logging in u2f_hid - U2FHID frame layer and channels.
+//==========================================================
+#ifndef U2F_HID_CONFIG_LOG_ENABLED
+#define U2F_HID_CONFIG_LOG_ENABLED 1
+#endif
+// <o> U2F_HID_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef U2F_HID_CONFIG_LOG_LEVEL
+#define U2F_HID_CONFIG_LOG_LEVEL 3
+#endif
+
+// </e>
+
+// <e> U2F_HID_IF_CONFIG_LOG_ENABLED - Enables logging in u2f_hid_if - USB HID transport.
+//==========================================================
+#ifndef U2F_HID_IF_CONFIG_LOG_ENABLED
+#define U2F_HID_IF_CONFIG_LOG_ENABLED 1
+#endif
+// <o> U2F_HID_IF_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef U2F_HID_IF_CONFIG_LOG_LEVEL
+#define U2F_HID_IF_CONFIG_LOG_LEVEL 3
+#endif
+
+// </e>
+
+// <e> U2F_IMPL_CONFIG_LOG_ENABLED - Enables logging in u2f_impl - U2F register and authenticate.
+//==========================================================
+#ifndef U2F_IMPL_CONFIG_LOG_ENABLED
+#define U2F_IMPL_CONFIG_LOG_ENABLED 1
+#endif
+// <o> U2F_IMPL_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef U2F_IMPL_CONFIG_LOG_LEVEL
+#define U2F_IMPL_CONFIG_LOG_LEVEL 3
+#endif
+
+// </e>
+
+// <e> U2F_WORKER_CONFIG_LOG_ENABLED - Enables logging in u2f_worker - crypto worker.
+//==========================================================
+#ifndef U2F_WORKER_CONFIG_LOG_ENABLED
+#define U2F_WORKER_CONFIG_LOG_ENABLED 1
+#endif
+// <o> U2F_WORKER_CONFIG_LOG_LEVEL  - Default Severity level
+ 
+// <0=> Off 
+// <1=> Error 
+// <2=> Warning 
+// <3=> Info 
+// <4=> Debug 
+
+#ifndef U2F_WORKER_CONFIG_LOG_LEVEL
+#define U2F_WORKER_CONFIG_LOG_LEVEL 3
+#endif
+
+// </e>
+
+// <h> u2f_crypto - Crypto backends of the U2F operations
+
+// <i> The backends built in. The backend of each operation can be
+// <i> changed at run time with the crypto select command of the CLI.
+//==========================================================
+// <q> U2F_CRYPTO_CC310_ENABLED  - CryptoCell CC310, through nrf_crypto.
+ 
+
+#ifndef U2F_CRYPTO_CC310_ENABLED
+#define U2F_CRYPTO_CC310_ENABLED 1
+#endif
+
+// <q> U2F_CRYPTO_MICRO_ECC_ENABLED  - micro-ecc, key generation and signing only.
+ 
+
+#ifndef U2F_CRYPTO_MICRO_ECC_ENABLED
+#define U2F_CRYPTO_MICRO_ECC_ENABLED 1
+#endif
+
+// <q> U2F_CRYPTO_HOST_ENABLED  - OpenSSL, host build only.
+ 
+
+#ifndef U2F_CRYPTO_HOST_ENABLED
+#define U2F_CRYPTO_HOST_ENABLED 0
+#endif
+
+// <q> U2F_CRYPTO_COMB_ENABLED  - Software, fixed-base comb table in flash, key generation and signing only.
+ 
+
+#ifndef U2F_CRYPTO_COMB_ENABLED
+#define U2F_CRYPTO_COMB_ENABLED 1
+#endif
+
+// <q> U2F_CRYPTO_OBERON_ENABLED  - Oberon library, hashing only.
+ 
+
+#ifndef U2F_CRYPTO_OBERON_ENABLED
+#define U2F_CRYPTO_OBERON_ENABLED 1
+#endif
+
+// <o> U2F_CRYPTO_COMB_NONCE_POOL_SIZE - ECDSA nonces precomputed while idle by the comb backend  <0-32> 
+
+// <i> Used when the comb backend signs. 0 computes each nonce when signing.
+
+#ifndef U2F_CRYPTO_COMB_NONCE_POOL_SIZE
+#define U2F_CRYPTO_COMB_NONCE_POOL_SIZE 4
+#endif
+
+// <o> U2F_CRYPTO_CONFIG_KEYGEN_BACKEND  - Backend of the key pair generation
+ 
+// <0=> CC310 
+// <1=> micro-ecc 
+// <2=> Host 
+// <3=> Comb 
+// <4=> Oberon 
+
+#ifndef U2F_CRYPTO_CONFIG_KEYGEN_BACKEND
+#define U2F_CRYPTO_CONFIG_KEYGEN_BACKEND 0
+#endif
+
+// <o> U2F_CRYPTO_CONFIG_SIGN_BACKEND  - Backend of the signatures
+ 
+// <0=> CC310 
+// <1=> micro-ecc 
+// <2=> Host 
+// <3=> Comb 
+// <4=> Oberon 
+
+#ifndef U2F_CRYPTO_CONFIG_SIGN_BACKEND
+#define U2F_CRYPTO_CONFIG_SIGN_BACKEND 0
+#endif
+
+// <o> U2F_CRYPTO_CONFIG_HASH_BACKEND  - Backend of SHA-256
+ 
+// <0=> CC310 
+// <1=> micro-ecc 
+// <2=> Host 
+// <3=> Comb 
+// <4=> Oberon 
+
+#ifndef U2F_CRYPTO_CONFIG_HASH_BACKEND
+#define U2F_CRYPTO_CONFIG_HASH_BACKEND 0
+#endif
+
+// <o> U2F_CRYPTO_CONFIG_WRAP_BACKEND  - Backend of the key handle wrap and unwrap
+ 
+// <0=> CC310 
+// <1=> micro-ecc 
+// <2=> Host 
+// <3=> Comb 
+// <4=> Oberon 
+
+#ifndef U2F_CRYPTO_CONFIG_WRAP_BACKEND
+#define U2F_CRYPTO_CONFIG_WRAP_BACKEND 0
+#endif
+
+// <o> U2F_CRYPTO_CONFIG_EDDSA_BACKEND  - Backend of the Ed25519 credentials
+ 
+// <0=> CC310 
+// <1=> micro-ecc 
+// <2=> Host 
+// <3=> Comb 
+// <4=> Oberon 
+
+// <i> Ed25519 needs NRF_CRYPTO_BACKEND_CC310_ECC_ED25519_ENABLED with CC310.
+// <i> Without a backend, the credentials are ES256 only.
+
+#ifndef U2F_CRYPTO_CONFIG_EDDSA_BACKEND
+#define U2F_CRYPTO_CONFIG_EDDSA_BACKEND 0
+#endif
+
+// <o> U2F_CRYPTO_HASH_SW_THRESHOLD - Hashes shorter than this go to Oberon, in bytes  <0-1024> 
+
+// <i> Whatever the backend of SHA-256, as Oberon is faster on short
+// <i> inputs than a CC310 operation. 0 times both at startup to pick it.
+
+#ifndef U2F_CRYPTO_HASH_SW_THRESHOLD
+#define U2F_CRYPTO_HASH_SW_THRESHOLD 0
+#endif
+
+// <e> U2F_ENTROPY_ENABLED - Entropy pool, refilled by the RNG interrupt
+ 
+// <i> Random bytes drawn by the U2F code, for the keys and nonces of the
+// <i> software backends and the AES key, come from the pool when it holds
+// <i> enough, else from nrf_crypto. CC310 draws its own.
+//==========================================================
+#ifndef U2F_ENTROPY_ENABLED
+#define U2F_ENTROPY_ENABLED 1
+#endif
+// <o> U2F_ENTROPY_POOL_SIZE - Bytes of the pool  <32-1024> 
+
+
+#ifndef U2F_ENTROPY_POOL_SIZE
+#define U2F_ENTROPY_POOL_SIZE 128
+#endif
+
+// </e>
+
+// <e> U2F_POWER_ENABLED - CryptoCell power manager
+ 
+// <i> Holds the CryptoCell on from the first frame of a U2FHID_INIT or
+// <i> U2FHID_MSG, so that it powers up during the frame reassembly, and
+// <i> releases it after an idle period. Only when an operation uses CC310.
+//==========================================================
+#ifndef U2F_POWER_ENABLED
+#define U2F_POWER_ENABLED 1
+#endif
+// <o> U2F_POWER_CC310_IDLE_MS - Idle period before a power down, in ms  <1-60000> 
+
+
+#ifndef U2F_POWER_CC310_IDLE_MS
+#define U2F_POWER_CC310_IDLE_MS 1000
+#endif
+
+// </e>
+
+// <o> U2F_KEY_HANDLE_SCHEME  - Key handles of new registrations
+ 
+// <i> The handles of both schemes are accepted whichever is selected.
+// <0=> AES: private key and appId, encrypted (64 bytes) 
+// <1=> HMAC: nonce and tag, the private key derived (65 bytes) 
+
+#ifndef U2F_KEY_HANDLE_SCHEME
+#define U2F_KEY_HANDLE_SCHEME 0
+#endif
+
+// </h> 
+//==========================================================
+
+// </h> 
+//==========================================================
+
 // <<< end of configuration section >>>
 #endif //SDK_CONFIG_H
 
@@ -0,0 +1,145 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#ifndef __TIMER_HEAP_H_
+#define __TIMER_HEAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timer_heap.h
+ * @brief Binary min-heap of timer deadlines.
+ *
+ * Keeps the armed timers ordered by deadline so that only the timers that
+ * actually expire are visited, and the next deadline is known in O(1).
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Index of a node that is not in any heap.
+ */
+#define TIMER_HEAP_INVALID_INDEX    0xFFFF
+
+/**
+ * @brief Timer node, to be embedded in the structure owning the timer.
+ */
+typedef struct timer_heap_node {
+	uint64_t deadline;	/**< Expiration time in milliseconds. */
+	uint16_t index;		/**< Position in the heap. */
+} timer_heap_node_t;
+
+/**
+ * @brief Timer heap.
+ */
+typedef struct timer_heap {
+	timer_heap_node_t **pp_nodes;	/**< Storage for the node pointers. */
+	uint16_t count;					/**< Number of armed timers. */
+	uint16_t capacity;				/**< Size of the storage. */
+} timer_heap_t;
+
+/**
+ * @brief Define a timer heap.
+ *
+ * @param name - name of the heap
+ * @param size - maximum number of armed timers
+ */
+#define TIMER_HEAP_DEF(name, size)                      \
+	static timer_heap_node_t * name##_nodes[size];      \
+	static timer_heap_t name = {                        \
+		.pp_nodes = name##_nodes,                       \
+		.count    = 0,                                  \
+		.capacity = size,                               \
+	}
+
+/**
+ * @brief Initialize a timer node
+ *
+ * @param timer_heap_node_t - pointer to the node to be initialized
+ */
+void timer_heap_node_init(timer_heap_node_t *);
+
+/**
+ * @brief Check if a timer node is armed
+ *
+ * @param timer_heap_node_t - pointer to the node
+ * @return bool - true = the node is in a heap
+ */
+bool timer_heap_node_is_armed(timer_heap_node_t const *);
+
+/**
+ * @brief Arm a timer
+ *
+ * Inserts the node with the given absolute deadline. A node that is 
+ * already armed is moved to its new position.
+ *
+ * @param timer_heap_t - pointer to the heap
+ * @param timer_heap_node_t - pointer to the node
+ * @param uint64_t - deadline in milliseconds
+ * @return bool - false if the heap is full
+ */
+bool timer_heap_insert(timer_heap_t *, timer_heap_node_t *, uint64_t);
+
+/**
+ * @brief Disarm a timer
+ *
+ * Removing a node that is not armed has no effect.
+ *
+ * @param timer_heap_t - pointer to the heap
+ * @param timer_heap_node_t - pointer to the node
+ */
+void timer_heap_remove(timer_heap_t *, timer_heap_node_t *);
+
+/**
+ * @brief Get the timer with the earliest deadline
+ *
+ * @param timer_heap_t - pointer to the heap
+ * @return timer_heap_node_t - earliest node, NULL if the heap is empty
+ */
+timer_heap_node_t * timer_heap_peek(timer_heap_t *);
+
+/**
+ * @brief Take one expired timer out of the heap
+ *
+ * Call repeatedly until it returns NULL to collect every expired timer.
+ *
+ * @param timer_heap_t - pointer to the heap
+ * @param uint64_t - current time in milliseconds
+ * @return timer_heap_node_t - expired node, NULL if none
+ */
+timer_heap_node_t * timer_heap_pop_expired(timer_heap_t *, uint64_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMER_HEAP_H_ */
@@ -94,6 +94,15 @@ void countdown_sec(Timer *, uint32_t);
  */
 uint32_t left_ms(Timer *);
 
+/**
+ * @brief Get the current time
+ *
+ * Returns the tick source in milliseconds, used as time base by the timers.
+ *
+ * @return uint64_t - current time in milliseconds, never wraps
+ */
+uint64_t current_time_ms(void);
+
 /**
  * @brief Initialize a timer
  *
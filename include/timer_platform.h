@@ -39,16 +39,26 @@ extern "C" {
  * @file timer_platform.h
  */
 #include <stdint.h>
+#include "sdk_errors.h"
 #include "timer_interface.h"
 
 /**
  * definition of the Timer struct. Platform specific
  */
 struct Timer {
-	uint32_t end_time;
-	uint32_t offset;
+	uint64_t end_time;
 };
 
+/**
+ * @brief Initialize the time base
+ *
+ * Starts the 64-bit millisecond clock derived from the app_timer RTC. 
+ * Must be called after app_timer_init().
+ *
+ * @return ret_code_t - NRF_SUCCESS on success
+ */
+ret_code_t timer_platform_init(void);
+
 #ifdef __cplusplus
 }
 #endif
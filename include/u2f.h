@@ -35,6 +35,7 @@ extern "C" {
 // EC (uncompressed) point
 
 #define U2F_POINT_UNCOMPRESSED  0x04    // Uncompressed point format
+#define U2F_POINT_ED25519       0x40    // Ed25519 public key in x, y zero
 
 typedef struct __attribute__ ((__packed__)) {
     uint8_t pointFormat;                // Point type
@@ -53,6 +54,8 @@ typedef struct __attribute__ ((__packed__)) {
 #define U2F_VENDOR_FIRST        0xc0    // First vendor defined command
 #define U2F_VENDOR_LAST         0xff    // Last vendor defined command
 
+#define U2F_VENDOR_REGISTER_ALG (U2F_VENDOR_FIRST + 0) // Registration with the algorithm in P2
+
 // U2F_CMD_REGISTER command defines
 
 #define U2F_REGISTER_ID         0x05    // Version 2 registration identifier
@@ -121,6 +124,16 @@ typedef struct __attribute__ ((__packed__)) {
 uint32_t u2f_impl_init(void);
 
 
+/**
+ * @brief Reclaim the flash of the old counters, from the main loop.
+ *
+ * Starts a garbage collection once enough records are dirty, or once a
+ * counter update found the flash full, so that AUTHENTICATE does not have
+ * to wait for one.
+ */
+void u2f_impl_process(void);
+
+
 /**
  * @brief Register U2F Key.
  *
@@ -136,6 +149,25 @@ uint16_t u2f_register(U2F_REGISTER_REQ * p_req, U2F_REGISTER_RESP * p_resp,
                       int flags, uint16_t * p_resp_len);
 
 
+/**
+ * @brief Register U2F Key of an algorithm.
+ *
+ * An Ed25519 public key is returned with @ref U2F_POINT_ED25519, and its
+ * key handle signs Ed25519 in u2f_authenticate(). The attestation signature
+ * remains ECDSA.
+ *
+ * @param[in] p_req          Registration Request Message.
+ * @param[out] p_resp        Registration Response Message.
+ * @param[in] flags          Request Parameter.
+ * @param[in] alg            A u2f_crypto_alg_t.
+ * @param[out] p_resp_len    Registration Response Message length
+ *
+ * @return Standard error code.
+ */
+uint16_t u2f_register_alg(U2F_REGISTER_REQ * p_req, U2F_REGISTER_RESP * p_resp,
+                          int flags, int alg, uint16_t * p_resp_len);
+
+
 /**
  * @brief U2F Key Authentication.
  *
@@ -0,0 +1,390 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_CRYPTO_H__
+#define U2F_CRYPTO_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sizes of the P-256 keys and signatures, raw big endian encoding.
+ */
+#define U2F_CRYPTO_PRIVATE_KEY_SIZE     32      // Scalar
+#define U2F_CRYPTO_PUBLIC_KEY_SIZE      64      // X and Y
+#define U2F_CRYPTO_SIGNATURE_SIZE       64      // R and S
+#define U2F_CRYPTO_HASH_SIZE            32      // SHA-256 digest
+#define U2F_CRYPTO_WRAP_KEY_SIZE        16      // AES-128 key
+#define U2F_CRYPTO_WRAP_BLOCK_SIZE      16      // AES block
+#define U2F_CRYPTO_MAC_SIZE             32      // HMAC-SHA256
+#define U2F_CRYPTO_MAC_KEY_SIZE         32      // HMAC-SHA256 key
+#define U2F_CRYPTO_ED25519_PUBLIC_KEY_SIZE  32  // Ed25519, RFC 8032 encoding
+#define U2F_CRYPTO_ED25519_SIGNATURE_SIZE   64  // Ed25519, R | S
+
+/**
+ * @brief Signatures of a u2f_crypto_sign_batch() call, at most.
+ */
+#define U2F_CRYPTO_SIGN_BATCH_MAX       8
+
+
+/**
+ * @brief Operations, each routed to a backend of its own.
+ */
+typedef enum
+{
+    U2F_CRYPTO_OP_KEYGEN,           //!< P-256 key pair generation.
+    U2F_CRYPTO_OP_SIGN,             //!< ECDSA P-256 signature of a hash.
+    U2F_CRYPTO_OP_HASH,             //!< SHA-256.
+    U2F_CRYPTO_OP_WRAP,             //!< Key handle AES-128 ECB wrap and unwrap, and HMAC-SHA256.
+    U2F_CRYPTO_OP_EDDSA,            //!< Ed25519 public key and signature, optional.
+    U2F_CRYPTO_OP_COUNT
+} u2f_crypto_op_t;
+
+
+/**
+ * @brief Signature algorithms of the credentials.
+ *
+ * The private keys are @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes for both:
+ * the scalar for ES256, the seed of RFC 8032 for Ed25519.
+ */
+typedef enum
+{
+    U2F_CRYPTO_ALG_ES256,           //!< ECDSA P-256 with SHA-256, COSE -7.
+    U2F_CRYPTO_ALG_ED25519,         //!< EdDSA Ed25519, COSE -8.
+    U2F_CRYPTO_ALG_COUNT
+} u2f_crypto_alg_t;
+
+
+/**
+ * @brief Backends, built in when enabled in sdk_config.h.
+ */
+typedef enum
+{
+    U2F_CRYPTO_BACKEND_CC310,       //!< CryptoCell CC310, through nrf_crypto.
+    U2F_CRYPTO_BACKEND_MICRO_ECC,   //!< micro-ecc, key generation and signing only.
+    U2F_CRYPTO_BACKEND_HOST,        //!< Software library of the host build.
+    U2F_CRYPTO_BACKEND_COMB,        //!< Software, fixed-base comb, key generation and signing only.
+    U2F_CRYPTO_BACKEND_OBERON,      //!< Oberon library, hashing only.
+    U2F_CRYPTO_BACKEND_COUNT
+} u2f_crypto_backend_id_t;
+
+
+/**
+ * @brief A signature of u2f_crypto_sign_batch().
+ */
+typedef struct
+{
+    uint8_t const * p_private_key;  //!< @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes.
+    uint8_t const * p_hash;         //!< @ref U2F_CRYPTO_HASH_SIZE bytes.
+    uint8_t *       p_signature;    //!< @ref U2F_CRYPTO_SIGNATURE_SIZE bytes, out.
+} u2f_crypto_sign_req_t;
+
+
+/**
+ * @brief Part of the data to hash.
+ */
+typedef struct
+{
+    uint8_t const * p_data;
+    size_t          size;
+} u2f_crypto_chunk_t;
+
+
+/**
+ * @brief Function for initializing the crypto backends.
+ *
+ * Initializes nrf_crypto, which also provides the random numbers, and the
+ * entropy pool, then the backends, and routes each operation to its
+ * U2F_CRYPTO_CONFIG_*_BACKEND.
+ *
+ */
+ret_code_t u2f_crypto_init(void);
+
+
+/**
+ * @brief Do the idle work of the backends, from the main loop.
+ *
+ * The comb backend precomputes ECDSA nonces, one per call, when it signs.
+ *
+ * @retval true   Work was done, call again before sleeping.
+ * @retval false  Nothing to do.
+ */
+bool u2f_crypto_process(void);
+
+
+/**
+ * @brief Draw random bytes.
+ *
+ * From the entropy pool when it holds enough, else from nrf_crypto.
+ *
+ * @param[out] p_out          Random bytes.
+ * @param[in]  size           Number of bytes.
+ */
+ret_code_t u2f_crypto_random(uint8_t * p_out, size_t size);
+
+
+/**
+ * @brief Route an operation to a backend.
+ *
+ * Takes effect from the next call of the operation.
+ *
+ * @retval NRF_SUCCESS              Routed.
+ * @retval NRF_ERROR_INVALID_PARAM  Unknown operation or backend.
+ * @retval NRF_ERROR_NOT_SUPPORTED  Backend not built in, or without the operation.
+ */
+ret_code_t u2f_crypto_backend_select(u2f_crypto_op_t op,
+                                     u2f_crypto_backend_id_t backend);
+
+
+/**
+ * @brief Get the backend an operation is routed to.
+ */
+u2f_crypto_backend_id_t u2f_crypto_backend_get(u2f_crypto_op_t op);
+
+
+/**
+ * @brief Get the name of a backend, e.g. "cc310".
+ */
+char const * u2f_crypto_backend_name(u2f_crypto_backend_id_t backend);
+
+
+/**
+ * @brief Generate a P-256 key pair.
+ *
+ * @param[out] p_private_key  @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes.
+ * @param[out] p_public_key   @ref U2F_CRYPTO_PUBLIC_KEY_SIZE bytes.
+ */
+ret_code_t u2f_crypto_keygen(uint8_t * p_private_key, uint8_t * p_public_key);
+
+
+/**
+ * @brief Compute the P-256 public key of a private key, with the key
+ *        generation backend.
+ *
+ * @param[in]  p_private_key  @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes.
+ * @param[out] p_public_key   @ref U2F_CRYPTO_PUBLIC_KEY_SIZE bytes.
+ *
+ * @retval NRF_ERROR_CRYPTO_ECC_INVALID_KEY  The key is not in [1, n - 1].
+ * @retval NRF_ERROR_NOT_SUPPORTED           The backend cannot.
+ */
+ret_code_t u2f_crypto_public_key(uint8_t const * p_private_key,
+                                 uint8_t * p_public_key);
+
+
+/**
+ * @brief Sign a SHA-256 hash with ECDSA P-256.
+ *
+ * @param[in]  p_private_key  @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes.
+ * @param[in]  p_hash         @ref U2F_CRYPTO_HASH_SIZE bytes.
+ * @param[out] p_signature    @ref U2F_CRYPTO_SIGNATURE_SIZE bytes.
+ */
+ret_code_t u2f_crypto_sign(uint8_t const * p_private_key,
+                           uint8_t const * p_hash,
+                           uint8_t * p_signature);
+
+
+/**
+ * @brief Sign several SHA-256 hashes with ECDSA P-256, with the sign backend.
+ *
+ * The comb backend draws a nonce per signature and shares the modular
+ * inversions of the batch (Montgomery's trick): one inversion mod p for
+ * the points and one mod n for the nonces, rather than two per
+ * signature. It does not take nonces of the idle pool, which is kept for
+ * the single signatures. The other backends sign one after the other.
+ *
+ * @param[in]  p_reqs         Keys, hashes and signatures.
+ * @param[in]  count          1 to @ref U2F_CRYPTO_SIGN_BATCH_MAX.
+ *
+ * @retval NRF_ERROR_INVALID_LENGTH  @p count is out of range.
+ */
+ret_code_t u2f_crypto_sign_batch(u2f_crypto_sign_req_t const * p_reqs,
+                                 size_t count);
+
+
+/**
+ * @brief Generate a key pair of an algorithm.
+ *
+ * ES256 goes to u2f_crypto_keygen(). An Ed25519 key is a random seed,
+ * whose public key is computed by the EdDSA backend.
+ *
+ * @param[in]  alg            Algorithm.
+ * @param[out] p_private_key  @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes.
+ * @param[out] p_public_key   @ref U2F_CRYPTO_PUBLIC_KEY_SIZE bytes for
+ *                            ES256, @ref U2F_CRYPTO_ED25519_PUBLIC_KEY_SIZE
+ *                            for Ed25519.
+ *
+ * @retval NRF_ERROR_NOT_SUPPORTED  No backend provides the algorithm.
+ */
+ret_code_t u2f_crypto_alg_keygen(u2f_crypto_alg_t alg, uint8_t * p_private_key,
+                                 uint8_t * p_public_key);
+
+
+/**
+ * @brief Compute the public key of a private key of an algorithm.
+ *
+ * @retval NRF_ERROR_CRYPTO_ECC_INVALID_KEY  An ES256 key not in [1, n - 1].
+ * @retval NRF_ERROR_NOT_SUPPORTED           No backend provides it.
+ */
+ret_code_t u2f_crypto_alg_public_key(u2f_crypto_alg_t alg,
+                                     uint8_t const * p_private_key,
+                                     uint8_t * p_public_key);
+
+
+/**
+ * @brief Sign a message with an algorithm.
+ *
+ * ES256 hashes the message with u2f_crypto_hash() and signs the hash with
+ * u2f_crypto_sign(). Ed25519 signs the message itself (PureEdDSA), with
+ * the EdDSA backend.
+ *
+ * @param[in]  alg            Algorithm.
+ * @param[in]  p_private_key  @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes.
+ * @param[in]  p_message      Message, which may not overlap the signature.
+ * @param[in]  size           Message size.
+ * @param[out] p_signature    @ref U2F_CRYPTO_SIGNATURE_SIZE bytes, raw r | s
+ *                            for ES256, R | S for Ed25519.
+ *
+ * @retval NRF_ERROR_NOT_SUPPORTED  No backend provides the algorithm.
+ */
+ret_code_t u2f_crypto_alg_sign(u2f_crypto_alg_t alg,
+                               uint8_t const * p_private_key,
+                               uint8_t const * p_message, size_t size,
+                               uint8_t * p_signature);
+
+
+/**
+ * @brief Set the size below which the hashes go to the Oberon backend.
+ *
+ * Whatever the hash backend selected. 0 sends every hash to the selected
+ * backend.
+ */
+void u2f_crypto_hash_threshold_set(size_t size);
+
+
+/**
+ * @brief Get the size below which the hashes go to the Oberon backend.
+ */
+size_t u2f_crypto_hash_threshold_get(void);
+
+
+/**
+ * @brief Time the Oberon and the selected hash backend, and set the size
+ *        below which Oberon is the faster.
+ *
+ * Hashes up to four SHA-256 blocks of data, a few times each.
+ *
+ * @return The threshold set, 0 if Oberon is not built in or never faster.
+ */
+size_t u2f_crypto_hash_threshold_measure(void);
+
+
+/**
+ * @brief Compute the SHA-256 of the concatenation of @p count chunks.
+ *
+ * Inputs shorter than the threshold, see u2f_crypto_hash_threshold_set(),
+ * go to the Oberon backend. A single chunk is hashed in a single call.
+ *
+ * @param[in]  p_chunks       Data to hash, in order.
+ * @param[in]  count          Number of chunks.
+ * @param[out] p_digest       @ref U2F_CRYPTO_HASH_SIZE bytes.
+ */
+ret_code_t u2f_crypto_hash(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                           uint8_t * p_digest);
+
+
+/**
+ * @brief Load the device key, which keys the key handles.
+ *
+ * Every backend providing @ref U2F_CRYPTO_OP_WRAP expands the key once into
+ * long-lived encrypt and decrypt contexts, which u2f_crypto_wrap() and
+ * u2f_crypto_unwrap() reuse. u2f_crypto_mac() is keyed by a sub-key, the
+ * HMAC-SHA256 of "kdf" under the device key, so that the AES and the HMAC
+ * never share a key; AES keeps the device key itself, which the key handles
+ * of earlier firmware were encrypted with. Call it again when the key
+ * changes.
+ *
+ * @param[in]  p_key          @ref U2F_CRYPTO_WRAP_KEY_SIZE bytes.
+ */
+ret_code_t u2f_crypto_wrap_key_set(uint8_t const * p_key);
+
+
+/**
+ * @brief Compute the HMAC-SHA256 of the concatenation of @p count chunks,
+ *        keyed by the sub-key of u2f_crypto_wrap_key_set().
+ *
+ * @param[in]  p_chunks       Data, in order.
+ * @param[in]  count          Number of chunks.
+ * @param[out] p_mac          @ref U2F_CRYPTO_MAC_SIZE bytes.
+ *
+ * @retval NRF_ERROR_INVALID_STATE  No key was loaded.
+ */
+ret_code_t u2f_crypto_mac(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                          uint8_t * p_mac);
+
+
+/**
+ * @brief Encrypt a key handle with AES-128 ECB, under the key of
+ *        u2f_crypto_wrap_key_set().
+ *
+ * @param[in]  p_in           Plaintext.
+ * @param[out] p_out          Ciphertext, may be @p p_in.
+ * @param[in]  size           Size, a multiple of @ref U2F_CRYPTO_WRAP_BLOCK_SIZE.
+ *
+ * @retval NRF_ERROR_INVALID_STATE  No key was loaded.
+ */
+ret_code_t u2f_crypto_wrap(uint8_t const * p_in, uint8_t * p_out, size_t size);
+
+
+/**
+ * @brief Decrypt a key handle with AES-128 ECB, under the key of
+ *        u2f_crypto_wrap_key_set().
+ *
+ * @param[in]  p_in           Ciphertext.
+ * @param[out] p_out          Plaintext, may be @p p_in.
+ * @param[in]  size           Size, a multiple of @ref U2F_CRYPTO_WRAP_BLOCK_SIZE.
+ *
+ * @retval NRF_ERROR_INVALID_STATE  No key was loaded.
+ */
+ret_code_t u2f_crypto_unwrap(uint8_t const * p_in, uint8_t * p_out, size_t size);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U2F_CRYPTO_H__
@@ -0,0 +1,114 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_CRYPTO_BACKEND_H__
+#define U2F_CRYPTO_BACKEND_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+#include "u2f_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Backend of u2f_crypto.
+ *
+ * The functions take the raw big endian keys of u2f_crypto.h. An operation
+ * a backend does not provide is NULL.
+ */
+typedef struct
+{
+    char const * p_name;
+
+    /** Called once by u2f_crypto_init(), after nrf_crypto_init(). May be NULL. */
+    ret_code_t (*init)(void);
+
+    /** Idle work of the sign backend, from the main loop, see
+     *  u2f_crypto_process(). May be NULL. */
+    bool (*process)(void);
+
+    ret_code_t (*keygen)(uint8_t * p_private_key, uint8_t * p_public_key);
+
+    /** Public key of a private key, with the keygen. May be NULL. */
+    ret_code_t (*public_key)(uint8_t const * p_private_key,
+                             uint8_t * p_public_key);
+
+    ret_code_t (*sign)(uint8_t const * p_private_key, uint8_t const * p_hash,
+                       uint8_t * p_signature);
+
+    /** Several signatures at once, with the sign. May be NULL. */
+    ret_code_t (*sign_batch)(u2f_crypto_sign_req_t const * p_reqs,
+                             size_t count);
+
+    ret_code_t (*hash)(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                       uint8_t * p_digest);
+
+    /** Expand the wrapping key into the contexts used by wrap and unwrap,
+     *  and keep the @ref U2F_CRYPTO_MAC_KEY_SIZE bytes key of mac. */
+    ret_code_t (*wrap_key_set)(uint8_t const * p_key,
+                               uint8_t const * p_mac_key);
+
+    ret_code_t (*wrap)(uint8_t const * p_in, uint8_t * p_out, size_t size);
+
+    ret_code_t (*unwrap)(uint8_t const * p_in, uint8_t * p_out, size_t size);
+
+    /** HMAC-SHA256 keyed by the key of wrap_key_set. */
+    ret_code_t (*mac)(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                      uint8_t * p_mac);
+
+    /** Ed25519 public key of a seed. May be NULL, with eddsa_sign. */
+    ret_code_t (*eddsa_public_key)(uint8_t const * p_private_key,
+                                   uint8_t * p_public_key);
+
+    /** Ed25519 signature of a message, PureEdDSA. */
+    ret_code_t (*eddsa_sign)(uint8_t const * p_private_key,
+                             uint8_t const * p_message, size_t size,
+                             uint8_t * p_signature);
+} u2f_crypto_backend_t;
+
+
+extern u2f_crypto_backend_t const g_u2f_crypto_cc310;
+extern u2f_crypto_backend_t const g_u2f_crypto_micro_ecc;
+extern u2f_crypto_backend_t const g_u2f_crypto_host;
+extern u2f_crypto_backend_t const g_u2f_crypto_comb;
+extern u2f_crypto_backend_t const g_u2f_crypto_oberon;
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U2F_CRYPTO_BACKEND_H__
@@ -0,0 +1,99 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_CRYPTO_COMB_H__
+#define U2F_CRYPTO_COMB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Shape of the fixed-base comb table of secp256r1.
+ *
+ * The 256-bit scalar is cut into U2F_CRYPTO_COMB_TEETH rows, each cut
+ * into U2F_CRYPTO_COMB_BLOCKS blocks. A multiplication by the generator
+ * takes 256 / (TEETH * BLOCKS) doublings and 256 / TEETH additions. The
+ * table takes BLOCKS * (2^TEETH - 1) points of 64 bytes of flash.
+ *
+ * tools/gen_p256_comb.py generates the table at build time, with the same
+ * values.
+ */
+#define U2F_CRYPTO_COMB_TEETH       4
+#define U2F_CRYPTO_COMB_BLOCKS      4
+
+#define U2F_CRYPTO_COMB_POINTS      ((1 << U2F_CRYPTO_COMB_TEETH) - 1)
+
+
+/**
+ * @brief Affine point, in the Montgomery domain of p, little endian limbs.
+ */
+typedef struct
+{
+    uint32_t x[8];
+    uint32_t y[8];
+} u2f_crypto_comb_point_t;
+
+
+/**
+ * @brief Comb table, entry u - 1 of a block for the teeth u.
+ */
+extern u2f_crypto_comb_point_t const
+    g_u2f_crypto_comb_table[U2F_CRYPTO_COMB_BLOCKS][U2F_CRYPTO_COMB_POINTS];
+
+
+/**
+ * @brief Counters of the ECDSA nonce pool.
+ */
+typedef struct
+{
+    uint32_t pool_size;             //!< Slots, U2F_CRYPTO_COMB_NONCE_POOL_SIZE.
+    uint32_t pool_ready;            //!< Nonces ready now.
+    uint32_t pool_filled;           //!< Nonces precomputed while idle.
+    uint32_t pool_hits;             //!< Signatures with a precomputed nonce.
+    uint32_t pool_misses;           //!< Signatures that computed their nonce.
+} u2f_crypto_comb_stats_t;
+
+
+/**
+ * @brief Get the counters of the ECDSA nonce pool, since u2f_crypto_init().
+ */
+void u2f_crypto_comb_stats_get(u2f_crypto_comb_stats_t * p_stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U2F_CRYPTO_COMB_H__
@@ -0,0 +1,114 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_ENTROPY_H__
+#define U2F_ENTROPY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "app_util_platform.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Interrupt priority of the RNG.
+ *
+ * Higher (numerically lower) than the worker, so that the pool refills
+ * while a crypto operation runs.
+ */
+#ifndef U2F_ENTROPY_IRQ_PRIORITY
+#define U2F_ENTROPY_IRQ_PRIORITY    APP_IRQ_PRIORITY_LOW
+#endif
+
+
+/**
+ * @brief Most bytes of a u2f_entropy_get() call, a SHA-256 digest.
+ */
+#define U2F_ENTROPY_GET_MAX         32
+
+
+/**
+ * @brief Counters of the entropy pool.
+ */
+typedef struct
+{
+    uint32_t pool_size;             //!< Bytes, U2F_ENTROPY_POOL_SIZE.
+    uint32_t pool_level;            //!< Bytes in the pool now.
+    uint32_t samples;               //!< Bytes read from the RNG.
+    uint32_t served;                //!< Raw bytes taken from the pool.
+    uint32_t requests;              //!< Calls of u2f_entropy_get().
+    uint32_t dry;                   //!< Calls that found too few bytes.
+    uint32_t rct_failures;          //!< Repetition count test failures.
+    uint32_t apt_failures;          //!< Adaptive proportion test failures.
+} u2f_entropy_stats_t;
+
+
+/**
+ * @brief Function for initializing the entropy pool.
+ *
+ * Starts the RNG, with bias correction. The pool takes bytes once the
+ * startup health tests have passed.
+ */
+ret_code_t u2f_entropy_init(void);
+
+
+/**
+ * @brief Take @p size random bytes from the pool.
+ *
+ * The bytes are the SHA-256 of twice as many raw bytes of the pool. May be
+ * called from any context. The RNG restarts to refill the pool.
+ *
+ * @param[out] p_out  Random bytes.
+ * @param[in]  size   At most @ref U2F_ENTROPY_GET_MAX.
+ *
+ * @retval true   The bytes were taken.
+ * @retval false  The pool holds fewer than twice @p size bytes, or @p size
+ *                is too large, nothing taken.
+ */
+bool u2f_entropy_get(uint8_t * p_out, size_t size);
+
+
+/**
+ * @brief Get the counters of the entropy pool, since u2f_entropy_init().
+ */
+void u2f_entropy_stats_get(u2f_entropy_stats_t * p_stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U2F_ENTROPY_H__
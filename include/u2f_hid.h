@@ -144,6 +144,29 @@ uint32_t u2f_hid_init(void);
 void u2f_hid_process(void);
 
 
+/**
+ * @brief Get the time left until the next timeout of the frame layer.
+ *
+ * The frame layer arms a wake up timer at this deadline, nothing needs to 
+ * poll it in between.
+ *
+ * @param[out] p_left_ms  Milliseconds until the next deadline.
+ *
+ * @return false if no timeout is pending.
+ *
+ */
+bool u2f_hid_next_deadline_get(uint32_t * p_left_ms);
+
+
+/**
+ * @brief Schedule @ref u2f_hid_process to run at the USB event priority.
+ *
+ * Safe to call from any context.
+ *
+ */
+void u2f_hid_schedule(void);
+
+
 
 #ifdef __cplusplus
 }
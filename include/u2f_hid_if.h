@@ -62,6 +62,51 @@ extern "C" {
  */
 #define REPORT_IN_QUEUE_SIZE    1
 
+/**
+ * @brief Number of OUT reports buffered until the frame layer runs.
+ */
+#ifndef U2F_HID_IF_RX_QUEUE_SIZE
+#define U2F_HID_IF_RX_QUEUE_SIZE    8
+#endif
+
+/**
+ * @brief Number of IN reports that can be queued for transmission.
+ *
+ * Large enough to hold the longest registration response.
+ */
+#ifndef U2F_HID_IF_TX_QUEUE_SIZE
+#define U2F_HID_IF_TX_QUEUE_SIZE    48
+#endif
+
+/**
+ * @brief Returned by @ref u2f_hid_if_recv when no complete message is ready.
+ */
+#define U2F_HID_IF_NO_DATA          (ERR_OTHER + 1)
+
+/**
+ * @brief USB transport counters.
+ *
+ * All the fields are 32-bit, in the order they are exported by the 
+ * U2FHID_STATS vendor command.
+ */
+typedef struct
+{
+    uint32_t frames_in;         //!< OUT reports received.
+    uint32_t frames_out;        //!< IN reports sent.
+    uint32_t invalid_cid;       //!< Frames on an unknown or unexpected channel.
+    uint32_t invalid_seq;       //!< Continuation frames out of sequence.
+    uint32_t invalid_len;       //!< Reports or messages with a bad length.
+    uint32_t timeouts;          //!< Messages not completed in time.
+    uint32_t channel_busy;      //!< Frames refused with ERR_CHANNEL_BUSY.
+    uint32_t rx_queue_full;     //!< OUT reports dropped, RX queue full.
+    uint32_t tx_queue_full;     //!< Messages refused, TX queue full.
+    uint32_t tx_wait_max_us;    //!< Longest wait for the host to read an IN report.
+    uint32_t suspends;          //!< USB suspend events.
+    uint32_t resumes;           //!< USB resume events.
+    uint32_t rx_queue_hwm;      //!< Most OUT reports queued at once.
+    uint32_t tx_queue_hwm;      //!< Most IN reports queued at once.
+} u2f_hid_if_stats_t;
+
 /**
  * @brief Size of maximum output report. HID generic class will reserve
  *        this buffer size + 1 memory space. 
@@ -121,6 +166,8 @@ uint32_t u2f_hid_if_init(void);
 /**
  * @brief Send U2F HID Data.
  *
+ * The message is split in frames and queued for transmission, this function
+ * does not wait for the host to read the reports.
  *
  * @param[in] cid       HID Channel identifier.
  * @param[in] cmd       Frame command.
@@ -137,6 +184,9 @@ uint8_t u2f_hid_if_send(uint32_t cid, uint8_t cmd,
 /**
  * @brief Receive U2F HID Data.
  *
+ * Reassembles the queued OUT reports without blocking. Should be called 
+ * until it returns @ref U2F_HID_IF_NO_DATA. On an error other than 
+ * @ref U2F_HID_IF_NO_DATA, @p p_cid holds the offending channel.
  *
  * @param[out] p_cid       HID Channel identifier.
  * @param[out] p_cmd       Frame command.
@@ -150,6 +200,73 @@ uint8_t u2f_hid_if_recv(uint32_t * p_cid, uint8_t * p_cmd,
                     uint8_t * p_data, size_t * p_size,
                     uint32_t timeout);
 
+/**
+ * @brief Check if a message is partially received.
+ *
+ * @param[out] p_left_ms   Time left before the reassembly times out.
+ *
+ * @retval true   A message is being reassembled.
+ * @retval false  No reassembly in progress.
+ */
+bool u2f_hid_if_rx_pending(uint32_t * p_left_ms);
+
+
+/**
+ * @brief Get the USB transport counters.
+ *
+ * @param[out] p_stats  Copy of the counters.
+ */
+void u2f_hid_if_stats_get(u2f_hid_if_stats_t * p_stats);
+
+
+/**
+ * @brief Encode the USB transport counters as little endian 32-bit words,
+ *        in struct order.
+ *
+ * @param[out] p_buf  Buffer of sizeof(u2f_hid_if_stats_t) bytes.
+ *
+ * @return Number of bytes written.
+ */
+uint16_t u2f_hid_if_stats_encode(uint8_t * p_buf);
+
+
+/**
+ * @brief Clear the USB transport counters.
+ */
+void u2f_hid_if_stats_reset(void);
+
+
+/**
+ * @brief Count a message on a channel the frame layer does not know.
+ */
+void u2f_hid_if_stats_invalid_cid_notify(void);
+
+
+/**
+ * @brief Count a message refused because its channel is busy.
+ */
+void u2f_hid_if_stats_busy_notify(void);
+
+
+/**
+ * @brief Start a transaction.
+ *
+ * Until @ref u2f_hid_if_trans_end is called, U2FHID_MSG requests from any 
+ * other channel are answered with ERR_CHANNEL_BUSY as soon as their 
+ * initialization frame is received.
+ *
+ * @param[in] cid       Channel owning the transaction.
+ */
+void u2f_hid_if_trans_begin(uint32_t cid);
+
+
+/**
+ * @brief End the current transaction.
+ *
+ */
+void u2f_hid_if_trans_end(void);
+
+
 /**
  * @brief U2F HID interface process.
  *
@@ -0,0 +1,145 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_KEY_HANDLE_H__
+#define U2F_KEY_HANDLE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+#include "u2f.h"
+#include "u2f_crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define U2F_KEY_HANDLE_NONCE_SIZE   32
+
+/** Version byte of the HMAC key handles of ES256 credentials. */
+#define U2F_KEY_HANDLE_VERSION_HMAC     0x01
+
+/** Version byte of the HMAC key handles of Ed25519 credentials. */
+#define U2F_KEY_HANDLE_VERSION_ED25519  0x02
+
+/** AES-128 ECB of the private key and the appId. */
+#define U2F_KEY_HANDLE_AES_SIZE     (U2F_EC_KEY_SIZE + U2F_APPID_SIZE)
+
+/** Version, nonce and tag. */
+#define U2F_KEY_HANDLE_HMAC_SIZE    (1 + U2F_KEY_HANDLE_NONCE_SIZE + U2F_CRYPTO_MAC_SIZE)
+
+
+/**
+ * @brief Key handle schemes, U2F_KEY_HANDLE_SCHEME selects the one of new
+ *        registrations.
+ */
+typedef enum
+{
+    /** The private key and the appId, encrypted with the device key. */
+    U2F_KEY_HANDLE_AES  = 0,
+    /** A random nonce and a tag. The private key is the HMAC-SHA256 of the
+     *  version, the nonce and the appId, the tag the HMAC-SHA256 of the
+     *  private key and the appId, both under the MAC sub-key of the device
+     *  key. No private key, even encrypted, leaves the device. */
+    U2F_KEY_HANDLE_HMAC = 1,
+} u2f_key_handle_scheme_t;
+
+
+/**
+ * @brief Make the key pair of a new registration.
+ *
+ * With @ref U2F_KEY_HANDLE_HMAC, the version and the nonce are written to
+ * the start of the key handle. The version tells the algorithm, the AES
+ * handles are ES256 only.
+ *
+ * @param[in]  scheme         Key handle scheme.
+ * @param[in]  alg            Algorithm of the credential.
+ * @param[in]  p_app_id       @ref U2F_APPID_SIZE bytes.
+ * @param[out] p_private_key  @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes.
+ * @param[out] p_public_key   @ref U2F_CRYPTO_PUBLIC_KEY_SIZE bytes, or
+ *                            @ref U2F_CRYPTO_ED25519_PUBLIC_KEY_SIZE.
+ * @param[out] p_handle       Key handle, completed by u2f_key_handle_wrap().
+ *
+ * @retval NRF_ERROR_INVALID_PARAM  Ed25519 with @ref U2F_KEY_HANDLE_AES.
+ */
+ret_code_t u2f_key_handle_keygen(u2f_key_handle_scheme_t scheme,
+                                 u2f_crypto_alg_t alg,
+                                 uint8_t const * p_app_id,
+                                 uint8_t * p_private_key,
+                                 uint8_t * p_public_key,
+                                 uint8_t * p_handle);
+
+
+/**
+ * @brief Complete the key handle of a key pair of u2f_key_handle_keygen().
+ *
+ * @param[in]  scheme         Scheme of u2f_key_handle_keygen().
+ * @param[in]  p_app_id       @ref U2F_APPID_SIZE bytes.
+ * @param[in]  p_private_key  @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes.
+ * @param[out] p_handle       Key handle, up to @ref U2F_MAX_KH_SIZE bytes.
+ * @param[out] p_size         Size of the key handle.
+ */
+ret_code_t u2f_key_handle_wrap(u2f_key_handle_scheme_t scheme,
+                               uint8_t const * p_app_id,
+                               uint8_t const * p_private_key,
+                               uint8_t * p_handle,
+                               uint8_t * p_size);
+
+
+/**
+ * @brief Get the private key and the algorithm of a key handle, of either
+ *        scheme.
+ *
+ * The scheme is told by the size and the version byte, so that the handles
+ * of both remain valid whichever makes the new ones.
+ *
+ * @param[in]  p_app_id       @ref U2F_APPID_SIZE bytes.
+ * @param[in]  p_handle       Key handle.
+ * @param[in]  size           Size of the key handle.
+ * @param[out] p_private_key  @ref U2F_CRYPTO_PRIVATE_KEY_SIZE bytes.
+ * @param[out] p_alg          Algorithm of the credential.
+ *
+ * @retval NRF_ERROR_INVALID_DATA  The handle was not made by this device
+ *                                 for this appId.
+ */
+ret_code_t u2f_key_handle_open(uint8_t const * p_app_id,
+                               uint8_t const * p_handle,
+                               size_t size,
+                               uint8_t * p_private_key,
+                               u2f_crypto_alg_t * p_alg);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U2F_KEY_HANDLE_H__
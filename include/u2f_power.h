@@ -0,0 +1,94 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_POWER_H__
+#define U2F_POWER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Counters of the CryptoCell power manager.
+ */
+typedef struct
+{
+    uint32_t idle_ms;               //!< Idle period before a power down.
+    bool     on;                    //!< The manager holds the CryptoCell on.
+    uint32_t warmups;               //!< Power ups on a CTAPHID frame.
+    uint32_t hits;                  //!< Frames that found it on already.
+    uint32_t powerdowns;            //!< Power downs after the idle period.
+    uint32_t on_ms;                 //!< Time held on.
+} u2f_power_stats_t;
+
+
+/**
+ * @brief Function for initializing the CryptoCell power manager.
+ *
+ * Must be called after app_timer_init(). The CryptoCell is left to
+ * nrf_crypto, which powers it per operation, until the first frame.
+ */
+ret_code_t u2f_power_init(void);
+
+
+/**
+ * @brief Hold the CryptoCell on, ahead of the crypto of a request.
+ *
+ * Called on the initialization frame of a U2FHID_INIT or U2FHID_MSG, so
+ * that the CryptoCell powers up while the rest of the message comes in.
+ * Does nothing if no operation is routed to CC310. The CryptoCell is
+ * released once no frame came and no job ran for the idle period.
+ */
+void u2f_power_warm(void);
+
+
+/**
+ * @brief Set the idle period, in milliseconds, before a power down.
+ */
+void u2f_power_idle_set(uint32_t idle_ms);
+
+
+/**
+ * @brief Get the counters of the power manager, since u2f_power_init().
+ */
+void u2f_power_stats_get(u2f_power_stats_t * p_stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U2F_POWER_H__
@@ -0,0 +1,320 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_STATS_H__
+#define U2F_STATS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "nrf.h"
+#include "fds.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of log2 buckets of a latency histogram.
+ *
+ * Bucket i counts the latencies in [2^i, 2^(i+1)) CPU cycles, 
+ * bucket 0 also counts zero.
+ */
+#ifndef U2F_STATS_HIST_BUCKETS
+#define U2F_STATS_HIST_BUCKETS      32
+#endif
+
+
+/**
+ * @brief Latency histograms, one per U2FHID command and per U2F instruction.
+ */
+typedef enum
+{
+    U2F_STATS_HIST_PING,            //!< U2FHID_PING.
+    U2F_STATS_HIST_MSG,             //!< U2FHID_MSG, including the worker job.
+    U2F_STATS_HIST_LOCK,            //!< U2FHID_LOCK.
+    U2F_STATS_HIST_INIT,            //!< U2FHID_INIT.
+    U2F_STATS_HIST_WINK,            //!< U2FHID_WINK.
+    U2F_STATS_HIST_SYNC,            //!< U2FHID_SYNC.
+    U2F_STATS_HIST_VENDOR,          //!< Vendor defined and unknown commands.
+    U2F_STATS_HIST_REGISTER,        //!< U2F_REGISTER.
+    U2F_STATS_HIST_AUTHENTICATE,    //!< U2F_AUTHENTICATE.
+    U2F_STATS_HIST_VERSION,         //!< U2F_VERSION.
+    U2F_STATS_HIST_INS_OTHER,       //!< Unsupported U2F instructions.
+    U2F_STATS_HIST_COUNT
+} u2f_stats_hist_t;
+
+
+/**
+ * @brief Latency histogram.
+ */
+typedef struct
+{
+    uint32_t count;                             //!< Number of samples.
+    uint32_t max;                               //!< Longest latency in cycles.
+    uint64_t total;                             //!< Sum of the latencies in cycles.
+    uint32_t buckets[U2F_STATS_HIST_BUCKETS];   //!< Samples per log2 bucket.
+} u2f_stats_hist_data_t;
+
+
+/**
+ * @brief Phases of the U2F operations, profiled with @ref U2F_PROFILE_MARK.
+ */
+typedef enum
+{
+    U2F_PROFILE_REG_KEYGEN,         //!< Key pair generation.
+    U2F_PROFILE_REG_WRAP,           //!< AES key handle wrapping.
+    U2F_PROFILE_REG_HASH,           //!< SHA-256 of the registration data.
+    U2F_PROFILE_REG_SIGN,           //!< Attestation signature.
+    U2F_PROFILE_REG_DER,            //!< DER signature conversion.
+    U2F_PROFILE_AUTH_UNWRAP,        //!< AES key handle unwrapping.
+    U2F_PROFILE_AUTH_COUNTER,       //!< Counter update in flash.
+    U2F_PROFILE_AUTH_HASH,          //!< SHA-256 of the authentication data.
+    U2F_PROFILE_AUTH_SIGN,          //!< Authentication signature.
+    U2F_PROFILE_AUTH_DER,           //!< DER signature conversion.
+    U2F_PROFILE_COUNT
+} u2f_profile_phase_t;
+
+
+/**
+ * @brief Cycle counts of a profiled phase.
+ */
+typedef struct
+{
+    uint32_t count;                 //!< Number of samples.
+    uint32_t last;                  //!< Latest sample in cycles.
+    uint32_t max;                   //!< Longest sample in cycles.
+    uint64_t total;                 //!< Sum of the samples in cycles.
+} u2f_profile_data_t;
+
+
+/**
+ * @brief High-water marks.
+ */
+typedef enum
+{
+    U2F_STATS_HWM_CHANNELS,         //!< U2F channels allocated at once.
+    U2F_STATS_HWM_COUNT
+} u2f_stats_hwm_t;
+
+
+/**
+ * @brief Flash operations, counted from the FDS events.
+ *
+ * The usage is that of fds_stat(), taken by u2f_stats_process() after the
+ * events: the readers run in SWI1, and could preempt an operation of the
+ * worker half done, and the scan is too long for the event handler.
+ */
+typedef struct
+{
+    uint32_t   writes;              //!< Records written.
+    uint32_t   updates;             //!< Records updated.
+    uint32_t   deletes;             //!< Records or files deleted.
+    uint32_t   gc_runs;             //!< Garbage collections, each erases pages.
+    uint32_t   failures;            //!< Operations that failed.
+    fds_stat_t usage;               //!< Pages and records, see u2f_stats_process().
+} u2f_stats_flash_t;
+
+
+/**
+ * @brief Size of a phase in the @ref u2f_stats_profile_encode output.
+ */
+#define U2F_PROFILE_ENCODED_SIZE    20
+
+
+/**
+ * @brief Phase probes, compiled out unless CONFIG_U2F_PROFILE_ENABLED is set.
+ *
+ * @ref U2F_PROFILE_START opens a measurement in the current scope and each
+ * @ref U2F_PROFILE_MARK closes the running phase and starts the next one.
+ */
+#ifdef CONFIG_U2F_PROFILE_ENABLED
+#define U2F_PROFILE_START()         uint32_t u2f_profile_t0 = u2f_stats_cycles_get()
+#define U2F_PROFILE_MARK(phase)     \
+    u2f_profile_t0 = u2f_stats_profile_record(phase, u2f_profile_t0)
+#else
+#define U2F_PROFILE_START()
+#define U2F_PROFILE_MARK(phase)
+#endif
+
+
+/**
+ * @brief Function for initializing the statistics.
+ *
+ * Enables the DWT cycle counter and paints the unused stack, to be
+ * called early from thread mode.
+ *
+ */
+void u2f_stats_init(void);
+
+
+/**
+ * @brief Get the current CPU cycle count.
+ *
+ * The DWT counter wraps every 2^32 cycles (about 67 s at 64 MHz) and does
+ * not count while the CPU sleeps.
+ *
+ */
+__STATIC_INLINE uint32_t u2f_stats_cycles_get(void)
+{
+    return DWT->CYCCNT;
+}
+
+
+/**
+ * @brief Record the latency of a U2FHID command.
+ *
+ * @param[in] cmd    U2FHID command.
+ * @param[in] start  Cycle count at the start of the command.
+ *
+ */
+void u2f_stats_cmd_record(uint8_t cmd, uint32_t start);
+
+
+/**
+ * @brief Record the latency of a U2F instruction.
+ *
+ * @param[in] ins    U2F instruction.
+ * @param[in] start  Cycle count at the start of the U2FHID_MSG command.
+ *
+ */
+void u2f_stats_ins_record(uint8_t ins, uint32_t start);
+
+
+/**
+ * @brief Record the cycles spent in a phase.
+ *
+ * @param[in] phase  Profiled phase.
+ * @param[in] start  Cycle count at the start of the phase.
+ *
+ * @return Cycle count at the end of the phase, start of the next one.
+ *
+ */
+uint32_t u2f_stats_profile_record(u2f_profile_phase_t phase, uint32_t start);
+
+
+/**
+ * @brief Encode the phase profile.
+ *
+ * Each phase is encoded as count, last, max and total (64-bit), little 
+ * endian, in @ref u2f_profile_phase_t order.
+ *
+ * @param[out] p_buf  Output buffer.
+ * @param[in]  size   Size of the output buffer.
+ *
+ * @return Number of bytes written.
+ *
+ */
+uint16_t u2f_stats_profile_encode(uint8_t * p_buf, uint16_t size);
+
+
+/**
+ * @brief Update a high-water mark.
+ *
+ * @param[in] hwm    High-water mark identifier.
+ * @param[in] value  Current value.
+ *
+ */
+void u2f_stats_hwm_update(u2f_stats_hwm_t hwm, uint32_t value);
+
+
+/**
+ * @brief Get a high-water mark.
+ *
+ * @param[in] hwm    High-water mark identifier.
+ *
+ */
+uint32_t u2f_stats_hwm_get(u2f_stats_hwm_t hwm);
+
+
+/**
+ * @brief Get the size of the main stack.
+ *
+ */
+uint32_t u2f_stats_stack_size_get(void);
+
+
+/**
+ * @brief Get the most main stack ever used, from the painted stack.
+ *
+ */
+uint32_t u2f_stats_stack_used_max_get(void);
+
+
+/**
+ * @brief Count a flash operation.
+ *
+ * @param[in] p_evt  FDS event.
+ *
+ */
+void u2f_stats_flash_event(fds_evt_t const * p_evt);
+
+
+/**
+ * @brief Take the flash usage again if an FDS event came since, from the
+ *        main loop.
+ */
+void u2f_stats_process(void);
+
+
+/**
+ * @brief Get the flash operation counters.
+ *
+ * @param[out] p_flash  Copy of the counters.
+ *
+ */
+void u2f_stats_flash_get(u2f_stats_flash_t * p_flash);
+
+
+/**
+ * @brief Get a latency histogram.
+ *
+ * @param[in] hist  Histogram identifier.
+ *
+ * @return Pointer to the histogram, NULL if invalid.
+ *
+ */
+u2f_stats_hist_data_t const * u2f_stats_hist_get(u2f_stats_hist_t hist);
+
+
+/**
+ * @brief Clear all the latency histograms and the phase profile.
+ *
+ */
+void u2f_stats_reset(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U2F_STATS_H__
+
@@ -0,0 +1,145 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_TRACE_H__
+#define U2F_TRACE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of records in the RAM ring, must be a power of two.
+ */
+#ifndef U2F_TRACE_RING_SIZE
+#define U2F_TRACE_RING_SIZE         128
+#endif
+
+/**
+ * @brief SEGGER RTT up channel the records are drained to.
+ *
+ * Channel 0 is left to the terminal and the RTT log backend.
+ */
+#ifndef U2F_TRACE_RTT_CHANNEL
+#define U2F_TRACE_RTT_CHANNEL       1
+#endif
+
+/**
+ * @brief Size of the RTT up buffer.
+ */
+#ifndef U2F_TRACE_RTT_BUFFER_SIZE
+#define U2F_TRACE_RTT_BUFFER_SIZE   1024
+#endif
+
+
+/**
+ * @brief Trace events. Keep in sync with tools/u2f_trace_decode.py.
+ */
+typedef enum
+{
+    U2F_TRACE_EV_FRAME_RX = 1,      //!< Frame received.     arg0: cid, arg1: cmd or seq.
+    U2F_TRACE_EV_FRAME_TX,          //!< Frame sent.         arg0: cid, arg1: cmd or seq.
+    U2F_TRACE_EV_CMD,               //!< U2FHID command.     arg0: cid, arg1: cmd.
+    U2F_TRACE_EV_CH_STATE,          //!< Channel state.      arg0: cid, arg1: state.
+    U2F_TRACE_EV_CH_ALLOC,          //!< Channel allocated.  arg0: cid.
+    U2F_TRACE_EV_CH_FREE,           //!< Channel freed.      arg0: cid.
+    U2F_TRACE_EV_ERROR,             //!< Error response.     arg0: cid, arg1: error.
+    U2F_TRACE_EV_MSG_START,         //!< U2F message job.    arg0: cid, arg1: ins.
+    U2F_TRACE_EV_MSG_DONE,          //!< U2F message done.   arg0: cid, arg1: length.
+    U2F_TRACE_EV_PHASE,             //!< Crypto phase done.  arg0: phase, arg1: cycles.
+    U2F_TRACE_EV_FDS,               //!< FDS event.          arg0: id, arg1: result.
+} u2f_trace_event_t;
+
+
+/**
+ * @brief Trace record, as streamed over RTT (little endian).
+ */
+typedef struct
+{
+    uint32_t timestamp;             //!< RTC1 ticks (24-bit, 32768 Hz).
+    uint16_t id;                    //!< @ref u2f_trace_event_t.
+    uint16_t seq;                   //!< Sequence number, gaps mean lost records.
+    uint32_t arg0;                  //!< First argument.
+    uint32_t arg1;                  //!< Second argument.
+} u2f_trace_record_t;
+
+
+/**
+ * @brief Trace points, compiled out unless CONFIG_U2F_TRACE_ENABLED is set.
+ */
+#ifdef CONFIG_U2F_TRACE_ENABLED
+#define U2F_TRACE(id, arg0, arg1)   u2f_trace_write((id), (uint32_t)(arg0), (uint32_t)(arg1))
+#else
+#define U2F_TRACE(id, arg0, arg1)
+#endif
+
+
+/**
+ * @brief Function for initializing the trace.
+ *
+ * Configures the RTT up channel.
+ *
+ */
+void u2f_trace_init(void);
+
+
+/**
+ * @brief Write a record to the ring.
+ *
+ * Lock free, safe to call from any context. The oldest records are 
+ * overwritten when the ring is not drained fast enough.
+ *
+ * @param[in] id    Event identifier.
+ * @param[in] arg0  First argument.
+ * @param[in] arg1  Second argument.
+ *
+ */
+void u2f_trace_write(u2f_trace_event_t id, uint32_t arg0, uint32_t arg1);
+
+
+/**
+ * @brief Drain the ring to RTT.
+ *
+ * Must be called from a single context, usually the main loop.
+ *
+ */
+void u2f_trace_flush(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U2F_TRACE_H__
+
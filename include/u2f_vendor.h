@@ -0,0 +1,88 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_VENDOR_H__
+#define U2F_VENDOR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "u2f_hid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Vendor commands, in the U2FHID_VENDOR_FIRST..U2FHID_VENDOR_LAST range.
+ */
+#define U2FHID_PROFILE      (U2FHID_VENDOR_FIRST + 0)   // Read the phase cycle counts
+#define U2FHID_STATS        (U2FHID_VENDOR_FIRST + 1)   // Read the USB transport counters
+#define U2FHID_METRICS      (U2FHID_VENDOR_FIRST + 2)   // Read the metrics as TLV
+
+/**
+ * @brief U2FHID_METRICS tags.
+ *
+ * The request lists the tags to read, an empty request reads all of them.
+ * The response is a sequence of tag (1 byte), length (1 byte), value. 
+ * Multi-byte values are little endian.
+ */
+#define U2F_VENDOR_TAG_VERSION      0x01    // if version, major, minor, build, git revision
+#define U2F_VENDOR_TAG_USB          0x02    // u2f_hid_if_stats_t, 32-bit words
+#define U2F_VENDOR_TAG_HIST         0x03    // id, count, max, total (64-bit), {bucket, count}...
+#define U2F_VENDOR_TAG_MEMORY       0x04    // stack size, stack used, channels, rx/tx queue
+#define U2F_VENDOR_TAG_FLASH        0x05    // FDS status and flash operation counters
+#define U2F_VENDOR_TAG_PROFILE      0x06    // Phase profile, see u2f_stats_profile_encode()
+#define U2F_VENDOR_TAG_TRUNCATED    0xFF    // Response full, read the missing tags alone
+
+
+/**
+ * @brief Process a vendor command.
+ *
+ * @param[in]     cmd         U2FHID vendor command.
+ * @param[in]     p_req       Request payload.
+ * @param[in]     req_len     Request length.
+ * @param[out]    p_resp      Response payload.
+ * @param[in,out] p_resp_len  Response buffer size, then response length.
+ *
+ * @return ERR_NONE, or the U2FHID error to answer with.
+ */
+uint8_t u2f_vendor_cmd_process(uint8_t cmd, 
+                               uint8_t const * p_req, uint16_t req_len,
+                               uint8_t * p_resp, uint16_t * p_resp_len);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U2F_VENDOR_H__
+
@@ -0,0 +1,149 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#ifndef U2F_WORKER_H__
+#define U2F_WORKER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "app_util_platform.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Software interrupt used to run the worker jobs.
+ */
+#ifndef U2F_WORKER_IRQn
+#define U2F_WORKER_IRQn             SWI2_EGU2_IRQn
+#define U2F_WORKER_IRQHandler       SWI2_EGU2_IRQHandler
+#endif
+
+/**
+ * @brief Interrupt priority of the worker.
+ *
+ * Must be lower (numerically higher) than the USB event priority, so that
+ * the U2F HID frame layer can preempt a running crypto operation.
+ */
+#ifndef U2F_WORKER_IRQ_PRIORITY
+#define U2F_WORKER_IRQ_PRIORITY     APP_IRQ_PRIORITY_LOWEST
+#endif
+
+/**
+ * @brief Number of jobs that can be pending at the same time.
+ */
+#ifndef U2F_WORKER_QUEUE_SIZE
+#define U2F_WORKER_QUEUE_SIZE       4
+#endif
+
+
+/**
+ * @brief Job function, executed in the worker interrupt context.
+ *
+ * @param[in] p_context  Context passed to @ref u2f_worker_submit.
+ */
+typedef void (*u2f_worker_job_t)(void * p_context);
+
+
+/**
+ * @brief Completion handler, called in the worker interrupt context
+ *        every time a finished job is put in the completion queue.
+ */
+typedef void (*u2f_worker_done_handler_t)(void);
+
+
+/**
+ * @brief Initialize the worker.
+ *
+ * @param[in] done_handler  Completion handler.
+ *
+ * @return Standard error code.
+ */
+ret_code_t u2f_worker_init(u2f_worker_done_handler_t done_handler);
+
+
+/**
+ * @brief Submit a job to the worker.
+ *
+ * @param[in] job        Job function.
+ * @param[in] p_context  Context passed to the job and returned on completion.
+ *
+ * @retval NRF_SUCCESS     The job is queued.
+ * @retval NRF_ERROR_BUSY  The job queue is full.
+ */
+ret_code_t u2f_worker_submit(u2f_worker_job_t job, void * p_context);
+
+
+/**
+ * @brief Get the context of a finished job.
+ *
+ * @param[out] pp_context  Context of the finished job.
+ *
+ * @retval true   A finished job was taken from the completion queue.
+ * @retval false  The completion queue is empty.
+ */
+bool u2f_worker_done_get(void ** pp_context);
+
+
+/**
+ * @brief Check if the worker has queued or running jobs.
+ *
+ * @retval true   The worker is busy.
+ * @retval false  The worker is idle.
+ */
+bool u2f_worker_is_busy(void);
+
+
+/**
+ * @brief Hold back the jobs, from the main loop.
+ *
+ * For the main loop to use a resource the jobs also use, such as the
+ * CC310, which an nrf_crypto call would find busy if a job preempted the
+ * main loop. The jobs submitted meanwhile are queued, and run on
+ * @ref u2f_worker_resume. Keep it short: it delays the U2F requests.
+ */
+void u2f_worker_suspend(void);
+
+
+/**
+ * @brief Let the jobs run again, see @ref u2f_worker_suspend.
+ */
+void u2f_worker_resume(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* U2F_WORKER_H__ */
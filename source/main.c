@@ -41,9 +41,16 @@
 
 #include "app_timer.h"
 #include "app_error.h"
+#include "nrf_pwr_mgmt.h"
 #include "bsp.h"
 
+#include "u2f.h"
 #include "u2f_hid.h"
+#include "timer_platform.h"
+#include "u2f_crypto.h"
+#include "u2f_stats.h"
+#include "u2f_trace.h"
+#include "u2f_worker.h"
 
 #include "bsp_cli.h"
 #include "nrf_cli.h"
@@ -85,21 +92,9 @@ enum {
 };
 
 
-/** SysTick counter to avoid busy wait delay. */
-volatile uint32_t ms_ticks = 0;
-
 /** U2F user button state. */
 static bool m_user_button_pressed = false;
 
-/**
- * \brief SysTick handler used to measure precise delay. 
- */
-void SysTick_Handler(void)
-{
-    ms_ticks++;
-}
-
-
 /**
  * \brief Check user button state. 
  */
@@ -155,12 +150,6 @@ static void init_bsp(void)
     
     /* Configure LEDs */
     bsp_board_init(BSP_INIT_LEDS);
-
-    /* Enable SysTick interrupt for non busy wait delay. */
-    if (SysTick_Config(SystemCoreClock / 1000)) {
-        NRF_LOG_ERROR("init_bsp: SysTick configuration error!");
-        while(1);
-    }
 }
 
 static void init_cli(void)
@@ -200,6 +189,12 @@ int main(void)
     ret = app_timer_init();
     APP_ERROR_CHECK(ret);
 
+    ret = timer_platform_init();
+    APP_ERROR_CHECK(ret);
+
+    ret = nrf_pwr_mgmt_init();
+    APP_ERROR_CHECK(ret);
+
     init_bsp();
     init_cli();
 
@@ -214,12 +209,25 @@ int main(void)
 
     while (true)
     {
-
-        u2f_hid_process();
+        /* U2F HID runs in interrupts, see u2f_hid_schedule(). */
 
         nrf_cli_process(&m_cli_uart);
 
-        UNUSED_RETURN_VALUE(NRF_LOG_PROCESS());
-        
+        u2f_trace_flush();
+
+        /* Reclaim the flash of the old counters ahead of AUTHENTICATE. */
+        u2f_impl_process();
+        u2f_stats_process();
+
+        /* Precompute, e.g. the ECDSA nonces, while no request is served. */
+        bool crypto_busy = !u2f_worker_is_busy() && u2f_crypto_process();
+
+        /* Sleep until the next event, U2F HID timeouts wake us up through 
+         * an app_timer armed at u2f_hid_next_deadline_get(). */
+        if(!NRF_LOG_PROCESS() && !crypto_busy)
+        {
+            nrf_pwr_mgmt_run();
+        }
+
     }
 }
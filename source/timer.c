@@ -41,17 +41,90 @@ extern "C" {
 #include <stdbool.h>
 
 #include "timer_platform.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
 
 
-extern volatile uint32_t ms_ticks;
+/**
+ * Width of the app_timer RTC counter.
+ */
+#define RTC_COUNTER_BITS	24
+#define RTC_COUNTER_MASK	((1UL << RTC_COUNTER_BITS) - 1)
+
+/**
+ * Interval of the epoch keeper, below the RTC counter period.
+ */
+#define EPOCH_KEEPER_TICKS	(RTC_COUNTER_MASK / 2)
+
+
+APP_TIMER_DEF(m_epoch_keeper);
+
+/** Upper bits of the 64-bit RTC tick count. */
+static uint64_t m_epoch = 0;
+
+/** Last RTC counter value seen, to detect overflows. */
+static uint32_t m_last_cnt = 0;
+
+/**
+ * \brief Get the 64-bit RTC tick count.
+ *
+ * Extends the 24-bit RTC counter, it must be read at least once per counter
+ * period, see the epoch keeper.
+ *
+ * \return RTC ticks since start.
+ */
+static uint64_t getTicks(void)
+{
+	uint64_t ticks;
+
+	CRITICAL_REGION_ENTER();
+	uint32_t cnt = app_timer_cnt_get() & RTC_COUNTER_MASK;
+
+	if (cnt < m_last_cnt) {
+		m_epoch += (1ULL << RTC_COUNTER_BITS);
+	}
+	m_last_cnt = cnt;
+	ticks = m_epoch + cnt;
+	CRITICAL_REGION_EXIT();
+
+	return ticks;
+}
+
 /**
  * \brief Get time in milliseconds.
  *
  * \return milli second ticks count.
  */
-static uint32_t getTimeInMillis(void)
+static uint64_t getTimeInMillis(void)
+{
+	return (getTicks() * 1000) / APP_TIMER_CLOCK_FREQ;
+}
+
+static void epoch_keeper_handler(void *p_context)
 {
-	return ms_ticks;
+	(void)getTicks();
+}
+
+/**
+ * @brief Initialize the time base
+ *
+ * Starts the 64-bit millisecond clock derived from the app_timer RTC. 
+ * Must be called after app_timer_init().
+ *
+ * @return ret_code_t - NRF_SUCCESS on success
+ */
+ret_code_t timer_platform_init(void) {
+	ret_code_t ret;
+
+	ret = app_timer_create(&m_epoch_keeper, APP_TIMER_MODE_REPEATED,
+			epoch_keeper_handler);
+	if (ret != NRF_SUCCESS) {
+		return ret;
+	}
+
+	m_last_cnt = app_timer_cnt_get() & RTC_COUNTER_MASK;
+
+	return app_timer_start(m_epoch_keeper, EPOCH_KEEPER_TICKS, NULL);
 }
 
 /**
@@ -65,7 +138,7 @@ static uint32_t getTimeInMillis(void)
 
 bool has_timer_expired(Timer *timer) {
 	return ((timer->end_time > 0)
-	&& ((getTimeInMillis() + timer->offset) > timer->end_time));
+	&& (getTimeInMillis() > timer->end_time));
 }
 
 /**
@@ -77,17 +150,7 @@ bool has_timer_expired(Timer *timer) {
  * @param uint32_t - set the timer to expire in this number of milliseconds
  */
 void countdown_ms(Timer *timer, uint32_t timeout) {
-	uint32_t timems = getTimeInMillis();
-
-	timer->end_time = timems + timeout;
-
-	if (timer->end_time < timems) {
-		timer->offset = ~0 - timems + 1;
-		timer->end_time += timer->offset;
-	}
-	else {
-		timer->offset = 0;
-	}
+	timer->end_time = getTimeInMillis() + timeout;
 }
 
 /**
@@ -99,17 +162,7 @@ void countdown_ms(Timer *timer, uint32_t timeout) {
  * @param uint32_t - set the timer to expire in this number of seconds
  */
  void countdown_sec(Timer *timer, uint32_t timeout) {
-	uint32_t timems = getTimeInMillis();
-
-	timer->end_time = timems + (timeout * 1000);
-
-	if (timer->end_time < timems) {
-		timer->offset = ~0 - timems + 1;
-		timer->end_time += timer->offset;
-	}
-	else {
-		timer->offset = 0;
-	}
+	timer->end_time = getTimeInMillis() + ((uint64_t)timeout * 1000);
 }
 
 /**
@@ -122,8 +175,19 @@ void countdown_ms(Timer *timer, uint32_t timeout) {
  * @return int - milliseconds left on the countdown timer
  */
 uint32_t left_ms(Timer *timer) {
-	int diff = timer->end_time - (getTimeInMillis() + timer->offset);
-	return (diff > 0 ? diff : 0);
+	uint64_t now = getTimeInMillis();
+	return (timer->end_time > now ? (uint32_t)(timer->end_time - now) : 0);
+}
+
+/**
+ * @brief Get the current time
+ *
+ * Returns the tick source in milliseconds, used as time base by the timers.
+ *
+ * @return uint64_t - current time in milliseconds, never wraps
+ */
+uint64_t current_time_ms(void) {
+	return getTimeInMillis();
 }
 
 /**
@@ -135,7 +199,6 @@ uint32_t left_ms(Timer *timer) {
  */
 void init_timer(Timer *timer) {
 	timer->end_time = 0;
-	timer->offset = 0;
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,166 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/**
+ * @file timer_heap.c
+ * @brief implementation of the timer heap.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "timer_heap.h"
+
+
+/**
+ * \brief Deadline comparison, the 64-bit time base never wraps.
+ *
+ * \return true if a is before b.
+ */
+static bool is_before(uint64_t a, uint64_t b)
+{
+	return (a < b);
+}
+
+static void heap_set(timer_heap_t *heap, uint16_t index, timer_heap_node_t *node)
+{
+	heap->pp_nodes[index] = node;
+	node->index = index;
+}
+
+static void sift_up(timer_heap_t *heap, uint16_t index)
+{
+	timer_heap_node_t *node = heap->pp_nodes[index];
+
+	while (index > 0) {
+		uint16_t parent = (index - 1) / 2;
+
+		if (!is_before(node->deadline, heap->pp_nodes[parent]->deadline)) {
+			break;
+		}
+		heap_set(heap, index, heap->pp_nodes[parent]);
+		index = parent;
+	}
+	heap_set(heap, index, node);
+}
+
+static void sift_down(timer_heap_t *heap, uint16_t index)
+{
+	timer_heap_node_t *node = heap->pp_nodes[index];
+
+	while (true) {
+		uint16_t child = 2 * index + 1;
+
+		if (child >= heap->count) {
+			break;
+		}
+		if ((child + 1 < heap->count)
+		&& is_before(heap->pp_nodes[child + 1]->deadline,
+				heap->pp_nodes[child]->deadline)) {
+			child++;
+		}
+		if (!is_before(heap->pp_nodes[child]->deadline, node->deadline)) {
+			break;
+		}
+		heap_set(heap, index, heap->pp_nodes[child]);
+		index = child;
+	}
+	heap_set(heap, index, node);
+}
+
+void timer_heap_node_init(timer_heap_node_t *node) {
+	node->deadline = 0;
+	node->index = TIMER_HEAP_INVALID_INDEX;
+}
+
+bool timer_heap_node_is_armed(timer_heap_node_t const *node) {
+	return (node->index != TIMER_HEAP_INVALID_INDEX);
+}
+
+bool timer_heap_insert(timer_heap_t *heap, timer_heap_node_t *node,
+		uint64_t deadline) {
+	timer_heap_remove(heap, node);
+
+	if (heap->count >= heap->capacity) {
+		return false;
+	}
+
+	node->deadline = deadline;
+	heap->pp_nodes[heap->count] = node;
+	sift_up(heap, heap->count++);
+
+	return true;
+}
+
+void timer_heap_remove(timer_heap_t *heap, timer_heap_node_t *node) {
+	uint16_t index = node->index;
+
+	if (index == TIMER_HEAP_INVALID_INDEX) {
+		return;
+	}
+
+	node->index = TIMER_HEAP_INVALID_INDEX;
+
+	if (index == --heap->count) {
+		return;
+	}
+
+	/* Move the last node in the hole and restore the heap order */
+	timer_heap_node_t *last = heap->pp_nodes[heap->count];
+
+	heap_set(heap, index, last);
+	sift_down(heap, index);
+	sift_up(heap, last->index);
+}
+
+timer_heap_node_t * timer_heap_peek(timer_heap_t *heap) {
+	return (heap->count > 0) ? heap->pp_nodes[0] : NULL;
+}
+
+timer_heap_node_t * timer_heap_pop_expired(timer_heap_t *heap, uint64_t now) {
+	timer_heap_node_t *node = timer_heap_peek(heap);
+
+	if ((node == NULL) || is_before(now, node->deadline)) {
+		return NULL;
+	}
+
+	timer_heap_remove(heap, node);
+
+	return node;
+}
+
+#ifdef __cplusplus
+}
+#endif
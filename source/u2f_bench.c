@@ -0,0 +1,846 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nrf.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+#include "fds.h"
+#include "nrf_cli.h"
+
+#include "nrf_crypto.h"
+#include "nrf_crypto_error.h"
+
+#include "u2f.h"
+#include "u2f_crypto.h"
+#include "u2f_key_handle.h"
+#include "u2f_stats.h"
+#include "u2f_worker.h"
+
+#include "sdk_config.h"
+
+
+/**
+ * @brief Iterations run when the command line does not give a count.
+ */
+#define BENCH_ITERATIONS_DEFAULT    100
+
+/**
+ * @brief Iterations allowed on the command line.
+ */
+#define BENCH_ITERATIONS_MAX        10000
+
+/* File ID and Key of the record updated by the flash benchmark, apart from
+ * the U2F records. */
+#define BENCH_FILE              (0xEF1F)
+#define BENCH_REC_KEY           (0x7F1F)
+
+/* Size of the data signed by AUTHENTICATE, appId, flags, counter and
+ * challenge. */
+#define BENCH_AUTH_DATA_SIZE    69
+
+
+/**
+ * @brief Cycle counts of the iterations of an operation.
+ */
+typedef struct
+{
+    uint32_t count;                 //!< Iterations measured.
+    uint32_t min;                   //!< Fastest iteration in cycles.
+    uint32_t max;                   //!< Slowest iteration in cycles.
+    uint64_t total;                 //!< Sum of the iterations in cycles.
+} bench_result_t;
+
+
+/**
+ * @brief Sizes of the SHA-256 benchmark, in bytes, with the data signed by
+ *        AUTHENTICATE (69) and REGISTER (194).
+ */
+static uint16_t const m_hash_sizes[] = { 32, 64, 69, 128, 194, 256, 512, 1024 };
+
+static uint8_t m_hash_data[1024];
+
+static bool volatile m_fds_done;
+
+static ret_code_t volatile m_fds_result;
+
+static bool volatile m_fds_gc_done;
+
+static ret_code_t volatile m_fds_gc_result;
+
+static bool m_fds_registered;
+
+static fds_record_desc_t m_bench_record_desc;
+
+static uint32_t m_bench_record_data;
+
+static fds_record_t const m_bench_record =
+{
+    .file_id           = BENCH_FILE,
+    .key               = BENCH_REC_KEY,
+    .data.p_data       = &m_bench_record_data,
+    /* The length of a record is always expressed in 4-byte units (words). */
+    .data.length_words = sizeof(m_bench_record_data) / sizeof(uint32_t),
+};
+
+
+/**
+ * @brief Let the jobs submitted since the last call run.
+ *
+ * A benchmark holds the worker back, see BENCH_CMD_DEF: a job preempting
+ * a timed call would add to its time, and find CC310 or the RNG busy.
+ * Called before each iteration, so that the requests are only delayed by
+ * one iteration.
+ */
+static void bench_yield(void)
+{
+    u2f_worker_resume();
+    u2f_worker_suspend();
+}
+
+
+/**
+ * @brief Convert CPU cycles to microseconds.
+ */
+static uint32_t cycles_to_us(uint64_t cycles)
+{
+    return (uint32_t)((cycles * 1000000) / SystemCoreClock);
+}
+
+
+static void result_init(bench_result_t * p_result)
+{
+    p_result->count = 0;
+    p_result->min = UINT32_MAX;
+    p_result->max = 0;
+    p_result->total = 0;
+}
+
+
+static void result_add_cycles(bench_result_t * p_result, uint32_t cycles)
+{
+    p_result->count++;
+    p_result->total += cycles;
+    p_result->min = MIN(p_result->min, cycles);
+    p_result->max = MAX(p_result->max, cycles);
+}
+
+
+static void result_add(bench_result_t * p_result, uint32_t start)
+{
+    result_add_cycles(p_result, u2f_stats_cycles_get() - start);
+}
+
+
+static void result_header_print(nrf_cli_t const * p_cli)
+{
+    nrf_cli_fprintf(p_cli, NRF_CLI_INFO, "%-16s %-10s %6s %10s %10s %10s %10s\r\n",
+                    "operation", "backend", "count", "avg cyc", "avg us",
+                    "min us", "max us");
+}
+
+
+static void result_print(nrf_cli_t const * p_cli, char const * p_name,
+                         char const * p_backend, bench_result_t const * p_result)
+{
+    if(p_result->count == 0) return;
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-16s %-10s %6u %10u %10u %10u %10u\r\n",
+                    p_name, p_backend, p_result->count,
+                    (uint32_t)(p_result->total / p_result->count),
+                    cycles_to_us(p_result->total / p_result->count),
+                    cycles_to_us(p_result->min),
+                    cycles_to_us(p_result->max));
+}
+
+
+static void error_print(nrf_cli_t const * p_cli, char const * p_name,
+                        ret_code_t ret)
+{
+    nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "%s failed: 0x%04x (%s)\r\n",
+                    p_name, (unsigned)ret, nrf_crypto_error_string_get(ret));
+}
+
+
+/**
+ * @brief Parse the iteration count, the optional argument of the commands.
+ *
+ * @return Iteration count, 0 if the argument is invalid.
+ */
+static uint32_t iterations_get(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if(argc < 2)
+    {
+        return BENCH_ITERATIONS_DEFAULT;
+    }
+
+    char * p_end;
+    unsigned long count = strtoul(argv[1], &p_end, 10);
+
+    if(*p_end != '\0' || count == 0 || count > BENCH_ITERATIONS_MAX)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR,
+                        "%s: iterations must be 1 to %u\r\n",
+                        argv[0], BENCH_ITERATIONS_MAX);
+        return 0;
+    }
+
+    return (uint32_t)count;
+}
+
+
+/**
+ * @brief Name of the backend an operation is routed to.
+ */
+static char const * backend_name(u2f_crypto_op_t op)
+{
+    return u2f_crypto_backend_name(u2f_crypto_backend_get(op));
+}
+
+
+/**
+ * @brief Name of the backend signing with an algorithm.
+ */
+static char const * alg_backend_name(u2f_crypto_alg_t alg)
+{
+    return backend_name((alg == U2F_CRYPTO_ALG_ED25519) ? U2F_CRYPTO_OP_EDDSA :
+                                                          U2F_CRYPTO_OP_SIGN);
+}
+
+
+static void bench_keygen(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    uint8_t private_key[U2F_CRYPTO_PRIVATE_KEY_SIZE];
+    uint8_t public_key[U2F_CRYPTO_PUBLIC_KEY_SIZE];
+    bench_result_t result;
+    ret_code_t ret = NRF_SUCCESS;
+
+    result_init(&result);
+
+    for(uint32_t i = 0; i < iterations; i++)
+    {
+        bench_yield();
+        uint32_t start = u2f_stats_cycles_get();
+        ret = u2f_crypto_keygen(private_key, public_key);
+        if(ret != NRF_SUCCESS) break;
+        result_add(&result, start);
+    }
+
+    if(ret != NRF_SUCCESS)
+    {
+        error_print(p_cli, "keygen", ret);
+    }
+    result_print(p_cli, "keygen", backend_name(U2F_CRYPTO_OP_KEYGEN), &result);
+}
+
+
+static void bench_sign(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    uint8_t private_key[U2F_CRYPTO_PRIVATE_KEY_SIZE];
+    uint8_t public_key[U2F_CRYPTO_PUBLIC_KEY_SIZE];
+    uint8_t hash[U2F_CRYPTO_HASH_SIZE];
+    bench_result_t result;
+    ret_code_t ret;
+
+    result_init(&result);
+
+    ret = u2f_crypto_keygen(private_key, public_key);
+    if(ret != NRF_SUCCESS)
+    {
+        error_print(p_cli, "keygen", ret);
+        return;
+    }
+
+    memset(hash, 0xA5, sizeof(hash));
+
+    for(uint32_t i = 0; i < iterations; i++)
+    {
+        bench_yield();
+        uint8_t signature[U2F_CRYPTO_SIGNATURE_SIZE];
+
+        uint32_t start = u2f_stats_cycles_get();
+        ret = u2f_crypto_sign(private_key, hash, signature);
+        if(ret != NRF_SUCCESS) break;
+        result_add(&result, start);
+    }
+
+    if(ret != NRF_SUCCESS)
+    {
+        error_print(p_cli, "sign", ret);
+    }
+    result_print(p_cli, "ecdsa sign", backend_name(U2F_CRYPTO_OP_SIGN), &result);
+}
+
+
+static void bench_hash_sizes(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    ret_code_t ret = NRF_SUCCESS;
+
+    for(size_t s = 0; s < ARRAY_SIZE(m_hash_sizes) && ret == NRF_SUCCESS; s++)
+    {
+        u2f_crypto_chunk_t const chunk = { m_hash_data, m_hash_sizes[s] };
+        uint8_t digest[U2F_CRYPTO_HASH_SIZE];
+        bench_result_t result;
+        char name[20];
+
+        result_init(&result);
+
+        for(uint32_t i = 0; i < iterations; i++)
+        {
+            bench_yield();
+            uint32_t start = u2f_stats_cycles_get();
+            ret = u2f_crypto_hash(&chunk, 1, digest);
+            if(ret != NRF_SUCCESS) break;
+            result_add(&result, start);
+        }
+
+        if(ret != NRF_SUCCESS)
+        {
+            error_print(p_cli, "sha256", ret);
+        }
+        snprintf(name, sizeof(name), "sha256 %u B", m_hash_sizes[s]);
+        result_print(p_cli, name, backend_name(U2F_CRYPTO_OP_HASH), &result);
+    }
+}
+
+
+/**
+ * @brief Time the hash on every backend that provides it.
+ *
+ * Without the threshold that sends the short hashes to oberon, so that the
+ * rows compare the backends, then restores it and the routing.
+ */
+static void bench_hash(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    u2f_crypto_backend_id_t saved = u2f_crypto_backend_get(U2F_CRYPTO_OP_HASH);
+    size_t threshold = u2f_crypto_hash_threshold_get();
+
+    for(size_t i = 0; i < sizeof(m_hash_data); i++)
+    {
+        m_hash_data[i] = (uint8_t)i;
+    }
+
+    u2f_crypto_hash_threshold_set(0);
+
+    for(uint32_t b = 0; b < U2F_CRYPTO_BACKEND_COUNT; b++)
+    {
+        if(u2f_crypto_backend_select(U2F_CRYPTO_OP_HASH,
+                                     (u2f_crypto_backend_id_t)b) == NRF_SUCCESS)
+        {
+            bench_hash_sizes(p_cli, iterations);
+        }
+    }
+
+    UNUSED_RETURN_VALUE(u2f_crypto_backend_select(U2F_CRYPTO_OP_HASH, saved));
+    u2f_crypto_hash_threshold_set(threshold);
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_OBERON)
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "hashes below %u B go to oberon\r\n",
+                    (unsigned)threshold);
+#endif
+}
+
+
+static void bench_aes(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    uint8_t plain[U2F_MAX_KH_SIZE];
+    uint8_t cipher[U2F_MAX_KH_SIZE];
+    bench_result_t wrap, unwrap;
+    ret_code_t ret;
+
+    result_init(&wrap);
+    result_init(&unwrap);
+
+    /* Under the key handle key loaded by u2f_impl_init() */
+    memset(plain, 0x5A, sizeof(plain));
+
+    for(uint32_t i = 0; i < iterations; i++)
+    {
+        bench_yield();
+        uint32_t start = u2f_stats_cycles_get();
+        ret = u2f_crypto_wrap(plain, cipher, sizeof(plain));
+        if(ret != NRF_SUCCESS) break;
+        result_add(&wrap, start);
+
+        start = u2f_stats_cycles_get();
+        ret = u2f_crypto_unwrap(cipher, plain, sizeof(cipher));
+        if(ret != NRF_SUCCESS) break;
+        result_add(&unwrap, start);
+    }
+
+    if(ret != NRF_SUCCESS)
+    {
+        error_print(p_cli, "aes", ret);
+    }
+    result_print(p_cli, "aes-ecb wrap", backend_name(U2F_CRYPTO_OP_WRAP), &wrap);
+    result_print(p_cli, "aes-ecb unwrap", backend_name(U2F_CRYPTO_OP_WRAP), &unwrap);
+}
+
+
+/**
+ * @brief Time u2f_crypto_sign_batch() with 1 to U2F_CRYPTO_SIGN_BATCH_MAX
+ *        signatures, on every backend that signs, per signature.
+ *
+ * Each signature has its own key. The routing is restored afterwards.
+ */
+static void bench_batch(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    static uint8_t private_keys[U2F_CRYPTO_SIGN_BATCH_MAX][U2F_CRYPTO_PRIVATE_KEY_SIZE];
+    static uint8_t signatures[U2F_CRYPTO_SIGN_BATCH_MAX][U2F_CRYPTO_SIGNATURE_SIZE];
+    u2f_crypto_sign_req_t reqs[U2F_CRYPTO_SIGN_BATCH_MAX];
+    u2f_crypto_backend_id_t saved = u2f_crypto_backend_get(U2F_CRYPTO_OP_SIGN);
+    uint8_t hash[U2F_CRYPTO_HASH_SIZE];
+    ret_code_t ret = NRF_SUCCESS;
+
+    memset(hash, 0xA5, sizeof(hash));
+
+    for(size_t i = 0; i < U2F_CRYPTO_SIGN_BATCH_MAX && ret == NRF_SUCCESS; i++)
+    {
+        uint8_t public_key[U2F_CRYPTO_PUBLIC_KEY_SIZE];
+
+        ret = u2f_crypto_keygen(private_keys[i], public_key);
+
+        reqs[i].p_private_key = private_keys[i];
+        reqs[i].p_hash = hash;
+        reqs[i].p_signature = signatures[i];
+    }
+
+    if(ret != NRF_SUCCESS)
+    {
+        error_print(p_cli, "keygen", ret);
+        return;
+    }
+
+    for(uint32_t b = 0; b < U2F_CRYPTO_BACKEND_COUNT && ret == NRF_SUCCESS; b++)
+    {
+        if(u2f_crypto_backend_select(U2F_CRYPTO_OP_SIGN,
+                                     (u2f_crypto_backend_id_t)b) != NRF_SUCCESS)
+        {
+            continue;
+        }
+
+        for(size_t count = 1; count <= U2F_CRYPTO_SIGN_BATCH_MAX; count *= 2)
+        {
+            bench_result_t result;
+            char name[20];
+
+            result_init(&result);
+
+            for(uint32_t i = 0; i < iterations; i++)
+            {
+                bench_yield();
+                uint32_t start = u2f_stats_cycles_get();
+                ret = u2f_crypto_sign_batch(reqs, count);
+                if(ret != NRF_SUCCESS) break;
+                result_add_cycles(&result, (u2f_stats_cycles_get() - start) / count);
+            }
+
+            if(ret != NRF_SUCCESS)
+            {
+                error_print(p_cli, "sign batch", ret);
+                break;
+            }
+            snprintf(name, sizeof(name), "batch %u / sig", (unsigned)count);
+            result_print(p_cli, name, backend_name(U2F_CRYPTO_OP_SIGN), &result);
+        }
+    }
+
+    UNUSED_RETURN_VALUE(u2f_crypto_backend_select(U2F_CRYPTO_OP_SIGN, saved));
+
+    memset(private_keys, 0, sizeof(private_keys));
+}
+
+
+/**
+ * @brief Time the key handles of both schemes, and of Ed25519.
+ *
+ * "create" is the key pair and the key handle of a registration, "open"
+ * the private key from the key handle, and "auth" the opening followed by
+ * the hash and the signature of an authentication, without the counter
+ * update, which is the same for all.
+ */
+static void bench_handle(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    static struct
+    {
+        u2f_key_handle_scheme_t scheme;
+        u2f_crypto_alg_t        alg;
+        char const *            p_name;
+    } const schemes[] =
+    {
+        { U2F_KEY_HANDLE_AES,  U2F_CRYPTO_ALG_ES256,   "aes"     },
+        { U2F_KEY_HANDLE_HMAC, U2F_CRYPTO_ALG_ES256,   "hmac"    },
+        { U2F_KEY_HANDLE_HMAC, U2F_CRYPTO_ALG_ED25519, "ed25519" },
+    };
+    uint8_t app_id[U2F_APPID_SIZE];
+    ret_code_t ret = NRF_SUCCESS;
+
+    memset(app_id, 0x3C, sizeof(app_id));
+
+    for(size_t s = 0; s < ARRAY_SIZE(schemes) && ret == NRF_SUCCESS; s++)
+    {
+        uint8_t private_key[U2F_CRYPTO_PRIVATE_KEY_SIZE];
+        uint8_t public_key[U2F_CRYPTO_PUBLIC_KEY_SIZE];
+        uint8_t handle[U2F_MAX_KH_SIZE];
+        uint8_t handle_size;
+        u2f_crypto_alg_t alg;
+        bench_result_t create, open, auth;
+        char name[20];
+
+        result_init(&create);
+        result_init(&open);
+        result_init(&auth);
+
+        for(uint32_t i = 0; i < iterations; i++)
+        {
+            bench_yield();
+            uint8_t signature[U2F_CRYPTO_SIGNATURE_SIZE];
+
+            uint32_t start = u2f_stats_cycles_get();
+            ret = u2f_key_handle_keygen(schemes[s].scheme, schemes[s].alg,
+                                        app_id, private_key, public_key,
+                                        handle);
+            if(ret != NRF_SUCCESS) break;
+            ret = u2f_key_handle_wrap(schemes[s].scheme, app_id, private_key,
+                                      handle, &handle_size);
+            if(ret != NRF_SUCCESS) break;
+            result_add(&create, start);
+
+            start = u2f_stats_cycles_get();
+            ret = u2f_key_handle_open(app_id, handle, handle_size, private_key,
+                                      &alg);
+            if(ret != NRF_SUCCESS) break;
+            result_add(&open, start);
+            ret = u2f_crypto_alg_sign(alg, private_key, m_hash_data,
+                                      BENCH_AUTH_DATA_SIZE, signature);
+            if(ret != NRF_SUCCESS) break;
+            result_add(&auth, start);
+        }
+
+        if(ret != NRF_SUCCESS)
+        {
+            error_print(p_cli, schemes[s].p_name, ret);
+        }
+        snprintf(name, sizeof(name), "%s create", schemes[s].p_name);
+        result_print(p_cli, name, backend_name(U2F_CRYPTO_OP_WRAP), &create);
+        snprintf(name, sizeof(name), "%s open", schemes[s].p_name);
+        result_print(p_cli, name, backend_name(U2F_CRYPTO_OP_WRAP), &open);
+        snprintf(name, sizeof(name), "%s auth", schemes[s].p_name);
+        result_print(p_cli, name, alg_backend_name(schemes[s].alg), &auth);
+    }
+}
+
+
+/**
+ * @brief Time the key pair generation and the signature of the data of an
+ *        authentication, ES256 against Ed25519.
+ *
+ * The ES256 signature includes the hash, as Ed25519 hashes inside.
+ */
+static void bench_alg(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    static char const * const names[U2F_CRYPTO_ALG_COUNT][2] =
+    {
+        [U2F_CRYPTO_ALG_ES256]   = { "es256 keygen",   "es256 sign"   },
+        [U2F_CRYPTO_ALG_ED25519] = { "ed25519 keygen", "ed25519 sign" },
+    };
+
+    for(uint32_t alg = 0; alg < U2F_CRYPTO_ALG_COUNT; alg++)
+    {
+        uint8_t private_key[U2F_CRYPTO_PRIVATE_KEY_SIZE];
+        uint8_t public_key[U2F_CRYPTO_PUBLIC_KEY_SIZE];
+        uint8_t signature[U2F_CRYPTO_SIGNATURE_SIZE];
+        bench_result_t keygen, sign;
+        ret_code_t ret = NRF_SUCCESS;
+
+        result_init(&keygen);
+        result_init(&sign);
+
+        for(uint32_t i = 0; i < iterations; i++)
+        {
+            bench_yield();
+            uint32_t start = u2f_stats_cycles_get();
+            ret = u2f_crypto_alg_keygen((u2f_crypto_alg_t)alg, private_key,
+                                        public_key);
+            if(ret != NRF_SUCCESS) break;
+            result_add(&keygen, start);
+
+            start = u2f_stats_cycles_get();
+            ret = u2f_crypto_alg_sign((u2f_crypto_alg_t)alg, private_key,
+                                      m_hash_data, BENCH_AUTH_DATA_SIZE, signature);
+            if(ret != NRF_SUCCESS) break;
+            result_add(&sign, start);
+        }
+
+        memset(private_key, 0, sizeof(private_key));
+
+        if(ret != NRF_SUCCESS)
+        {
+            error_print(p_cli, names[alg][0], ret);
+        }
+        result_print(p_cli, names[alg][0], alg_backend_name((u2f_crypto_alg_t)alg),
+                     &keygen);
+        result_print(p_cli, names[alg][1], alg_backend_name((u2f_crypto_alg_t)alg),
+                     &sign);
+    }
+}
+
+
+/**
+ * @brief Run the keygen and sign benchmarks on every backend providing them.
+ *
+ * The routing is restored afterwards.
+ */
+static void bench_compare(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    static u2f_crypto_op_t const ops[] = { U2F_CRYPTO_OP_KEYGEN, U2F_CRYPTO_OP_SIGN };
+
+    for(size_t i = 0; i < ARRAY_SIZE(ops); i++)
+    {
+        u2f_crypto_backend_id_t saved = u2f_crypto_backend_get(ops[i]);
+
+        for(uint32_t b = 0; b < U2F_CRYPTO_BACKEND_COUNT; b++)
+        {
+            if(u2f_crypto_backend_select(ops[i], (u2f_crypto_backend_id_t)b) != NRF_SUCCESS)
+            {
+                continue;
+            }
+
+            if(ops[i] == U2F_CRYPTO_OP_KEYGEN)
+            {
+                bench_keygen(p_cli, iterations);
+            }
+            else
+            {
+                bench_sign(p_cli, iterations);
+            }
+        }
+
+        UNUSED_RETURN_VALUE(u2f_crypto_backend_select(ops[i], saved));
+    }
+}
+
+
+static void fds_evt_handler(fds_evt_t const * p_evt)
+{
+    if((p_evt->id == FDS_EVT_WRITE || p_evt->id == FDS_EVT_UPDATE) &&
+       p_evt->write.file_id == BENCH_FILE)
+    {
+        m_fds_result = p_evt->result;
+        m_fds_done = true;
+    }
+    else if(p_evt->id == FDS_EVT_GC)
+    {
+        m_fds_gc_result = p_evt->result;
+        m_fds_gc_done = true;
+    }
+}
+
+
+/**
+ * @brief Run a garbage collection, and wait for it to complete.
+ */
+static ret_code_t fds_bench_gc(void)
+{
+    ret_code_t ret;
+
+    m_fds_gc_done = false;
+
+    ret = fds_gc();
+    if(ret != FDS_SUCCESS) return ret;
+
+    while(!m_fds_gc_done)
+    {
+        // Just waiting
+    }
+
+    return m_fds_gc_result;
+}
+
+
+/**
+ * @brief Write or update the benchmark record, and wait for the result.
+ *
+ * Garbage collects once if the flash is full.
+ */
+static ret_code_t fds_bench_record_store(void)
+{
+    ret_code_t ret;
+
+    m_fds_done = false;
+
+    if(m_bench_record_desc.record_id == 0)
+    {
+        ret = fds_record_write(&m_bench_record_desc, &m_bench_record);
+    }
+    else
+    {
+        ret = fds_record_update(&m_bench_record_desc, &m_bench_record);
+        if(ret == FDS_ERR_NO_SPACE_IN_FLASH && fds_bench_gc() == FDS_SUCCESS)
+        {
+            ret = fds_record_update(&m_bench_record_desc, &m_bench_record);
+        }
+    }
+    if(ret != FDS_SUCCESS) return ret;
+
+    while(!m_fds_done)
+    {
+        // Just waiting
+    }
+
+    return m_fds_result;
+}
+
+
+static void bench_fds(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    fds_find_token_t tok = {0};
+    bench_result_t result;
+    ret_code_t ret;
+
+    result_init(&result);
+
+    if(!m_fds_registered)
+    {
+        ret = fds_register(fds_evt_handler);
+        if(ret != FDS_SUCCESS)
+        {
+            error_print(p_cli, "fds_register", ret);
+            return;
+        }
+        m_fds_registered = true;
+    }
+
+    memset(&m_bench_record_desc, 0, sizeof(m_bench_record_desc));
+    if(fds_record_find(BENCH_FILE, BENCH_REC_KEY, &m_bench_record_desc,
+                       &tok) != FDS_SUCCESS)
+    {
+        ret = fds_bench_record_store();
+        if(ret != FDS_SUCCESS)
+        {
+            error_print(p_cli, "fds write", ret);
+            return;
+        }
+    }
+
+    for(uint32_t i = 0; i < iterations; i++)
+    {
+        bench_yield();
+        m_bench_record_data = i;
+
+        uint32_t start = u2f_stats_cycles_get();
+        ret = fds_bench_record_store();
+        if(ret != FDS_SUCCESS) break;
+        result_add(&result, start);
+    }
+
+    if(ret != FDS_SUCCESS)
+    {
+        error_print(p_cli, "fds update", ret);
+    }
+    result_print(p_cli, "fds update", "flash", &result);
+}
+
+
+/**
+ * @brief Define the handler of a benchmark subcommand.
+ */
+#define BENCH_CMD_DEF(name)                                                 \
+static void cmd_bench_##name(nrf_cli_t const * p_cli, size_t argc,          \
+                             char ** argv)                                  \
+{                                                                           \
+    if(nrf_cli_help_requested(p_cli))                                       \
+    {                                                                       \
+        nrf_cli_help_print(p_cli, NULL, 0);                                 \
+        return;                                                             \
+    }                                                                       \
+                                                                            \
+    uint32_t iterations = iterations_get(p_cli, argc, argv);                \
+    if(iterations == 0) return;                                             \
+                                                                            \
+    result_header_print(p_cli);                                             \
+    u2f_worker_suspend();                                                   \
+    bench_##name(p_cli, iterations);                                        \
+    u2f_worker_resume();                                                    \
+}
+
+BENCH_CMD_DEF(keygen)
+BENCH_CMD_DEF(sign)
+BENCH_CMD_DEF(hash)
+BENCH_CMD_DEF(aes)
+BENCH_CMD_DEF(handle)
+BENCH_CMD_DEF(batch)
+BENCH_CMD_DEF(alg)
+BENCH_CMD_DEF(fds)
+BENCH_CMD_DEF(compare)
+
+
+static void bench_all(nrf_cli_t const * p_cli, uint32_t iterations)
+{
+    bench_keygen(p_cli, iterations);
+    bench_sign(p_cli, iterations);
+    bench_hash(p_cli, iterations);
+    bench_aes(p_cli, iterations);
+    bench_handle(p_cli, iterations);
+    bench_alg(p_cli, iterations);
+    bench_fds(p_cli, iterations);
+}
+
+BENCH_CMD_DEF(all)
+
+
+static void cmd_bench(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    nrf_cli_help_print(p_cli, NULL, 0);
+}
+
+
+NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_sub_bench)
+{
+    NRF_CLI_CMD(keygen, NULL, "Time P-256 key pair generation: bench keygen [n]", cmd_bench_keygen),
+    NRF_CLI_CMD(sign,   NULL, "Time ECDSA P-256 signing: bench sign [n]", cmd_bench_sign),
+    NRF_CLI_CMD(hash,   NULL, "Time SHA-256 over 32 to 1024 bytes on every backend: bench hash [n]", cmd_bench_hash),
+    NRF_CLI_CMD(aes,    NULL, "Time AES-ECB key handle wrap and unwrap: bench aes [n]", cmd_bench_aes),
+    NRF_CLI_CMD(handle, NULL, "Time the AES and HMAC key handles and authenticate: bench handle [n]", cmd_bench_handle),
+    NRF_CLI_CMD(batch,  NULL, "Time batch ECDSA signing per signature, 1 to 8 at once: bench batch [n]", cmd_bench_batch),
+    NRF_CLI_CMD(alg,    NULL, "Time ES256 and Ed25519 keygen and sign: bench alg [n]", cmd_bench_alg),
+    NRF_CLI_CMD(fds,    NULL, "Time flash record updates: bench fds [n]", cmd_bench_fds),
+    NRF_CLI_CMD(compare, NULL, "Time keygen and sign on every backend: bench compare [n]", cmd_bench_compare),
+    NRF_CLI_CMD(all,    NULL, "Run all the benchmarks: bench all [n]", cmd_bench_all),
+    NRF_CLI_SUBCMD_SET_END
+};
+
+NRF_CLI_CMD_REGISTER(bench, &m_sub_bench, "Crypto and flash microbenchmarks, on an idle key", cmd_bench);
@@ -0,0 +1,848 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_util.h"
+#include "nrf_cli.h"
+#include "nrf_crypto.h"
+
+#include "u2f_crypto.h"
+#include "u2f_crypto_backend.h"
+#include "u2f_crypto_comb.h"
+#include "u2f_entropy.h"
+#include "u2f_power.h"
+#include "u2f_stats.h"
+#include "u2f_worker.h"
+
+#include "sdk_config.h"
+
+
+#ifndef U2F_CRYPTO_CONFIG_KEYGEN_BACKEND
+#define U2F_CRYPTO_CONFIG_KEYGEN_BACKEND    U2F_CRYPTO_BACKEND_CC310
+#endif
+#ifndef U2F_CRYPTO_CONFIG_SIGN_BACKEND
+#define U2F_CRYPTO_CONFIG_SIGN_BACKEND      U2F_CRYPTO_BACKEND_CC310
+#endif
+#ifndef U2F_CRYPTO_CONFIG_HASH_BACKEND
+#define U2F_CRYPTO_CONFIG_HASH_BACKEND      U2F_CRYPTO_BACKEND_CC310
+#endif
+#ifndef U2F_CRYPTO_CONFIG_WRAP_BACKEND
+#define U2F_CRYPTO_CONFIG_WRAP_BACKEND      U2F_CRYPTO_BACKEND_CC310
+#endif
+#ifndef U2F_CRYPTO_CONFIG_EDDSA_BACKEND
+#define U2F_CRYPTO_CONFIG_EDDSA_BACKEND     U2F_CRYPTO_BACKEND_CC310
+#endif
+#ifndef U2F_CRYPTO_HASH_SW_THRESHOLD
+#define U2F_CRYPTO_HASH_SW_THRESHOLD        0
+#endif
+
+/**
+ * @brief Runs of each size timed by u2f_crypto_hash_threshold_measure(),
+ *        the fastest counts.
+ */
+#define HASH_MEASURE_RUNS                   3
+
+/**
+ * @brief Block size of SHA-256, which the HMAC pads the key to.
+ */
+#define SHA256_BLOCK_SIZE                   64
+
+
+/**
+ * @brief Backends built in, NULL for the others.
+ */
+static u2f_crypto_backend_t const * const m_backends[U2F_CRYPTO_BACKEND_COUNT] =
+{
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_CC310)
+    [U2F_CRYPTO_BACKEND_CC310]     = &g_u2f_crypto_cc310,
+#endif
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_MICRO_ECC)
+    [U2F_CRYPTO_BACKEND_MICRO_ECC] = &g_u2f_crypto_micro_ecc,
+#endif
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_HOST)
+    [U2F_CRYPTO_BACKEND_HOST]      = &g_u2f_crypto_host,
+#endif
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_COMB)
+    [U2F_CRYPTO_BACKEND_COMB]      = &g_u2f_crypto_comb,
+#endif
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_OBERON)
+    [U2F_CRYPTO_BACKEND_OBERON]    = &g_u2f_crypto_oberon,
+#endif
+};
+
+
+/**
+ * @brief Backend names, also for those not built in.
+ */
+static char const * const m_backend_names[U2F_CRYPTO_BACKEND_COUNT] =
+{
+    [U2F_CRYPTO_BACKEND_CC310]     = "cc310",
+    [U2F_CRYPTO_BACKEND_MICRO_ECC] = "micro-ecc",
+    [U2F_CRYPTO_BACKEND_HOST]      = "host",
+    [U2F_CRYPTO_BACKEND_COMB]      = "comb",
+    [U2F_CRYPTO_BACKEND_OBERON]    = "oberon",
+};
+
+
+/**
+ * @brief Operation names, for the CLI.
+ */
+static char const * const m_op_names[U2F_CRYPTO_OP_COUNT] =
+{
+    [U2F_CRYPTO_OP_KEYGEN] = "keygen",
+    [U2F_CRYPTO_OP_SIGN]   = "sign",
+    [U2F_CRYPTO_OP_HASH]   = "hash",
+    [U2F_CRYPTO_OP_WRAP]   = "wrap",
+    [U2F_CRYPTO_OP_EDDSA]  = "eddsa",
+};
+
+
+/**
+ * @brief Backend of each operation.
+ *
+ * Read by the worker and written from the CLI, a word is written at once.
+ */
+static u2f_crypto_backend_t const * volatile m_selected[U2F_CRYPTO_OP_COUNT];
+
+static u2f_crypto_backend_id_t volatile m_selected_id[U2F_CRYPTO_OP_COUNT];
+
+/**
+ * @brief Hashes shorter than this go to Oberon.
+ */
+static size_t volatile m_hash_sw_threshold;
+
+
+/**
+ * @brief Tell whether @p p_backend provides @p op.
+ */
+static bool backend_has_op(u2f_crypto_backend_t const * p_backend,
+                           u2f_crypto_op_t op)
+{
+    if(p_backend == NULL) return false;
+
+    switch(op)
+    {
+        case U2F_CRYPTO_OP_KEYGEN: return p_backend->keygen != NULL;
+        case U2F_CRYPTO_OP_SIGN:   return p_backend->sign != NULL;
+        case U2F_CRYPTO_OP_HASH:   return p_backend->hash != NULL;
+        case U2F_CRYPTO_OP_WRAP:   return p_backend->wrap_key_set != NULL &&
+                                          p_backend->wrap != NULL &&
+                                          p_backend->unwrap != NULL &&
+                                          p_backend->mac != NULL;
+        case U2F_CRYPTO_OP_EDDSA:  return p_backend->eddsa_public_key != NULL &&
+                                          p_backend->eddsa_sign != NULL;
+        default:                   return false;
+    }
+}
+
+
+ret_code_t u2f_crypto_init(void)
+{
+    static u2f_crypto_backend_id_t const defaults[U2F_CRYPTO_OP_COUNT] =
+    {
+        [U2F_CRYPTO_OP_KEYGEN] = U2F_CRYPTO_CONFIG_KEYGEN_BACKEND,
+        [U2F_CRYPTO_OP_SIGN]   = U2F_CRYPTO_CONFIG_SIGN_BACKEND,
+        [U2F_CRYPTO_OP_HASH]   = U2F_CRYPTO_CONFIG_HASH_BACKEND,
+        [U2F_CRYPTO_OP_WRAP]   = U2F_CRYPTO_CONFIG_WRAP_BACKEND,
+        [U2F_CRYPTO_OP_EDDSA]  = U2F_CRYPTO_CONFIG_EDDSA_BACKEND,
+    };
+    ret_code_t ret;
+
+    ret = nrf_crypto_init();
+    if(ret != NRF_SUCCESS) return ret;
+
+#if NRF_MODULE_ENABLED(U2F_ENTROPY)
+    ret = u2f_entropy_init();
+    if(ret != NRF_SUCCESS) return ret;
+#endif
+
+#if NRF_MODULE_ENABLED(U2F_POWER)
+    ret = u2f_power_init();
+    if(ret != NRF_SUCCESS) return ret;
+#endif
+
+    for(uint32_t i = 0; i < U2F_CRYPTO_BACKEND_COUNT; i++)
+    {
+        if(m_backends[i] != NULL && m_backends[i]->init != NULL)
+        {
+            ret = m_backends[i]->init();
+            if(ret != NRF_SUCCESS) return ret;
+        }
+    }
+
+    for(uint32_t op = 0; op < U2F_CRYPTO_OP_COUNT; op++)
+    {
+        ret = u2f_crypto_backend_select((u2f_crypto_op_t)op, defaults[op]);
+
+        /* Without Ed25519 in the backend, e.g. in nrf_crypto, the
+         * credentials are ES256 only. */
+        if(op == U2F_CRYPTO_OP_EDDSA && ret == NRF_ERROR_NOT_SUPPORTED)
+        {
+            m_selected_id[op] = U2F_CRYPTO_BACKEND_COUNT;
+            continue;
+        }
+        if(ret != NRF_SUCCESS) return ret;
+    }
+
+    m_hash_sw_threshold = U2F_CRYPTO_HASH_SW_THRESHOLD;
+    if(m_hash_sw_threshold == 0)
+    {
+        UNUSED_RETURN_VALUE(u2f_crypto_hash_threshold_measure());
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+bool u2f_crypto_process(void)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_SIGN];
+
+    if(p_backend == NULL || p_backend->process == NULL) return false;
+
+    return p_backend->process();
+}
+
+
+ret_code_t u2f_crypto_random(uint8_t * p_out, size_t size)
+{
+#if NRF_MODULE_ENABLED(U2F_ENTROPY)
+    /* The pool serves a digest at a time; what it cannot cover comes from
+     * the DRBG of nrf_crypto. */
+    while(size > 0)
+    {
+        size_t len = MIN(size, U2F_ENTROPY_GET_MAX);
+
+        if(!u2f_entropy_get(p_out, len)) break;
+
+        p_out += len;
+        size -= len;
+    }
+    if(size == 0) return NRF_SUCCESS;
+#endif
+
+    return nrf_crypto_rng_vector_generate(p_out, size);
+}
+
+
+ret_code_t u2f_crypto_backend_select(u2f_crypto_op_t op,
+                                     u2f_crypto_backend_id_t backend)
+{
+    if(op >= U2F_CRYPTO_OP_COUNT || backend >= U2F_CRYPTO_BACKEND_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if(!backend_has_op(m_backends[backend], op))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    m_selected[op] = m_backends[backend];
+    m_selected_id[op] = backend;
+
+    return NRF_SUCCESS;
+}
+
+
+u2f_crypto_backend_id_t u2f_crypto_backend_get(u2f_crypto_op_t op)
+{
+    return m_selected_id[op];
+}
+
+
+char const * u2f_crypto_backend_name(u2f_crypto_backend_id_t backend)
+{
+    return (backend < U2F_CRYPTO_BACKEND_COUNT) ? m_backend_names[backend] : "?";
+}
+
+
+ret_code_t u2f_crypto_keygen(uint8_t * p_private_key, uint8_t * p_public_key)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_KEYGEN];
+
+    if(p_backend == NULL) return NRF_ERROR_INVALID_STATE;
+
+    return p_backend->keygen(p_private_key, p_public_key);
+}
+
+
+ret_code_t u2f_crypto_public_key(uint8_t const * p_private_key,
+                                 uint8_t * p_public_key)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_KEYGEN];
+
+    if(p_backend == NULL) return NRF_ERROR_INVALID_STATE;
+    if(p_backend->public_key == NULL) return NRF_ERROR_NOT_SUPPORTED;
+
+    return p_backend->public_key(p_private_key, p_public_key);
+}
+
+
+ret_code_t u2f_crypto_sign(uint8_t const * p_private_key,
+                           uint8_t const * p_hash,
+                           uint8_t * p_signature)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_SIGN];
+
+    if(p_backend == NULL) return NRF_ERROR_INVALID_STATE;
+
+    return p_backend->sign(p_private_key, p_hash, p_signature);
+}
+
+
+ret_code_t u2f_crypto_sign_batch(u2f_crypto_sign_req_t const * p_reqs,
+                                 size_t count)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_SIGN];
+    ret_code_t ret = NRF_SUCCESS;
+
+    if(p_backend == NULL) return NRF_ERROR_INVALID_STATE;
+    if(count == 0 || count > U2F_CRYPTO_SIGN_BATCH_MAX)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    if(p_backend->sign_batch != NULL)
+    {
+        return p_backend->sign_batch(p_reqs, count);
+    }
+
+    for(size_t i = 0; i < count && ret == NRF_SUCCESS; i++)
+    {
+        ret = p_backend->sign(p_reqs[i].p_private_key, p_reqs[i].p_hash,
+                              p_reqs[i].p_signature);
+    }
+
+    return ret;
+}
+
+
+ret_code_t u2f_crypto_alg_keygen(u2f_crypto_alg_t alg, uint8_t * p_private_key,
+                                 uint8_t * p_public_key)
+{
+    ret_code_t ret;
+
+    switch(alg)
+    {
+        case U2F_CRYPTO_ALG_ES256:
+            return u2f_crypto_keygen(p_private_key, p_public_key);
+
+        case U2F_CRYPTO_ALG_ED25519:
+            ret = u2f_crypto_random(p_private_key, U2F_CRYPTO_PRIVATE_KEY_SIZE);
+            if(ret == NRF_SUCCESS)
+            {
+                ret = u2f_crypto_alg_public_key(alg, p_private_key, p_public_key);
+            }
+            if(ret != NRF_SUCCESS)
+            {
+                memset(p_private_key, 0, U2F_CRYPTO_PRIVATE_KEY_SIZE);
+            }
+            return ret;
+
+        default:
+            return NRF_ERROR_INVALID_PARAM;
+    }
+}
+
+
+ret_code_t u2f_crypto_alg_public_key(u2f_crypto_alg_t alg,
+                                     uint8_t const * p_private_key,
+                                     uint8_t * p_public_key)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_EDDSA];
+
+    switch(alg)
+    {
+        case U2F_CRYPTO_ALG_ES256:
+            return u2f_crypto_public_key(p_private_key, p_public_key);
+
+        case U2F_CRYPTO_ALG_ED25519:
+            if(p_backend == NULL) return NRF_ERROR_NOT_SUPPORTED;
+            return p_backend->eddsa_public_key(p_private_key, p_public_key);
+
+        default:
+            return NRF_ERROR_INVALID_PARAM;
+    }
+}
+
+
+ret_code_t u2f_crypto_alg_sign(u2f_crypto_alg_t alg,
+                               uint8_t const * p_private_key,
+                               uint8_t const * p_message, size_t size,
+                               uint8_t * p_signature)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_EDDSA];
+    u2f_crypto_chunk_t const chunk = { p_message, size };
+    uint8_t hash[U2F_CRYPTO_HASH_SIZE];
+    ret_code_t ret;
+
+    switch(alg)
+    {
+        case U2F_CRYPTO_ALG_ES256:
+            ret = u2f_crypto_hash(&chunk, 1, hash);
+            if(ret != NRF_SUCCESS) return ret;
+            return u2f_crypto_sign(p_private_key, hash, p_signature);
+
+        case U2F_CRYPTO_ALG_ED25519:
+            if(p_backend == NULL) return NRF_ERROR_NOT_SUPPORTED;
+            return p_backend->eddsa_sign(p_private_key, p_message, size,
+                                         p_signature);
+
+        default:
+            return NRF_ERROR_INVALID_PARAM;
+    }
+}
+
+
+void u2f_crypto_hash_threshold_set(size_t size)
+{
+    m_hash_sw_threshold = size;
+}
+
+
+size_t u2f_crypto_hash_threshold_get(void)
+{
+    return m_hash_sw_threshold;
+}
+
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_OBERON)
+/**
+ * @brief Fastest of HASH_MEASURE_RUNS hashes of @p p_chunk, in cycles.
+ */
+static uint32_t hash_cycles_get(u2f_crypto_backend_t const * p_backend,
+                                u2f_crypto_chunk_t const * p_chunk)
+{
+    uint8_t digest[U2F_CRYPTO_HASH_SIZE];
+    uint32_t best = UINT32_MAX;
+
+    for(uint32_t i = 0; i < HASH_MEASURE_RUNS; i++)
+    {
+        uint32_t start = u2f_stats_cycles_get();
+
+        if(p_backend->hash(p_chunk, 1, digest) != NRF_SUCCESS)
+        {
+            return UINT32_MAX;
+        }
+        best = MIN(best, u2f_stats_cycles_get() - start);
+    }
+
+    return best;
+}
+#endif
+
+
+size_t u2f_crypto_hash_threshold_measure(void)
+{
+    size_t threshold = 0;
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_OBERON)
+    /* The longest inputs of 1 to 4 blocks, once padded */
+    static uint16_t const sizes[] = { 55, 119, 183, 247 };
+    static uint8_t const data[247];
+
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_HASH];
+
+    if(p_backend == NULL || p_backend == &g_u2f_crypto_oberon) return 0;
+
+    for(size_t i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        u2f_crypto_chunk_t const chunk = { data, sizes[i] };
+        uint32_t sw = hash_cycles_get(&g_u2f_crypto_oberon, &chunk);
+        uint32_t hw = hash_cycles_get(p_backend, &chunk);
+
+        if(hw == UINT32_MAX || sw >= hw)
+        {
+            break;
+        }
+        threshold = sizes[i] + 1;
+    }
+#endif
+
+    m_hash_sw_threshold = threshold;
+
+    return threshold;
+}
+
+
+ret_code_t u2f_crypto_hash(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                           uint8_t * p_digest)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_HASH];
+
+    if(p_backend == NULL) return NRF_ERROR_INVALID_STATE;
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_OBERON)
+    size_t size = 0;
+
+    for(size_t i = 0; i < count; i++)
+    {
+        size += p_chunks[i].size;
+    }
+
+    if(size < m_hash_sw_threshold)
+    {
+        p_backend = &g_u2f_crypto_oberon;
+    }
+#endif
+
+    return p_backend->hash(p_chunks, count, p_digest);
+}
+
+
+/**
+ * @brief Derive a sub-key of the device key, the HMAC-SHA256 of @p p_label.
+ *
+ * Computed over u2f_crypto_hash(), as no backend holds a MAC key yet.
+ */
+static ret_code_t subkey_derive(uint8_t const * p_key, char const * p_label,
+                                uint8_t * p_subkey)
+{
+    uint8_t pad[SHA256_BLOCK_SIZE];
+    uint8_t inner[U2F_CRYPTO_HASH_SIZE];
+    ret_code_t ret;
+
+    memset(pad, 0x36, sizeof(pad));
+    for(size_t i = 0; i < U2F_CRYPTO_WRAP_KEY_SIZE; i++) pad[i] ^= p_key[i];
+
+    u2f_crypto_chunk_t const inner_chunks[] =
+    {
+        { pad, sizeof(pad) },
+        { (uint8_t const *)p_label, strlen(p_label) },
+    };
+    ret = u2f_crypto_hash(inner_chunks, ARRAY_SIZE(inner_chunks), inner);
+
+    if(ret == NRF_SUCCESS)
+    {
+        memset(pad, 0x5c, sizeof(pad));
+        for(size_t i = 0; i < U2F_CRYPTO_WRAP_KEY_SIZE; i++) pad[i] ^= p_key[i];
+
+        u2f_crypto_chunk_t const outer_chunks[] =
+        {
+            { pad, sizeof(pad) },
+            { inner, sizeof(inner) },
+        };
+        ret = u2f_crypto_hash(outer_chunks, ARRAY_SIZE(outer_chunks), p_subkey);
+    }
+
+    memset(pad, 0, sizeof(pad));
+    memset(inner, 0, sizeof(inner));
+
+    return ret;
+}
+
+
+ret_code_t u2f_crypto_wrap_key_set(uint8_t const * p_key)
+{
+    uint8_t mac_key[U2F_CRYPTO_MAC_KEY_SIZE];
+    ret_code_t ret;
+
+    STATIC_ASSERT(U2F_CRYPTO_MAC_KEY_SIZE == U2F_CRYPTO_HASH_SIZE);
+
+    ret = subkey_derive(p_key, "kdf", mac_key);
+
+    /* Every backend, so that selecting another one needs no key */
+    for(uint32_t i = 0; i < U2F_CRYPTO_BACKEND_COUNT && ret == NRF_SUCCESS; i++)
+    {
+        if(backend_has_op(m_backends[i], U2F_CRYPTO_OP_WRAP))
+        {
+            ret = m_backends[i]->wrap_key_set(p_key, mac_key);
+        }
+    }
+
+    memset(mac_key, 0, sizeof(mac_key));
+
+    return ret;
+}
+
+
+ret_code_t u2f_crypto_mac(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                          uint8_t * p_mac)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_WRAP];
+
+    if(p_backend == NULL) return NRF_ERROR_INVALID_STATE;
+
+    return p_backend->mac(p_chunks, count, p_mac);
+}
+
+
+ret_code_t u2f_crypto_wrap(uint8_t const * p_in, uint8_t * p_out, size_t size)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_WRAP];
+
+    if(p_backend == NULL) return NRF_ERROR_INVALID_STATE;
+    if(size % U2F_CRYPTO_WRAP_BLOCK_SIZE != 0) return NRF_ERROR_INVALID_LENGTH;
+
+    return p_backend->wrap(p_in, p_out, size);
+}
+
+
+ret_code_t u2f_crypto_unwrap(uint8_t const * p_in, uint8_t * p_out, size_t size)
+{
+    u2f_crypto_backend_t const * p_backend = m_selected[U2F_CRYPTO_OP_WRAP];
+
+    if(p_backend == NULL) return NRF_ERROR_INVALID_STATE;
+    if(size % U2F_CRYPTO_WRAP_BLOCK_SIZE != 0) return NRF_ERROR_INVALID_LENGTH;
+
+    return p_backend->unwrap(p_in, p_out, size);
+}
+
+
+static void cmd_crypto_backends(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if(nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_INFO, "%-8s %-10s %s\r\n",
+                    "op", "selected", "available");
+
+    for(uint32_t op = 0; op < U2F_CRYPTO_OP_COUNT; op++)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-8s %-10s",
+                        m_op_names[op],
+                        u2f_crypto_backend_name(m_selected_id[op]));
+
+        for(uint32_t b = 0; b < U2F_CRYPTO_BACKEND_COUNT; b++)
+        {
+            if(backend_has_op(m_backends[b], (u2f_crypto_op_t)op))
+            {
+                nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, " %s", m_backend_names[b]);
+            }
+        }
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\r\n");
+    }
+}
+
+
+static void cmd_crypto_select(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    uint32_t op, backend;
+    bool matched = false;
+
+    if(nrf_cli_help_requested(p_cli) || argc != 3)
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    for(backend = 0; backend < U2F_CRYPTO_BACKEND_COUNT; backend++)
+    {
+        if(strcmp(argv[2], m_backend_names[backend]) == 0) break;
+    }
+
+    for(op = 0; op < U2F_CRYPTO_OP_COUNT; op++)
+    {
+        bool all = (strcmp(argv[1], "all") == 0);
+
+        if(!all && strcmp(argv[1], m_op_names[op]) != 0) continue;
+
+        matched = true;
+        ret_code_t ret = u2f_crypto_backend_select((u2f_crypto_op_t)op,
+                                                   (u2f_crypto_backend_id_t)backend);
+        if(ret == NRF_SUCCESS)
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_INFO, "%s: %s\r\n",
+                            m_op_names[op], argv[2]);
+        }
+        else if(!all || backend >= U2F_CRYPTO_BACKEND_COUNT)
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "%s: %s not available\r\n",
+                            m_op_names[op], argv[2]);
+        }
+    }
+
+    if(!matched)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "unknown operation: %s, use one of:",
+                        argv[1]);
+        for(op = 0; op < U2F_CRYPTO_OP_COUNT; op++)
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, " %s", m_op_names[op]);
+        }
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, " all\r\n");
+    }
+}
+
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_COMB)
+static void cmd_crypto_nonces(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    u2f_crypto_comb_stats_t stats;
+
+    if(nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    u2f_crypto_comb_stats_get(&stats);
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "ready    %u/%u\r\n",
+                    stats.pool_ready, stats.pool_size);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "filled   %u\r\n", stats.pool_filled);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "hits     %u\r\n", stats.pool_hits);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "misses   %u\r\n", stats.pool_misses);
+}
+#endif
+
+
+#if NRF_MODULE_ENABLED(U2F_ENTROPY)
+static void cmd_crypto_entropy(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    u2f_entropy_stats_t stats;
+
+    if(nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    u2f_entropy_stats_get(&stats);
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "level    %u/%u\r\n",
+                    stats.pool_level, stats.pool_size);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "samples  %u\r\n", stats.samples);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "served   %u\r\n", stats.served);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "requests %u\r\n", stats.requests);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "dry      %u\r\n", stats.dry);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "rct fail %u\r\n", stats.rct_failures);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "apt fail %u\r\n", stats.apt_failures);
+}
+#endif
+
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_OBERON)
+static void cmd_crypto_threshold(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if(nrf_cli_help_requested(p_cli) || argc > 2)
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    if(argc == 2 && strcmp(argv[1], "auto") == 0)
+    {
+        /* A job preempting the measurement would find CC310 busy, and
+         * skew the times. */
+        u2f_worker_suspend();
+        UNUSED_RETURN_VALUE(u2f_crypto_hash_threshold_measure());
+        u2f_worker_resume();
+    }
+    else if(argc == 2)
+    {
+        char * p_end;
+        unsigned long size = strtoul(argv[1], &p_end, 0);
+
+        if(*p_end != '\0')
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "invalid size: %s\r\n", argv[1]);
+            return;
+        }
+        u2f_crypto_hash_threshold_set(size);
+    }
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "hashes below %u B go to oberon\r\n",
+                    (unsigned)u2f_crypto_hash_threshold_get());
+}
+#endif
+
+
+#if NRF_MODULE_ENABLED(U2F_POWER)
+static void cmd_crypto_power(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    u2f_power_stats_t stats;
+
+    if(nrf_cli_help_requested(p_cli) || argc > 2)
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    if(argc == 2)
+    {
+        char * p_end;
+        unsigned long idle_ms = strtoul(argv[1], &p_end, 0);
+
+        if(*p_end != '\0')
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "invalid period: %s\r\n", argv[1]);
+            return;
+        }
+        u2f_power_idle_set(idle_ms);
+    }
+
+    u2f_power_stats_get(&stats);
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "cc310    %s\r\n", stats.on ? "on" : "off");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "idle     %u ms\r\n", stats.idle_ms);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "warmups  %u\r\n", stats.warmups);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "hits     %u\r\n", stats.hits);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "downs    %u\r\n", stats.powerdowns);
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "on time  %u ms\r\n", stats.on_ms);
+}
+#endif
+
+
+static void cmd_crypto(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    nrf_cli_help_print(p_cli, NULL, 0);
+}
+
+
+NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_sub_crypto)
+{
+    NRF_CLI_CMD(backends, NULL, "List the backend of each operation.", cmd_crypto_backends),
+    NRF_CLI_CMD(select,   NULL, "Route an operation: select <keygen|sign|hash|wrap|eddsa|all> <backend>", cmd_crypto_select),
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_COMB)
+    NRF_CLI_CMD(nonces,   NULL, "Show the ECDSA nonce pool of the comb backend.", cmd_crypto_nonces),
+#endif
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_OBERON)
+    NRF_CLI_CMD(threshold, NULL, "Show or set the size below which hashes go to oberon: threshold [bytes|auto]", cmd_crypto_threshold),
+#endif
+#if NRF_MODULE_ENABLED(U2F_ENTROPY)
+    NRF_CLI_CMD(entropy,  NULL, "Show the entropy pool.", cmd_crypto_entropy),
+#endif
+#if NRF_MODULE_ENABLED(U2F_POWER)
+    NRF_CLI_CMD(power,    NULL, "Show the CryptoCell power state, or set the idle period: power [ms]", cmd_crypto_power),
+#endif
+    NRF_CLI_SUBCMD_SET_END
+};
+
+NRF_CLI_CMD_REGISTER(crypto, &m_sub_crypto, "U2F crypto backends", cmd_crypto);
@@ -0,0 +1,359 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "app_util.h"
+#include "nrf_crypto.h"
+#include "nrf_crypto_ecc.h"
+#include "nrf_crypto_ecdsa.h"
+#include "nrf_crypto_eddsa.h"
+#include "nrf_crypto_hash.h"
+#include "nrf_crypto_hmac.h"
+#include "nrf_crypto_error.h"
+
+#include "u2f_crypto.h"
+#include "u2f_crypto_backend.h"
+
+#include "sdk_config.h"
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_CC310)
+
+/*
+ * The CC310 backend goes through nrf_crypto rather than the CC310 runtime
+ * library: nrf_crypto serializes the CryptoCell and powers it up and down.
+ * sdk_config.h routes the secp256r1, SHA-256 and AES ECB of nrf_crypto to
+ * CC310. On the host build, nrf_crypto is the OpenSSL stand-in.
+ *
+ * The wrapping key stays loaded in an encrypt and a decrypt context, so a
+ * request only runs nrf_crypto_aes_update().
+ */
+
+
+static ret_code_t cc310_keygen(uint8_t * p_private_key, uint8_t * p_public_key)
+{
+    nrf_crypto_ecc_private_key_t private_key;
+    nrf_crypto_ecc_public_key_t public_key;
+    size_t len;
+    ret_code_t ret;
+
+    ret = nrf_crypto_ecc_key_pair_generate(NULL,
+          &g_nrf_crypto_ecc_secp256r1_curve_info, &private_key, &public_key);
+    if(ret != NRF_SUCCESS) return ret;
+
+    len = U2F_CRYPTO_PUBLIC_KEY_SIZE;
+    ret = nrf_crypto_ecc_public_key_to_raw(&public_key, p_public_key, &len);
+
+    if(ret == NRF_SUCCESS)
+    {
+        len = U2F_CRYPTO_PRIVATE_KEY_SIZE;
+        ret = nrf_crypto_ecc_private_key_to_raw(&private_key, p_private_key,
+                                                &len);
+    }
+
+    UNUSED_RETURN_VALUE(nrf_crypto_ecc_private_key_free(&private_key));
+    UNUSED_RETURN_VALUE(nrf_crypto_ecc_public_key_free(&public_key));
+
+    return ret;
+}
+
+
+static ret_code_t cc310_public_key(uint8_t const * p_private_key,
+                                   uint8_t * p_public_key)
+{
+    nrf_crypto_ecc_private_key_t private_key;
+    nrf_crypto_ecc_public_key_t public_key;
+    size_t len = U2F_CRYPTO_PUBLIC_KEY_SIZE;
+    ret_code_t ret;
+
+    /* Refuses a key out of [1, n - 1] */
+    ret = nrf_crypto_ecc_private_key_from_raw(
+                                        &g_nrf_crypto_ecc_secp256r1_curve_info,
+                                        &private_key,
+                                        p_private_key,
+                                        U2F_CRYPTO_PRIVATE_KEY_SIZE);
+    if(ret != NRF_SUCCESS) return NRF_ERROR_CRYPTO_ECC_INVALID_KEY;
+
+    ret = nrf_crypto_ecc_public_key_calculate(NULL, &private_key, &public_key);
+    if(ret == NRF_SUCCESS)
+    {
+        ret = nrf_crypto_ecc_public_key_to_raw(&public_key, p_public_key, &len);
+        UNUSED_RETURN_VALUE(nrf_crypto_ecc_public_key_free(&public_key));
+    }
+
+    UNUSED_RETURN_VALUE(nrf_crypto_ecc_private_key_free(&private_key));
+
+    return ret;
+}
+
+
+static ret_code_t cc310_sign(uint8_t const * p_private_key,
+                             uint8_t const * p_hash,
+                             uint8_t * p_signature)
+{
+    nrf_crypto_ecc_private_key_t private_key;
+    size_t len = U2F_CRYPTO_SIGNATURE_SIZE;
+    ret_code_t ret;
+
+    ret = nrf_crypto_ecc_private_key_from_raw(
+                                        &g_nrf_crypto_ecc_secp256r1_curve_info,
+                                        &private_key,
+                                        p_private_key,
+                                        U2F_CRYPTO_PRIVATE_KEY_SIZE);
+    if(ret != NRF_SUCCESS) return ret;
+
+    ret = nrf_crypto_ecdsa_sign(NULL, &private_key, p_hash,
+                                U2F_CRYPTO_HASH_SIZE, p_signature, &len);
+
+    UNUSED_RETURN_VALUE(nrf_crypto_ecc_private_key_free(&private_key));
+
+    return ret;
+}
+
+
+#if NRF_MODULE_ENABLED(NRF_CRYPTO_BACKEND_CC310_ECC_ED25519)
+
+static ret_code_t cc310_eddsa_public_key(uint8_t const * p_private_key,
+                                         uint8_t * p_public_key)
+{
+    nrf_crypto_ecc_private_key_t private_key;
+    nrf_crypto_ecc_public_key_t public_key;
+    size_t len = U2F_CRYPTO_ED25519_PUBLIC_KEY_SIZE;
+    ret_code_t ret;
+
+    /* Any 32 bytes are an Ed25519 seed */
+    ret = nrf_crypto_ecc_private_key_from_raw(
+                                        &g_nrf_crypto_ecc_ed25519_curve_info,
+                                        &private_key,
+                                        p_private_key,
+                                        U2F_CRYPTO_PRIVATE_KEY_SIZE);
+    if(ret != NRF_SUCCESS) return ret;
+
+    ret = nrf_crypto_ecc_public_key_calculate(NULL, &private_key, &public_key);
+    if(ret == NRF_SUCCESS)
+    {
+        ret = nrf_crypto_ecc_public_key_to_raw(&public_key, p_public_key, &len);
+        UNUSED_RETURN_VALUE(nrf_crypto_ecc_public_key_free(&public_key));
+    }
+
+    UNUSED_RETURN_VALUE(nrf_crypto_ecc_private_key_free(&private_key));
+
+    return ret;
+}
+
+
+static ret_code_t cc310_eddsa_sign(uint8_t const * p_private_key,
+                                   uint8_t const * p_message, size_t size,
+                                   uint8_t * p_signature)
+{
+    nrf_crypto_ecc_private_key_t private_key;
+    size_t len = U2F_CRYPTO_ED25519_SIGNATURE_SIZE;
+    ret_code_t ret;
+
+    ret = nrf_crypto_ecc_private_key_from_raw(
+                                        &g_nrf_crypto_ecc_ed25519_curve_info,
+                                        &private_key,
+                                        p_private_key,
+                                        U2F_CRYPTO_PRIVATE_KEY_SIZE);
+    if(ret != NRF_SUCCESS) return ret;
+
+    ret = nrf_crypto_eddsa_sign(NULL, &private_key, p_message, size,
+                                p_signature, &len);
+
+    UNUSED_RETURN_VALUE(nrf_crypto_ecc_private_key_free(&private_key));
+
+    return ret;
+}
+
+#endif // NRF_MODULE_ENABLED(NRF_CRYPTO_BACKEND_CC310_ECC_ED25519)
+
+
+static ret_code_t cc310_hash(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                             uint8_t * p_digest)
+{
+    nrf_crypto_hash_context_t context;
+    size_t len = U2F_CRYPTO_HASH_SIZE;
+    ret_code_t ret;
+
+    /* A single call into the CryptoCell driver when the data is contiguous */
+    if(count == 1)
+    {
+        return nrf_crypto_hash_calculate(&context,
+                                         &g_nrf_crypto_hash_sha256_info,
+                                         p_chunks[0].p_data, p_chunks[0].size,
+                                         p_digest, &len);
+    }
+
+    ret = nrf_crypto_hash_init(&context, &g_nrf_crypto_hash_sha256_info);
+
+    for(size_t i = 0; i < count && ret == NRF_SUCCESS; i++)
+    {
+        ret = nrf_crypto_hash_update(&context, p_chunks[i].p_data,
+                                     p_chunks[i].size);
+    }
+
+    if(ret == NRF_SUCCESS)
+    {
+        ret = nrf_crypto_hash_finalize(&context, p_digest, &len);
+    }
+
+    return ret;
+}
+
+
+/**
+ * @brief Wrapping key contexts, kept across requests.
+ */
+static nrf_crypto_aes_context_t m_wrap_context;
+static nrf_crypto_aes_context_t m_unwrap_context;
+static bool m_wrap_key_loaded;
+
+/**
+ * @brief Key of the HMAC, which nrf_crypto takes per operation.
+ */
+static uint8_t m_mac_key[U2F_CRYPTO_MAC_KEY_SIZE];
+
+
+static ret_code_t cc310_aes_context_load(nrf_crypto_aes_context_t * p_context,
+                                         nrf_crypto_operation_t operation,
+                                         uint8_t const * p_key)
+{
+    ret_code_t ret;
+
+    ret = nrf_crypto_aes_init(p_context, &g_nrf_crypto_aes_ecb_128_info,
+                              operation);
+    if(ret != NRF_SUCCESS) return ret;
+
+    ret = nrf_crypto_aes_key_set(p_context, (uint8_t *)p_key);
+    if(ret != NRF_SUCCESS)
+    {
+        UNUSED_RETURN_VALUE(nrf_crypto_aes_uninit(p_context));
+    }
+
+    return ret;
+}
+
+
+static ret_code_t cc310_wrap_key_set(uint8_t const * p_key,
+                                     uint8_t const * p_mac_key)
+{
+    ret_code_t ret;
+
+    if(m_wrap_key_loaded)
+    {
+        m_wrap_key_loaded = false;
+        UNUSED_RETURN_VALUE(nrf_crypto_aes_uninit(&m_wrap_context));
+        UNUSED_RETURN_VALUE(nrf_crypto_aes_uninit(&m_unwrap_context));
+    }
+
+    ret = cc310_aes_context_load(&m_wrap_context, NRF_CRYPTO_ENCRYPT, p_key);
+    if(ret != NRF_SUCCESS) return ret;
+
+    ret = cc310_aes_context_load(&m_unwrap_context, NRF_CRYPTO_DECRYPT, p_key);
+    if(ret != NRF_SUCCESS)
+    {
+        UNUSED_RETURN_VALUE(nrf_crypto_aes_uninit(&m_wrap_context));
+        return ret;
+    }
+
+    memcpy(m_mac_key, p_mac_key, sizeof(m_mac_key));
+    m_wrap_key_loaded = true;
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t cc310_wrap(uint8_t const * p_in, uint8_t * p_out, size_t size)
+{
+    if(!m_wrap_key_loaded) return NRF_ERROR_INVALID_STATE;
+
+    return nrf_crypto_aes_update(&m_wrap_context, (uint8_t *)p_in, size, p_out);
+}
+
+
+static ret_code_t cc310_unwrap(uint8_t const * p_in, uint8_t * p_out, size_t size)
+{
+    if(!m_wrap_key_loaded) return NRF_ERROR_INVALID_STATE;
+
+    return nrf_crypto_aes_update(&m_unwrap_context, (uint8_t *)p_in, size, p_out);
+}
+
+
+static ret_code_t cc310_mac(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                            uint8_t * p_mac)
+{
+    nrf_crypto_hmac_context_t context;
+    size_t len = U2F_CRYPTO_MAC_SIZE;
+    ret_code_t ret;
+
+    if(!m_wrap_key_loaded) return NRF_ERROR_INVALID_STATE;
+
+    ret = nrf_crypto_hmac_init(&context, &g_nrf_crypto_hmac_sha256_info,
+                               m_mac_key, sizeof(m_mac_key));
+
+    for(size_t i = 0; i < count && ret == NRF_SUCCESS; i++)
+    {
+        ret = nrf_crypto_hmac_update(&context, p_chunks[i].p_data,
+                                     p_chunks[i].size);
+    }
+
+    if(ret == NRF_SUCCESS)
+    {
+        ret = nrf_crypto_hmac_finalize(&context, p_mac, &len);
+    }
+
+    return ret;
+}
+
+
+u2f_crypto_backend_t const g_u2f_crypto_cc310 =
+{
+    .p_name = "cc310",
+    .keygen = cc310_keygen,
+    .sign   = cc310_sign,
+
+    .public_key = cc310_public_key,
+    .hash   = cc310_hash,
+
+    .wrap_key_set = cc310_wrap_key_set,
+    .wrap         = cc310_wrap,
+    .unwrap       = cc310_unwrap,
+    .mac          = cc310_mac,
+
+#if NRF_MODULE_ENABLED(NRF_CRYPTO_BACKEND_CC310_ECC_ED25519)
+    .eddsa_public_key = cc310_eddsa_public_key,
+    .eddsa_sign       = cc310_eddsa_sign,
+#endif
+};
+
+#endif // NRF_MODULE_ENABLED(U2F_CRYPTO_CC310)
@@ -0,0 +1,965 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "app_util.h"
+#include "app_util_platform.h"
+#include "nrf_crypto.h"
+#include "nrf_crypto_error.h"
+
+#include "u2f_crypto.h"
+#include "u2f_crypto_backend.h"
+#include "u2f_crypto_comb.h"
+#include "u2f_worker.h"
+
+#include "sdk_config.h"
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_COMB)
+
+/*
+ * Software secp256r1 key generation and signing, with the generator
+ * multiples precomputed in flash (Lim-Lee comb). Only k * G is computed,
+ * which is all keygen and sign need, so the table covers every scalar
+ * multiplication.
+ *
+ * The numbers are 8 little endian 32-bit limbs, in the Montgomery domain
+ * of p for the coordinates and of n for the ECDSA scalars. The arithmetic
+ * does not branch on secret data, and the table entries are selected by
+ * reading them all.
+ */
+
+#define LIMBS               8
+
+/** Draws of a scalar in [1, n - 1] before giving up. */
+#define SCALAR_RETRIES      16
+
+#ifndef U2F_CRYPTO_COMB_NONCE_POOL_SIZE
+#define U2F_CRYPTO_COMB_NONCE_POOL_SIZE     4
+#endif
+
+#define NONCE_POOL_SIZE     U2F_CRYPTO_COMB_NONCE_POOL_SIZE
+
+STATIC_ASSERT(NONCE_POOL_SIZE <= 32);
+
+
+typedef uint32_t fe_t[LIMBS];
+
+
+/**
+ * @brief Modulus and its Montgomery constants, R = 2^256.
+ */
+typedef struct
+{
+    fe_t     m;                     //!< Modulus.
+    fe_t     rr;                    //!< R^2 mod m.
+    fe_t     one;                   //!< R mod m.
+    uint32_t m0inv;                 //!< -m^-1 mod 2^32.
+} modulus_t;
+
+
+/**
+ * @brief Jacobian point, infinity when z is 0.
+ */
+typedef struct
+{
+    fe_t x;
+    fe_t y;
+    fe_t z;
+} jacobian_t;
+
+
+/**
+ * @brief ECDSA nonce, with what does not depend on the message computed.
+ *
+ * k itself is not kept.
+ */
+typedef struct
+{
+    fe_t kinv;                      //!< k^-1, Montgomery domain of n.
+    fe_t r;                         //!< (k * G).x mod n.
+    fe_t r_mont;                    //!< r, Montgomery domain of n.
+} nonce_t;
+
+
+static modulus_t const m_p =
+{
+    .m     = { 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000,
+               0x00000000, 0x00000000, 0x00000001, 0xffffffff },
+    .rr    = { 0x00000003, 0x00000000, 0xffffffff, 0xfffffffb,
+               0xfffffffe, 0xffffffff, 0xfffffffd, 0x00000004 },
+    .one   = { 0x00000001, 0x00000000, 0x00000000, 0xffffffff,
+               0xffffffff, 0xffffffff, 0xfffffffe, 0x00000000 },
+    .m0inv = 0x00000001,
+};
+
+static modulus_t const m_n =
+{
+    .m     = { 0xfc632551, 0xf3b9cac2, 0xa7179e84, 0xbce6faad,
+               0xffffffff, 0xffffffff, 0x00000000, 0xffffffff },
+    .rr    = { 0xbe79eea2, 0x83244c95, 0x49bd6fa6, 0x4699799c,
+               0x2b6bec59, 0x2845b239, 0xf3d95620, 0x66e12d94 },
+    .one   = { 0x039cdaaf, 0x0c46353d, 0x58e8617b, 0x43190552,
+               0x00000000, 0x00000000, 0xffffffff, 0x00000000 },
+    .m0inv = 0xee00bc4f,
+};
+
+#if NONCE_POOL_SIZE > 0
+/**
+ * @brief Nonces precomputed while idle.
+ *
+ * Filled from the main loop and taken by the sign path, which may preempt
+ * it. A slot is written only while its bit in m_pool_ready is clear, and
+ * taken, i.e. its bit cleared and the slot wiped, in a critical region.
+ * The pool is in RAM only, so it does not survive a reset.
+ */
+static nonce_t m_pool[NONCE_POOL_SIZE];
+
+static uint32_t volatile m_pool_ready;
+#endif
+
+static u2f_crypto_comb_stats_t m_stats;
+
+
+static void fe_from_bytes(fe_t r, uint8_t const * p_in)
+{
+    for(uint32_t i = 0; i < LIMBS; i++)
+    {
+        r[i] = uint32_big_decode(&p_in[(LIMBS - 1 - i) * 4]);
+    }
+}
+
+
+static void fe_to_bytes(uint8_t * p_out, fe_t const a)
+{
+    for(uint32_t i = 0; i < LIMBS; i++)
+    {
+        UNUSED_RETURN_VALUE(uint32_big_encode(a[i], &p_out[(LIMBS - 1 - i) * 4]));
+    }
+}
+
+
+static uint32_t fe_is_zero(fe_t const a)
+{
+    uint32_t bits = 0;
+
+    for(uint32_t i = 0; i < LIMBS; i++)
+    {
+        bits |= a[i];
+    }
+
+    return (uint32_t)(((uint64_t)bits - 1) >> 63);
+}
+
+
+/**
+ * @brief r = mask ? a : r, mask all ones or all zeros.
+ */
+static void fe_select(fe_t r, fe_t const a, uint32_t mask)
+{
+    for(uint32_t i = 0; i < LIMBS; i++)
+    {
+        r[i] ^= (r[i] ^ a[i]) & mask;
+    }
+}
+
+
+/**
+ * @brief r = a - b, return the borrow.
+ */
+static uint32_t fe_sub_raw(fe_t r, fe_t const a, fe_t const b)
+{
+    uint64_t borrow = 0;
+
+    for(uint32_t i = 0; i < LIMBS; i++)
+    {
+        uint64_t diff = (uint64_t)a[i] - b[i] - borrow;
+        r[i] = (uint32_t)diff;
+        borrow = (diff >> 32) & 1;
+    }
+
+    return (uint32_t)borrow;
+}
+
+
+/**
+ * @brief r = a mod m, for a < 2m given as @p carry and the low limbs.
+ */
+static void mod_reduce_once(fe_t r, fe_t const a, uint32_t carry,
+                            modulus_t const * p_mod)
+{
+    fe_t diff;
+    uint32_t borrow = fe_sub_raw(diff, a, p_mod->m);
+
+    memcpy(r, a, sizeof(fe_t));
+    fe_select(r, diff, 0 - (carry | (borrow ^ 1)));
+}
+
+
+static void mod_add(fe_t r, fe_t const a, fe_t const b, modulus_t const * p_mod)
+{
+    fe_t sum;
+    uint64_t carry = 0;
+
+    for(uint32_t i = 0; i < LIMBS; i++)
+    {
+        carry += (uint64_t)a[i] + b[i];
+        sum[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+
+    mod_reduce_once(r, sum, (uint32_t)carry, p_mod);
+}
+
+
+static void mod_sub(fe_t r, fe_t const a, fe_t const b, modulus_t const * p_mod)
+{
+    fe_t sum;
+    uint32_t borrow = fe_sub_raw(r, a, b);
+    uint64_t carry = 0;
+
+    for(uint32_t i = 0; i < LIMBS; i++)
+    {
+        carry += (uint64_t)r[i] + p_mod->m[i];
+        sum[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+
+    fe_select(r, sum, 0 - borrow);
+}
+
+
+/**
+ * @brief r = a * b / R mod m, Montgomery multiplication (CIOS).
+ */
+static void mod_mul(fe_t r, fe_t const a, fe_t const b, modulus_t const * p_mod)
+{
+    uint32_t t[LIMBS + 2] = {0};
+
+    for(uint32_t i = 0; i < LIMBS; i++)
+    {
+        uint64_t c = 0;
+
+        for(uint32_t j = 0; j < LIMBS; j++)
+        {
+            c += (uint64_t)a[j] * b[i] + t[j];
+            t[j] = (uint32_t)c;
+            c >>= 32;
+        }
+        c += t[LIMBS];
+        t[LIMBS] = (uint32_t)c;
+        t[LIMBS + 1] = (uint32_t)(c >> 32);
+
+        uint32_t q = t[0] * p_mod->m0inv;
+
+        c = ((uint64_t)q * p_mod->m[0] + t[0]) >> 32;
+        for(uint32_t j = 1; j < LIMBS; j++)
+        {
+            c += (uint64_t)q * p_mod->m[j] + t[j];
+            t[j - 1] = (uint32_t)c;
+            c >>= 32;
+        }
+        c += t[LIMBS];
+        t[LIMBS - 1] = (uint32_t)c;
+        t[LIMBS] = t[LIMBS + 1] + (uint32_t)(c >> 32);
+    }
+
+    mod_reduce_once(r, t, t[LIMBS], p_mod);
+}
+
+
+static void mod_to_mont(fe_t r, fe_t const a, modulus_t const * p_mod)
+{
+    mod_mul(r, a, p_mod->rr, p_mod);
+}
+
+
+static void mod_from_mont(fe_t r, fe_t const a, modulus_t const * p_mod)
+{
+    static fe_t const one = { 1 };
+
+    mod_mul(r, a, one, p_mod);
+}
+
+
+/**
+ * @brief r = a^-1 mod m, as a^(m - 2), in the Montgomery domain.
+ *
+ * The exponent is public, so does not need to be hidden.
+ */
+static void mod_inv(fe_t r, fe_t const a, modulus_t const * p_mod)
+{
+    fe_t e, x;
+
+    memcpy(e, p_mod->m, sizeof(fe_t));
+    e[0] -= 2;
+    memcpy(x, p_mod->one, sizeof(fe_t));
+
+    for(int32_t bit = LIMBS * 32 - 1; bit >= 0; bit--)
+    {
+        mod_mul(x, x, x, p_mod);
+        if((e[bit / 32] >> (bit % 32)) & 1)
+        {
+            mod_mul(x, x, a, p_mod);
+        }
+    }
+
+    memcpy(r, x, sizeof(fe_t));
+}
+
+
+/**
+ * @brief r[i] = a[i]^-1 mod m for i < count, in the Montgomery domain,
+ *        with a single inversion (Montgomery's trick).
+ *
+ * The inverse of the product of all the a[i] gives each one by 3
+ * multiplications. No a[i] may be zero, and r may not be a.
+ */
+static void mod_inv_batch(fe_t * r, fe_t const * a, size_t count,
+                          modulus_t const * p_mod)
+{
+    fe_t inv, t;
+
+    /* r[i] = a[0] * ... * a[i] */
+    memcpy(r[0], a[0], sizeof(fe_t));
+    for(size_t i = 1; i < count; i++)
+    {
+        mod_mul(r[i], r[i - 1], a[i], p_mod);
+    }
+
+    mod_inv(inv, r[count - 1], p_mod);
+
+    /* inv = (a[0] * ... * a[i])^-1, going down */
+    for(size_t i = count - 1; i > 0; i--)
+    {
+        mod_mul(t, inv, r[i - 1], p_mod);
+        mod_mul(inv, inv, a[i], p_mod);
+        memcpy(r[i], t, sizeof(fe_t));
+    }
+    memcpy(r[0], inv, sizeof(fe_t));
+
+    memset(inv, 0, sizeof(inv));
+    memset(t, 0, sizeof(t));
+}
+
+
+/**
+ * @brief r = 2 * a, dbl-2001-b for a = -3.
+ */
+static void point_double(jacobian_t * r, jacobian_t const * a)
+{
+    fe_t delta, gamma, beta, alpha, t1, t2;
+
+    mod_mul(delta, a->z, a->z, &m_p);
+    mod_mul(gamma, a->y, a->y, &m_p);
+    mod_mul(beta, a->x, gamma, &m_p);
+
+    mod_sub(t1, a->x, delta, &m_p);
+    mod_add(t2, a->x, delta, &m_p);
+    mod_mul(alpha, t1, t2, &m_p);
+    mod_add(t1, alpha, alpha, &m_p);
+    mod_add(alpha, t1, alpha, &m_p);
+
+    /* Z3 = (Y1 + Z1)^2 - gamma - delta */
+    mod_add(t1, a->y, a->z, &m_p);
+    mod_mul(t1, t1, t1, &m_p);
+    mod_sub(t1, t1, gamma, &m_p);
+    mod_sub(r->z, t1, delta, &m_p);
+
+    /* X3 = alpha^2 - 8 * beta */
+    mod_add(beta, beta, beta, &m_p);
+    mod_add(beta, beta, beta, &m_p);
+    mod_add(t2, beta, beta, &m_p);
+    mod_mul(t1, alpha, alpha, &m_p);
+    mod_sub(r->x, t1, t2, &m_p);
+
+    /* Y3 = alpha * (4 * beta - X3) - 8 * gamma^2 */
+    mod_sub(t1, beta, r->x, &m_p);
+    mod_mul(t1, alpha, t1, &m_p);
+    mod_mul(gamma, gamma, gamma, &m_p);
+    mod_add(gamma, gamma, gamma, &m_p);
+    mod_add(gamma, gamma, gamma, &m_p);
+    mod_add(gamma, gamma, gamma, &m_p);
+    mod_sub(r->y, t1, gamma, &m_p);
+}
+
+
+/**
+ * @brief r = a + b, madd-2007-bl.
+ *
+ * Wrong if a is infinity or a = +-b, which the caller handles or which
+ * does not happen for a random scalar.
+ */
+static void point_add_affine(jacobian_t * r, jacobian_t const * a,
+                             u2f_crypto_comb_point_t const * b)
+{
+    fe_t z1z1, u2, s2, h, hh, i, j, rr, v, t;
+
+    mod_mul(z1z1, a->z, a->z, &m_p);
+    mod_mul(u2, b->x, z1z1, &m_p);
+    mod_mul(s2, b->y, a->z, &m_p);
+    mod_mul(s2, s2, z1z1, &m_p);
+
+    mod_sub(h, u2, a->x, &m_p);
+    mod_mul(hh, h, h, &m_p);
+    mod_add(i, hh, hh, &m_p);
+    mod_add(i, i, i, &m_p);
+    mod_mul(j, h, i, &m_p);
+    mod_sub(rr, s2, a->y, &m_p);
+    mod_add(rr, rr, rr, &m_p);
+    mod_mul(v, a->x, i, &m_p);
+
+    /* Z3 = (Z1 + H)^2 - Z1Z1 - HH, before Z1 may be overwritten */
+    mod_add(t, a->z, h, &m_p);
+    mod_mul(t, t, t, &m_p);
+    mod_sub(t, t, z1z1, &m_p);
+    mod_sub(r->z, t, hh, &m_p);
+
+    /* X3 = r^2 - J - 2 * V */
+    mod_mul(t, rr, rr, &m_p);
+    mod_sub(t, t, j, &m_p);
+    mod_sub(t, t, v, &m_p);
+    mod_sub(r->x, t, v, &m_p);
+
+    /* Y3 = r * (V - X3) - 2 * Y1 * J */
+    mod_sub(t, v, r->x, &m_p);
+    mod_mul(t, rr, t, &m_p);
+    mod_mul(j, j, a->y, &m_p);
+    mod_add(j, j, j, &m_p);
+    mod_sub(r->y, t, j, &m_p);
+}
+
+
+/**
+ * @brief Read the entry of the teeth @p digit of a block, zero for 0.
+ */
+static void comb_point_select(u2f_crypto_comb_point_t * p_point, uint32_t block,
+                              uint32_t digit)
+{
+    memset(p_point, 0, sizeof(*p_point));
+
+    for(uint32_t u = 1; u <= U2F_CRYPTO_COMB_POINTS; u++)
+    {
+        uint32_t mask = 0 - (((u ^ digit) - 1) >> 31);
+
+        fe_select(p_point->x, g_u2f_crypto_comb_table[block][u - 1].x, mask);
+        fe_select(p_point->y, g_u2f_crypto_comb_table[block][u - 1].y, mask);
+    }
+}
+
+
+/**
+ * @brief Compute k * G, in Jacobian coordinates.
+ *
+ * @retval false  The result is infinity, or the additions hit a = +-b.
+ */
+static bool comb_mul_jacobian(jacobian_t * p_acc, fe_t const k)
+{
+    uint32_t const row = LIMBS * 32 / U2F_CRYPTO_COMB_TEETH;
+    uint32_t const col = row / U2F_CRYPTO_COMB_BLOCKS;
+    jacobian_t acc, sum;
+    u2f_crypto_comb_point_t point;
+    uint32_t infinity = UINT32_MAX;
+
+    memset(&acc, 0, sizeof(acc));
+
+    for(int32_t i = col - 1; i >= 0; i--)
+    {
+        point_double(&acc, &acc);
+
+        for(uint32_t block = 0; block < U2F_CRYPTO_COMB_BLOCKS; block++)
+        {
+            uint32_t digit = 0;
+
+            for(uint32_t tooth = 0; tooth < U2F_CRYPTO_COMB_TEETH; tooth++)
+            {
+                uint32_t bit = tooth * row + block * col + i;
+                digit |= ((k[bit / 32] >> (bit % 32)) & 1) << tooth;
+            }
+
+            comb_point_select(&point, block, digit);
+            point_add_affine(&sum, &acc, &point);
+
+            /* The first addition to infinity is the entry itself */
+            fe_select(sum.x, point.x, infinity);
+            fe_select(sum.y, point.y, infinity);
+            fe_select(sum.z, m_p.one, infinity);
+
+            uint32_t nonzero = 0 - ((0 - digit) >> 31);
+
+            fe_select(acc.x, sum.x, nonzero);
+            fe_select(acc.y, sum.y, nonzero);
+            fe_select(acc.z, sum.z, nonzero);
+            infinity &= ~nonzero;
+        }
+    }
+
+    memcpy(p_acc, &acc, sizeof(acc));
+
+    return !infinity && !fe_is_zero(acc.z);
+}
+
+
+/**
+ * @brief Compute k * G, affine, out of the Montgomery domain.
+ *
+ * @retval false  The result is infinity, or the additions hit a = +-b.
+ */
+static bool comb_mul(fe_t x, fe_t y, fe_t const k)
+{
+    jacobian_t acc;
+    fe_t zinv, t;
+
+    if(!comb_mul_jacobian(&acc, k)) return false;
+
+    mod_inv(zinv, acc.z, &m_p);
+    mod_mul(t, zinv, zinv, &m_p);
+    mod_mul(x, acc.x, t, &m_p);
+    mod_mul(t, t, zinv, &m_p);
+    mod_mul(y, acc.y, t, &m_p);
+
+    mod_from_mont(x, x, &m_p);
+    mod_from_mont(y, y, &m_p);
+
+    return true;
+}
+
+
+/**
+ * @brief Draw a scalar in [1, n - 1].
+ */
+static ret_code_t scalar_random(fe_t k)
+{
+    uint8_t bytes[U2F_CRYPTO_PRIVATE_KEY_SIZE];
+    fe_t diff;
+
+    for(uint32_t i = 0; i < SCALAR_RETRIES; i++)
+    {
+        ret_code_t ret = u2f_crypto_random(bytes, sizeof(bytes));
+        if(ret != NRF_SUCCESS) return ret;
+
+        fe_from_bytes(k, bytes);
+        if(!fe_is_zero(k) && fe_sub_raw(diff, k, m_n.m))
+        {
+            memset(bytes, 0, sizeof(bytes));
+            return NRF_SUCCESS;
+        }
+    }
+
+    return NRF_ERROR_CRYPTO_INTERNAL;
+}
+
+
+static ret_code_t comb_keygen(uint8_t * p_private_key, uint8_t * p_public_key)
+{
+    fe_t d, x, y;
+    ret_code_t ret;
+
+    do
+    {
+        ret = scalar_random(d);
+        if(ret != NRF_SUCCESS) return ret;
+    } while(!comb_mul(x, y, d));
+
+    fe_to_bytes(p_private_key, d);
+    fe_to_bytes(p_public_key, x);
+    fe_to_bytes(p_public_key + U2F_CRYPTO_PUBLIC_KEY_SIZE / 2, y);
+
+    memset(d, 0, sizeof(d));
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t comb_public_key(uint8_t const * p_private_key,
+                                  uint8_t * p_public_key)
+{
+    fe_t d, x, y, diff;
+    ret_code_t ret = NRF_ERROR_CRYPTO_ECC_INVALID_KEY;
+
+    fe_from_bytes(d, p_private_key);
+
+    if(!fe_is_zero(d) && fe_sub_raw(diff, d, m_n.m) && comb_mul(x, y, d))
+    {
+        fe_to_bytes(p_public_key, x);
+        fe_to_bytes(p_public_key + U2F_CRYPTO_PUBLIC_KEY_SIZE / 2, y);
+        ret = NRF_SUCCESS;
+    }
+
+    memset(d, 0, sizeof(d));
+
+    return ret;
+}
+
+
+/**
+ * @brief Compute k^-1 and r of the nonce k.
+ *
+ * @retval false  k does not give a usable r, draw another.
+ */
+static bool nonce_from_scalar(nonce_t * p_nonce, fe_t k)
+{
+    fe_t x, y;
+
+    if(!comb_mul(x, y, k)) return false;
+
+    /* r = x mod n */
+    mod_reduce_once(p_nonce->r, x, 0, &m_n);
+    if(fe_is_zero(p_nonce->r)) return false;
+
+    mod_to_mont(p_nonce->r_mont, p_nonce->r, &m_n);
+    mod_to_mont(k, k, &m_n);
+    mod_inv(p_nonce->kinv, k, &m_n);
+
+    return true;
+}
+
+
+/**
+ * @brief Draw a nonce and compute k^-1 and r.
+ */
+static ret_code_t nonce_compute(nonce_t * p_nonce)
+{
+    fe_t k;
+    ret_code_t ret;
+    bool done = false;
+
+    do
+    {
+        ret = scalar_random(k);
+        if(ret != NRF_SUCCESS) break;
+
+        done = nonce_from_scalar(p_nonce, k);
+    } while(!done);
+
+    memset(k, 0, sizeof(k));
+
+    return ret;
+}
+
+
+/**
+ * @brief Take a precomputed nonce out of the pool, for one use.
+ *
+ * @retval false  The pool is empty.
+ */
+static bool nonce_take(nonce_t * p_nonce)
+{
+    bool taken = false;
+
+#if NONCE_POOL_SIZE > 0
+    CRITICAL_REGION_ENTER();
+
+    if(m_pool_ready != 0)
+    {
+        uint32_t slot = 0;
+
+        while(((m_pool_ready >> slot) & 1) == 0)
+        {
+            slot++;
+        }
+
+        m_pool_ready &= ~(1UL << slot);
+        memcpy(p_nonce, &m_pool[slot], sizeof(nonce_t));
+        memset(&m_pool[slot], 0, sizeof(nonce_t));
+        taken = true;
+    }
+
+    CRITICAL_REGION_EXIT();
+#endif
+
+    return taken;
+}
+
+
+/**
+ * @brief Read a key or a hash as a scalar mod n, in the Montgomery domain.
+ */
+static void scalar_load(fe_t r, uint8_t const * p_in)
+{
+    fe_from_bytes(r, p_in);
+    mod_reduce_once(r, r, 0, &m_n);
+    mod_to_mont(r, r, &m_n);
+}
+
+
+/**
+ * @brief s = k^-1 * (e + r * d) mod n, out of the Montgomery domain.
+ */
+static void ecdsa_s(fe_t s, nonce_t const * p_nonce, fe_t const d, fe_t const e)
+{
+    mod_mul(s, p_nonce->r_mont, d, &m_n);
+    mod_add(s, s, e, &m_n);
+    mod_mul(s, p_nonce->kinv, s, &m_n);
+    mod_from_mont(s, s, &m_n);
+}
+
+
+static ret_code_t comb_sign(uint8_t const * p_private_key,
+                            uint8_t const * p_hash,
+                            uint8_t * p_signature)
+{
+    nonce_t nonce;
+    fe_t d, e, s;
+    ret_code_t ret = NRF_SUCCESS;
+
+    scalar_load(d, p_private_key);
+    scalar_load(e, p_hash);
+
+    /* A nonce is used once: taken out of the pool, or drawn now, and
+     * dropped whatever the outcome, also when s is 0 and another is
+     * needed. */
+    do
+    {
+        if(nonce_take(&nonce))
+        {
+            m_stats.pool_hits++;
+        }
+        else
+        {
+            m_stats.pool_misses++;
+
+            ret = nonce_compute(&nonce);
+            if(ret != NRF_SUCCESS) break;
+        }
+
+        ecdsa_s(s, &nonce, d, e);
+    } while(fe_is_zero(s));
+
+    memset(d, 0, sizeof(d));
+
+    if(ret == NRF_SUCCESS)
+    {
+        fe_to_bytes(p_signature, nonce.r);
+        fe_to_bytes(p_signature + U2F_CRYPTO_SIGNATURE_SIZE / 2, s);
+    }
+
+    memset(&nonce, 0, sizeof(nonce));
+
+    return ret;
+}
+
+
+/**
+ * @brief Sign a batch, with an inversion mod p for the points of all the
+ *        nonces and one mod n for the nonces.
+ *
+ * A nonce that gives infinity or r = 0, or a signature with s = 0, which
+ * do not happen in practice, is signed again by comb_sign().
+ */
+static ret_code_t comb_sign_batch(u2f_crypto_sign_req_t const * p_reqs,
+                                  size_t count)
+{
+    jacobian_t points[U2F_CRYPTO_SIGN_BATCH_MAX];
+    fe_t a[U2F_CRYPTO_SIGN_BATCH_MAX];
+    fe_t inv[U2F_CRYPTO_SIGN_BATCH_MAX];
+    nonce_t nonces[U2F_CRYPTO_SIGN_BATCH_MAX];
+    uint32_t retry = 0;
+    ret_code_t ret = NRF_SUCCESS;
+
+    /* k * G of every nonce, with k kept to a[] */
+    for(size_t i = 0; i < count; i++)
+    {
+        ret = scalar_random(a[i]);
+        if(ret != NRF_SUCCESS) break;
+
+        if(!comb_mul_jacobian(&points[i], a[i]))
+        {
+            memcpy(points[i].z, m_p.one, sizeof(fe_t));
+            retry |= 1UL << i;
+        }
+        mod_to_mont(a[i], a[i], &m_n);
+    }
+
+    if(ret == NRF_SUCCESS)
+    {
+        mod_inv_batch(inv, a, count, &m_n);
+
+        for(size_t i = 0; i < count; i++)
+        {
+            memcpy(nonces[i].kinv, inv[i], sizeof(fe_t));
+            memcpy(a[i], points[i].z, sizeof(fe_t));
+        }
+
+        mod_inv_batch(inv, a, count, &m_p);
+
+        for(size_t i = 0; i < count; i++)
+        {
+            fe_t t, x;
+
+            /* r = (X / Z^2) mod n */
+            mod_mul(t, inv[i], inv[i], &m_p);
+            mod_mul(x, points[i].x, t, &m_p);
+            mod_from_mont(x, x, &m_p);
+            mod_reduce_once(nonces[i].r, x, 0, &m_n);
+            mod_to_mont(nonces[i].r_mont, nonces[i].r, &m_n);
+
+            if(fe_is_zero(nonces[i].r))
+            {
+                retry |= 1UL << i;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < count && ret == NRF_SUCCESS; i++)
+    {
+        fe_t d, e, s;
+
+        if((retry >> i) & 1)
+        {
+            ret = comb_sign(p_reqs[i].p_private_key, p_reqs[i].p_hash,
+                            p_reqs[i].p_signature);
+            continue;
+        }
+
+        scalar_load(d, p_reqs[i].p_private_key);
+        scalar_load(e, p_reqs[i].p_hash);
+        ecdsa_s(s, &nonces[i], d, e);
+        memset(d, 0, sizeof(d));
+
+        if(fe_is_zero(s))
+        {
+            ret = comb_sign(p_reqs[i].p_private_key, p_reqs[i].p_hash,
+                            p_reqs[i].p_signature);
+            continue;
+        }
+
+        fe_to_bytes(p_reqs[i].p_signature, nonces[i].r);
+        fe_to_bytes(p_reqs[i].p_signature + U2F_CRYPTO_SIGNATURE_SIZE / 2, s);
+    }
+
+    memset(a, 0, sizeof(a));
+    memset(inv, 0, sizeof(inv));
+    memset(nonces, 0, sizeof(nonces));
+
+    return ret;
+}
+
+
+static void comb_reset(void)
+{
+#if NONCE_POOL_SIZE > 0
+    CRITICAL_REGION_ENTER();
+    m_pool_ready = 0;
+    memset(m_pool, 0, sizeof(m_pool));
+    CRITICAL_REGION_EXIT();
+#endif
+}
+
+
+static ret_code_t comb_init(void)
+{
+    comb_reset();
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    return NRF_SUCCESS;
+}
+
+
+/**
+ * @brief Precompute a nonce into a free slot of the pool.
+ */
+static bool comb_process(void)
+{
+#if NONCE_POOL_SIZE > 0
+    uint32_t slot;
+
+    for(slot = 0; slot < NONCE_POOL_SIZE; slot++)
+    {
+        if(((m_pool_ready >> slot) & 1) == 0) break;
+    }
+
+    if(slot == NONCE_POOL_SIZE) return false;
+
+    fe_t k;
+    ret_code_t ret;
+    bool done;
+
+    /* The jobs draw random numbers too, and would find the RNG busy. */
+    u2f_worker_suspend();
+    ret = scalar_random(k);
+    u2f_worker_resume();
+
+    done = (ret == NRF_SUCCESS) && nonce_from_scalar(&m_pool[slot], k);
+
+    memset(k, 0, sizeof(k));
+
+    if(!done)
+    {
+        memset(&m_pool[slot], 0, sizeof(nonce_t));
+        return (ret == NRF_SUCCESS);
+    }
+
+    CRITICAL_REGION_ENTER();
+    m_pool_ready |= 1UL << slot;
+    CRITICAL_REGION_EXIT();
+
+    m_stats.pool_filled++;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void u2f_crypto_comb_stats_get(u2f_crypto_comb_stats_t * p_stats)
+{
+    memcpy(p_stats, &m_stats, sizeof(m_stats));
+
+#if NONCE_POOL_SIZE > 0
+    uint32_t ready = m_pool_ready;
+
+    p_stats->pool_ready = 0;
+    for(; ready != 0; ready &= ready - 1)
+    {
+        p_stats->pool_ready++;
+    }
+#endif
+    p_stats->pool_size = NONCE_POOL_SIZE;
+}
+
+
+u2f_crypto_backend_t const g_u2f_crypto_comb =
+{
+    .p_name  = "comb",
+    .init    = comb_init,
+    .process = comb_process,
+    .keygen  = comb_keygen,
+    .sign    = comb_sign,
+
+    .public_key = comb_public_key,
+    .sign_batch = comb_sign_batch,
+};
+
+#endif // NRF_MODULE_ENABLED(U2F_CRYPTO_COMB)
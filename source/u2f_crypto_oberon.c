@@ -0,0 +1,86 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "app_util.h"
+#include "nrf_crypto_error.h"
+
+#include "u2f_crypto.h"
+#include "u2f_crypto_backend.h"
+
+#include "sdk_config.h"
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_OBERON)
+
+#include "ocrypto_sha256.h"
+
+/*
+ * The Oberon library is called directly: nrf_crypto builds a single
+ * backend per algorithm, CC310 for SHA-256. It runs on the CPU, without
+ * the setup of a CryptoCell operation, which makes it the faster one on
+ * short inputs, see U2F_CRYPTO_HASH_SW_THRESHOLD.
+ */
+
+
+static ret_code_t oberon_hash(u2f_crypto_chunk_t const * p_chunks, size_t count,
+                              uint8_t * p_digest)
+{
+    ocrypto_sha256_ctx context;
+
+    if(count == 1)
+    {
+        ocrypto_sha256(p_digest, p_chunks[0].p_data, p_chunks[0].size);
+        return NRF_SUCCESS;
+    }
+
+    ocrypto_sha256_init(&context);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        ocrypto_sha256_update(&context, p_chunks[i].p_data, p_chunks[i].size);
+    }
+
+    ocrypto_sha256_final(&context, p_digest);
+
+    return NRF_SUCCESS;
+}
+
+
+u2f_crypto_backend_t const g_u2f_crypto_oberon =
+{
+    .p_name = "oberon",
+    .hash   = oberon_hash,
+};
+
+#endif // NRF_MODULE_ENABLED(U2F_CRYPTO_OBERON)
@@ -0,0 +1,162 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "app_util.h"
+#include "nrf_crypto.h"
+#include "nrf_crypto_error.h"
+
+#include "u2f_crypto.h"
+#include "u2f_crypto_backend.h"
+
+#include "sdk_config.h"
+
+#if NRF_MODULE_ENABLED(U2F_CRYPTO_MICRO_ECC)
+
+#include "uECC.h"
+
+/*
+ * micro-ecc is called directly: nrf_crypto builds a single backend per
+ * curve, CC310 for secp256r1. The SDK builds micro_ecc_lib_nrf52.a with
+ * uECC_VLI_NATIVE_LITTLE_ENDIAN=1, so the keys, the hash and the signature
+ * are byte swapped, as the nrf_crypto micro-ecc backend does.
+ */
+
+
+/**
+ * @brief Reverse the bytes of each of the @p count numbers of @p size bytes.
+ */
+static void swap_endian(uint8_t * p_out, uint8_t const * p_in, size_t size,
+                        size_t count)
+{
+    for(size_t n = 0; n < count; n++)
+    {
+        for(size_t i = 0; i < size; i++)
+        {
+            p_out[n * size + i] = p_in[n * size + size - 1 - i];
+        }
+    }
+}
+
+
+static int uecc_rng(uint8_t * p_dest, unsigned size)
+{
+    return u2f_crypto_random(p_dest, size) == NRF_SUCCESS;
+}
+
+
+static ret_code_t uecc_init(void)
+{
+    uECC_set_rng(uecc_rng);
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t uecc_keygen(uint8_t * p_private_key, uint8_t * p_public_key)
+{
+    uint8_t private_key[U2F_CRYPTO_PRIVATE_KEY_SIZE];
+    uint8_t public_key[U2F_CRYPTO_PUBLIC_KEY_SIZE];
+
+    if(!uECC_make_key(public_key, private_key, uECC_secp256r1()))
+    {
+        return NRF_ERROR_CRYPTO_INTERNAL;
+    }
+
+    swap_endian(p_private_key, private_key, U2F_CRYPTO_PRIVATE_KEY_SIZE, 1);
+    swap_endian(p_public_key, public_key, U2F_CRYPTO_PUBLIC_KEY_SIZE / 2, 2);
+
+    memset(private_key, 0, sizeof(private_key));
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t uecc_public_key(uint8_t const * p_private_key,
+                                  uint8_t * p_public_key)
+{
+    uint8_t private_key[U2F_CRYPTO_PRIVATE_KEY_SIZE];
+    uint8_t public_key[U2F_CRYPTO_PUBLIC_KEY_SIZE];
+    int ok;
+
+    swap_endian(private_key, p_private_key, U2F_CRYPTO_PRIVATE_KEY_SIZE, 1);
+
+    /* Refuses a key out of [1, n - 1] */
+    ok = uECC_compute_public_key(private_key, public_key, uECC_secp256r1());
+
+    memset(private_key, 0, sizeof(private_key));
+
+    if(!ok) return NRF_ERROR_CRYPTO_ECC_INVALID_KEY;
+
+    swap_endian(p_public_key, public_key, U2F_CRYPTO_PUBLIC_KEY_SIZE / 2, 2);
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t uecc_sign(uint8_t const * p_private_key,
+                            uint8_t const * p_hash,
+                            uint8_t * p_signature)
+{
+    uint8_t private_key[U2F_CRYPTO_PRIVATE_KEY_SIZE];
+    uint8_t hash[U2F_CRYPTO_HASH_SIZE];
+    uint8_t signature[U2F_CRYPTO_SIGNATURE_SIZE];
+    int ok;
+
+    swap_endian(private_key, p_private_key, U2F_CRYPTO_PRIVATE_KEY_SIZE, 1);
+    swap_endian(hash, p_hash, U2F_CRYPTO_HASH_SIZE, 1);
+
+    ok = uECC_sign(private_key, hash, sizeof(hash), signature, uECC_secp256r1());
+
+    memset(private_key, 0, sizeof(private_key));
+
+    if(!ok) return NRF_ERROR_CRYPTO_INTERNAL;
+
+    swap_endian(p_signature, signature, U2F_CRYPTO_SIGNATURE_SIZE / 2, 2);
+
+    return NRF_SUCCESS;
+}
+
+
+u2f_crypto_backend_t const g_u2f_crypto_micro_ecc =
+{
+    .p_name = "micro-ecc",
+    .init   = uecc_init,
+    .keygen = uecc_keygen,
+    .sign   = uecc_sign,
+
+    .public_key = uecc_public_key,
+};
+
+#endif // NRF_MODULE_ENABLED(U2F_CRYPTO_MICRO_ECC)
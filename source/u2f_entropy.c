@@ -0,0 +1,257 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "nrf.h"
+#include "nrf_rng.h"
+#include "app_util_platform.h"
+
+#include "ocrypto_sha256.h"
+
+#include "u2f_entropy.h"
+
+#include "sdk_config.h"
+
+#if NRF_MODULE_ENABLED(U2F_ENTROPY)
+
+/*
+ * Health tests of SP 800-90B 4.4 on the bytes of the RNG, bias corrected,
+ * for a claimed min-entropy of 4 bits a byte and a false positive rate of
+ * 2^-20. A failure empties the pool and runs the startup tests again.
+ */
+#define RCT_CUTOFF          6       // 1 + ceil(20 / 4)
+#define APT_WINDOW          512
+#define APT_CUTOFF          62
+#define STARTUP_SAMPLES     1024
+
+/*
+ * The raw bytes are conditioned by SHA-256 before they are served, two of
+ * them for each byte out, so that an output byte carries the 8 bits the
+ * health tests give two raw ones.
+ */
+#define RAW_PER_BYTE        2
+
+
+/**
+ * @brief Pool, filled by the RNG interrupt and emptied from the top.
+ */
+static uint8_t m_pool[U2F_ENTROPY_POOL_SIZE];
+
+static uint32_t volatile m_level;
+
+/** The RNG runs, stopped when the pool is full. */
+static bool volatile m_running;
+
+/** Samples to test before the pool takes any. */
+static uint32_t m_startup;
+
+/** Repetition count test. */
+static uint8_t  m_rct_sample;
+static uint32_t m_rct_count;
+
+/** Adaptive proportion test. */
+static uint8_t  m_apt_sample;
+static uint32_t m_apt_count;
+static uint32_t m_apt_index;
+
+static u2f_entropy_stats_t m_stats;
+
+
+/**
+ * @brief Run the health tests on a new sample.
+ *
+ * @retval false  A test failed.
+ */
+static bool health_test(uint8_t sample)
+{
+    bool pass = true;
+
+    if(m_rct_count > 0 && sample == m_rct_sample)
+    {
+        if(++m_rct_count >= RCT_CUTOFF)
+        {
+            m_stats.rct_failures++;
+            m_rct_count = 1;
+            pass = false;
+        }
+    }
+    else
+    {
+        m_rct_sample = sample;
+        m_rct_count = 1;
+    }
+
+    if(m_apt_index == 0)
+    {
+        m_apt_sample = sample;
+        m_apt_count = 1;
+    }
+    else if(sample == m_apt_sample && ++m_apt_count >= APT_CUTOFF)
+    {
+        m_stats.apt_failures++;
+        m_apt_index = 0;
+        return false;
+    }
+
+    m_apt_index = (m_apt_index + 1) % APT_WINDOW;
+
+    return pass;
+}
+
+
+void RNG_IRQHandler(void)
+{
+    if(!nrf_rng_event_get(NRF_RNG_EVENT_VALRDY)) return;
+
+    uint8_t sample = nrf_rng_random_value_get();
+
+    nrf_rng_event_clear(NRF_RNG_EVENT_VALRDY);
+    m_stats.samples++;
+
+    if(!health_test(sample))
+    {
+        memset(m_pool, 0, sizeof(m_pool));
+        m_level = 0;
+        m_startup = STARTUP_SAMPLES;
+        return;
+    }
+
+    if(m_startup > 0)
+    {
+        m_startup--;
+        return;
+    }
+
+    if(m_level < U2F_ENTROPY_POOL_SIZE)
+    {
+        m_pool[m_level++] = sample;
+    }
+
+    if(m_level == U2F_ENTROPY_POOL_SIZE)
+    {
+        nrf_rng_task_trigger(NRF_RNG_TASK_STOP);
+        m_running = false;
+    }
+}
+
+
+ret_code_t u2f_entropy_init(void)
+{
+    NVIC_DisableIRQ(RNG_IRQn);
+    nrf_rng_task_trigger(NRF_RNG_TASK_STOP);
+
+    memset(m_pool, 0, sizeof(m_pool));
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_level = 0;
+    m_startup = STARTUP_SAMPLES;
+    m_rct_count = 0;
+    m_apt_index = 0;
+
+    nrf_rng_error_correction_enable();
+    nrf_rng_event_clear(NRF_RNG_EVENT_VALRDY);
+    nrf_rng_int_enable(NRF_RNG_INT_VALRDY_MASK);
+
+    NVIC_SetPriority(RNG_IRQn, U2F_ENTROPY_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(RNG_IRQn);
+    NVIC_EnableIRQ(RNG_IRQn);
+
+    m_running = true;
+    nrf_rng_task_trigger(NRF_RNG_TASK_START);
+
+    return NRF_SUCCESS;
+}
+
+
+bool u2f_entropy_get(uint8_t * p_out, size_t size)
+{
+    uint8_t raw[RAW_PER_BYTE * U2F_ENTROPY_GET_MAX];
+    uint8_t digest[U2F_ENTROPY_GET_MAX];
+    size_t raw_size = RAW_PER_BYTE * size;
+    bool taken = false;
+    bool start = false;
+
+    STATIC_ASSERT(U2F_ENTROPY_GET_MAX == sizeof(digest));
+
+    if(size > U2F_ENTROPY_GET_MAX) return false;
+
+    CRITICAL_REGION_ENTER();
+    m_stats.requests++;
+    if(raw_size <= m_level)
+    {
+        m_level -= raw_size;
+        memcpy(raw, &m_pool[m_level], raw_size);
+        memset(&m_pool[m_level], 0, raw_size);
+        m_stats.served += raw_size;
+        taken = true;
+    }
+    else
+    {
+        m_stats.dry++;
+    }
+    if(!m_running && m_level < U2F_ENTROPY_POOL_SIZE)
+    {
+        m_running = true;
+        start = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if(start)
+    {
+        nrf_rng_task_trigger(NRF_RNG_TASK_START);
+    }
+
+    if(taken)
+    {
+        ocrypto_sha256(digest, raw, raw_size);
+        memcpy(p_out, digest, size);
+
+        memset(raw, 0, sizeof(raw));
+        memset(digest, 0, sizeof(digest));
+    }
+
+    return taken;
+}
+
+
+void u2f_entropy_stats_get(u2f_entropy_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    memcpy(p_stats, &m_stats, sizeof(m_stats));
+    p_stats->pool_level = m_level;
+    CRITICAL_REGION_EXIT();
+
+    p_stats->pool_size = U2F_ENTROPY_POOL_SIZE;
+}
+
+#endif // NRF_MODULE_ENABLED(U2F_ENTROPY)
@@ -42,10 +42,24 @@
 #include "u2f_hid_if.h"
 
 #include "mem_manager.h"
+#include "app_timer.h"
 #include "timer_interface.h"
+#include "timer_heap.h"
+#include "u2f_worker.h"
+#include "u2f_stats.h"
+#include "u2f_trace.h"
+#include "u2f_vendor.h"
+
+#include "sdk_config.h"
 
 #define NRF_LOG_MODULE_NAME u2f_hid
 
+#if U2F_HID_CONFIG_LOG_ENABLED
+#define NRF_LOG_LEVEL       U2F_HID_CONFIG_LOG_LEVEL
+#else
+#define NRF_LOG_LEVEL       0
+#endif
+
 #include "nrf_log.h"
 
 NRF_LOG_MODULE_REGISTER();
@@ -54,6 +68,13 @@ NRF_LOG_MODULE_REGISTER();
 
 #define CID_STATE_IDLE      1
 #define CID_STATE_READY     2
+#define CID_STATE_BUSY      3   // U2F message handed to the worker
+
+/* The frame layer runs in a software interrupt at the USB event priority. */
+#define U2F_HID_IRQn            SWI1_EGU1_IRQn
+#define U2F_HID_IRQHandler      SWI1_EGU1_IRQHandler
+#define U2F_HID_IRQ_PRIORITY    USBD_CONFIG_IRQ_PRIORITY
+
 
 
 typedef struct { struct u2f_channel *pFirst, *pLast; } u2f_channel_list_t;
@@ -64,8 +85,10 @@ typedef struct u2f_channel {
     uint32_t cid;
     uint8_t cmd;
     uint8_t state;
-    Timer timer;
+    timer_heap_node_t timeout;
     uint16_t bcnt;
+    uint16_t resp_len;
+    uint32_t start;     // Cycle count at the start of the command
     uint8_t req[U2F_MAX_REQ_SIZE];
     uint8_t resp[U2F_MAX_RESP_SIZE];
 } u2f_channel_t;
@@ -85,6 +108,20 @@ typedef struct __attribute__ ((__packed__))
 extern bool is_user_button_pressed(void);
 
 
+/**
+ * @brief Wakes the frame layer up at the next deadline.
+ *
+ */
+APP_TIMER_DEF(m_u2f_hid_wake_timer);
+
+
+/**
+ * @brief Channel timeouts, ordered by deadline.
+ *
+ */
+TIMER_HEAP_DEF(m_u2f_ch_timers, MAX_U2F_CHANNELS + 1);
+
+
 /**
  * @brief List of channels.
  *
@@ -123,6 +160,7 @@ static u2f_channel_t * u2f_channel_alloc(void)
     else
     {
         m_channel_used_cnt++;       
+        u2f_stats_hwm_update(U2F_STATS_HWM_CHANNELS, m_channel_used_cnt);
     }
 
     return p_ch;
@@ -145,6 +183,9 @@ static void u2f_channel_init(u2f_channel_t * p_ch, uint32_t cid)
     p_ch->state = CID_STATE_IDLE;
     p_ch->pPrev = NULL;
     p_ch->pNext = NULL;
+    timer_heap_node_init(&p_ch->timeout);
+
+    U2F_TRACE(U2F_TRACE_EV_CH_ALLOC, cid, 0);
 
     if(m_u2f_ch_list.pFirst == NULL)
     {
@@ -166,6 +207,10 @@ static void u2f_channel_init(u2f_channel_t * p_ch, uint32_t cid)
  */
 static void u2f_channel_deinit(u2f_channel_t * p_ch)
 {
+    timer_heap_remove(&m_u2f_ch_timers, &p_ch->timeout);
+
+    U2F_TRACE(U2F_TRACE_EV_CH_FREE, p_ch->cid, 0);
+
     if(p_ch->pPrev == NULL && p_ch->pNext == NULL)  //only one item in the list
     {
         m_u2f_ch_list.pFirst = m_u2f_ch_list.pLast = NULL;
@@ -190,6 +235,22 @@ static void u2f_channel_deinit(u2f_channel_t * p_ch)
 }
 
 
+/**@brief (Re)start the transaction timeout of a U2F Channel.
+ *
+ * The broadcast channel never times out.
+ *
+ * @param[in]  p_ch  Pointer to U2F Channel.
+ *
+ */
+static void u2f_channel_timer_start(u2f_channel_t * p_ch)
+{
+    if(p_ch->cid == CID_BROADCAST) return;
+
+    UNUSED_RETURN_VALUE(timer_heap_insert(&m_u2f_ch_timers, &p_ch->timeout,
+                            current_time_ms() + U2FHID_TRANS_TIMEOUT));
+}
+
+
 /**@brief Find the U2F Channel by cid.
  *
  * @param[in]  cid  Channel identifier.
@@ -237,6 +298,7 @@ static uint32_t generate_new_cid(void)
  */
 static void u2f_hid_error_response(uint32_t cid, uint8_t error)
 {
+    U2F_TRACE(U2F_TRACE_EV_ERROR, cid, error);
     u2f_hid_if_send(cid, U2FHID_ERROR, &error, 1);
 }
 
@@ -264,6 +326,7 @@ static void u2f_hid_init_response(u2f_channel_t *p_ch)
     }
 
     u2f_channel_init(p_new_ch, generate_new_cid());
+    u2f_channel_timer_start(p_new_ch);
 
     memcpy(p_resp_init->nonce, p_ch->req, INIT_NONCE_SIZE);
 
@@ -293,7 +356,7 @@ static void u2f_hid_wink_response(u2f_channel_t *p_ch)
 }
 
 
-/**@brief Send a U2F HID status code only
+/**@brief Set a U2F HID status code only as response
  *
  * @param[in]  p_ch    Pointer to U2F Channel.
  * @param[in]  status  U2F HID status code.
@@ -301,24 +364,27 @@ static void u2f_hid_wink_response(u2f_channel_t *p_ch)
  */
 static void u2f_hid_status_response(u2f_channel_t * p_ch, uint16_t status)
 {
-    uint8_t be_status[2];
-    uint8_t size = uint16_big_encode(status, be_status);
-
-    u2f_hid_if_send(p_ch->cid, p_ch->cmd, be_status, size);
+    p_ch->resp_len = uint16_big_encode(status, p_ch->resp);
 }
 
 
-/**@brief Handle a U2FHID MESSAGE response
+/**@brief Execute a U2FHID MESSAGE, runs in the worker context.
  *
- * @param[in]  p_ch  Pointer to U2F Channel.
+ * The response is left in the channel and sent by the frame layer 
+ * when the job completes.
+ *
+ * @param[in]  p_context  Pointer to U2F Channel.
  * 
  */
-static void u2f_hid_msg_response(u2f_channel_t * p_ch)
+static void u2f_hid_msg_execute(void * p_context)
 {
+    u2f_channel_t * p_ch = (u2f_channel_t *)p_context;
     u2f_req_apdu_header_t * p_req_apdu_hdr = (u2f_req_apdu_header_t *)p_ch->req;
 
     uint32_t req_size;
 
+    U2F_TRACE(U2F_TRACE_EV_MSG_START, p_ch->cid, p_req_apdu_hdr->ins);
+
     if(p_req_apdu_hdr->cla != 0)
     {
         u2f_hid_status_response(p_ch, U2F_SW_CLA_NOT_SUPPORTED);
@@ -332,6 +398,7 @@ static void u2f_hid_msg_response(u2f_channel_t * p_ch)
     switch(p_req_apdu_hdr->ins)
     {
         case U2F_REGISTER:
+        case U2F_VENDOR_REGISTER_ALG:
         {
             U2F_REGISTER_REQ *p_req = (U2F_REGISTER_REQ *)(p_req_apdu_hdr + 1);
             U2F_REGISTER_RESP *p_resp = (U2F_REGISTER_RESP *)p_ch->resp;
@@ -346,11 +413,19 @@ static void u2f_hid_msg_response(u2f_channel_t * p_ch)
             uint16_t status, len = 0;
             uint8_t be_status[2];
 
-            status = u2f_register(p_req, p_resp, p_req_apdu_hdr->p1, &len);
+            if(p_req_apdu_hdr->ins == U2F_VENDOR_REGISTER_ALG)
+            {
+                status = u2f_register_alg(p_req, p_resp, p_req_apdu_hdr->p1,
+                                          p_req_apdu_hdr->p2, &len);
+            }
+            else
+            {
+                status = u2f_register(p_req, p_resp, p_req_apdu_hdr->p1, &len);
+            }
 
             if(status == U2F_SW_CONDITIONS_NOT_SATISFIED)
             {
-                NRF_LOG_WARNING("Press to register the device now...");
+                NRF_LOG_INFO("Press to register the device now...");
             }
             else if(status != U2F_SW_NO_ERROR)
             {
@@ -365,8 +440,7 @@ static void u2f_hid_msg_response(u2f_channel_t * p_ch)
 
             memcpy(p_ch->resp + len, be_status, size);
 
-            u2f_hid_if_send(p_ch->cid, p_ch->cmd, p_ch->resp, len + size);
-
+            p_ch->resp_len = len + size;
         }
         break;
 
@@ -389,7 +463,7 @@ static void u2f_hid_msg_response(u2f_channel_t * p_ch)
 
             if(status == U2F_SW_CONDITIONS_NOT_SATISFIED)
             {
-                NRF_LOG_WARNING("Press to authenticate your device now...");
+                NRF_LOG_INFO("Press to authenticate your device now...");
             }
             else if(status != U2F_SW_NO_ERROR)
             {
@@ -404,7 +478,7 @@ static void u2f_hid_msg_response(u2f_channel_t * p_ch)
             
             memcpy(p_ch->resp + len, be_status, size);
 
-            u2f_hid_if_send(p_ch->cid, p_ch->cmd, p_ch->resp, len + size);    
+            p_ch->resp_len = len + size;
         }
         break;
 
@@ -426,14 +500,16 @@ static void u2f_hid_msg_response(u2f_channel_t * p_ch)
             memcpy(p_ch->resp, ver_str, len);
             memcpy(p_ch->resp + len, be_status, size);
 
-            u2f_hid_if_send(p_ch->cid, p_ch->cmd, p_ch->resp, len + size);
+            p_ch->resp_len = len + size;
         }
         break;
 
         case U2F_CHECK_REGISTER:
+            p_ch->resp_len = 0;
             break;
 
         case U2F_AUTHENTICATE_BATCH:
+            p_ch->resp_len = 0;
             break;
 
         default:
@@ -476,6 +552,28 @@ static void u2f_hid_lock_response(u2f_channel_t *p_ch)
 }
 
 
+/**@brief Handle a U2FHID vendor command response
+ *
+ * @param[in]  p_ch  Pointer to U2F Channel.
+ * 
+ */
+static void u2f_hid_vendor_response(u2f_channel_t *p_ch)
+{
+    uint16_t len = sizeof(p_ch->resp);
+    uint8_t err;
+
+    err = u2f_vendor_cmd_process(p_ch->cmd, p_ch->req, p_ch->bcnt, 
+                                 p_ch->resp, &len);
+    if(err != ERR_NONE)
+    {
+        u2f_hid_error_response(p_ch->cid, err);
+        return;
+    }
+
+    u2f_hid_if_send(p_ch->cid, p_ch->cmd, p_ch->resp, len);
+}
+
+
 /**@brief Process U2FHID command
  *
  * @param[in]  p_ch  Pointer to U2F Channel.
@@ -484,10 +582,14 @@ static void u2f_hid_lock_response(u2f_channel_t *p_ch)
 static void u2f_channel_cmd_process(u2f_channel_t * p_ch)
 {
 
-    countdown_ms(&p_ch->timer, U2FHID_TRANS_TIMEOUT);
+    u2f_channel_timer_start(p_ch);
 
     if(p_ch->state != CID_STATE_READY) return;
 
+    p_ch->start = u2f_stats_cycles_get();
+
+    U2F_TRACE(U2F_TRACE_EV_CMD, p_ch->cid, p_ch->cmd);
+
     switch(p_ch->cmd)
     {
         case U2FHID_PING:
@@ -497,7 +599,17 @@ static void u2f_channel_cmd_process(u2f_channel_t * p_ch)
 
         case U2FHID_MSG:
             NRF_LOG_INFO("U2FHID_MSG.");
-            u2f_hid_msg_response(p_ch);
+            // The response is sent on completion, see u2f_hid_msg_complete()
+            p_ch->state = CID_STATE_BUSY;
+            U2F_TRACE(U2F_TRACE_EV_CH_STATE, p_ch->cid, p_ch->state);
+            timer_heap_remove(&m_u2f_ch_timers, &p_ch->timeout);
+            u2f_hid_if_trans_begin(p_ch->cid);
+            if(u2f_worker_submit(u2f_hid_msg_execute, p_ch) == NRF_SUCCESS)
+            {
+                return;
+            }
+            u2f_hid_if_trans_end();
+            u2f_hid_error_response(p_ch->cid, ERR_CHANNEL_BUSY);
             break;
 
         case U2FHID_LOCK:
@@ -520,48 +632,109 @@ static void u2f_channel_cmd_process(u2f_channel_t * p_ch)
             u2f_hid_sync_response(p_ch);
             break;
 
-        case U2FHID_VENDOR_FIRST:
-            NRF_LOG_INFO("U2FHID_VENDOR_FIRST.");
-            break;
-
-        case U2FHID_VENDOR_LAST:
-            NRF_LOG_INFO("U2FHID_VENDOR_LAST.");
-            break;
-
         default:
+            if(p_ch->cmd >= U2FHID_VENDOR_FIRST && p_ch->cmd <= U2FHID_VENDOR_LAST)
+            {
+                NRF_LOG_INFO("U2FHID_VENDOR: 0x%02x.", p_ch->cmd);
+                u2f_hid_vendor_response(p_ch);
+                break;
+            }
             NRF_LOG_WARNING("Unknown Command: %d", p_ch->cmd);
             break;
     }
 
+    u2f_stats_cmd_record(p_ch->cmd, p_ch->start);
+
     p_ch->state = CID_STATE_IDLE;
+    U2F_TRACE(U2F_TRACE_EV_CH_STATE, p_ch->cid, p_ch->state);
+}
+
+/**@brief Send the responses of the U2F messages completed by the worker.
+ * 
+ */
+static void u2f_hid_msg_complete(void)
+{
+    void * p_context;
+
+    while(u2f_worker_done_get(&p_context))
+    {
+        u2f_channel_t * p_ch = (u2f_channel_t *)p_context;
+
+        U2F_TRACE(U2F_TRACE_EV_MSG_DONE, p_ch->cid, p_ch->resp_len);
+
+        if(p_ch->resp_len > 0)
+        {
+            u2f_hid_if_send(p_ch->cid, p_ch->cmd, p_ch->resp, p_ch->resp_len);
+        }
+
+        u2f_stats_cmd_record(p_ch->cmd, p_ch->start);
+        u2f_stats_ins_record(((u2f_req_apdu_header_t *)p_ch->req)->ins, 
+                             p_ch->start);
+
+        u2f_channel_timer_start(p_ch);
+        p_ch->state = CID_STATE_IDLE;
+        U2F_TRACE(U2F_TRACE_EV_CH_STATE, p_ch->cid, p_ch->state);
+
+        u2f_hid_if_trans_end();
+    }
 }
 
-/**@brief Process U2FHID command of every ready channel.
+/**@brief Free the channels whose transaction timeout expired.
  * 
  */
 static void u2f_channel_process(void)
 {
-    u2f_channel_t *p_ch;
+    timer_heap_node_t * p_node;
+    uint64_t now = current_time_ms();
 
-    for(p_ch = m_u2f_ch_list.pFirst; p_ch != NULL;)
+    while((p_node = timer_heap_pop_expired(&m_u2f_ch_timers, now)) != NULL)
     {
-        
+        u2f_channel_t * p_ch = CONTAINER_OF(p_node, u2f_channel_t, timeout);
+
         // Transaction timeout, free the channel
-        if(has_timer_expired(&p_ch->timer) && p_ch->state == CID_STATE_IDLE)
+        if(p_ch->state == CID_STATE_IDLE)
         {
-            if(p_ch->cid != CID_BROADCAST)
-            {
-                u2f_channel_t * p_free_ch = p_ch;
-                p_ch = p_ch->pNext;
-                u2f_channel_deinit(p_free_ch);
-                continue;
-            }
+            u2f_channel_deinit(p_ch);
         }
-        p_ch = p_ch->pNext;
     }
 }
 
 
+/**@brief Arm the wake up timer at the next deadline of the frame layer.
+ * 
+ */
+static void u2f_hid_wake_timer_update(void)
+{
+    uint32_t left_ms;
+
+    UNUSED_RETURN_VALUE(app_timer_stop(m_u2f_hid_wake_timer));
+
+    if(!u2f_hid_next_deadline_get(&left_ms)) return;
+
+    UNUSED_RETURN_VALUE(app_timer_start(m_u2f_hid_wake_timer,
+                        MAX(APP_TIMER_TICKS(left_ms), APP_TIMER_MIN_TIMEOUT_TICKS),
+                        NULL));
+}
+
+
+/**@brief Wake up timer handler, runs the channel timeouts.
+ * 
+ */
+static void u2f_hid_wake_handler(void * p_context)
+{
+    u2f_hid_schedule();
+}
+
+
+/**@brief Software interrupt handler running the U2F HID frame layer.
+ * 
+ */
+void U2F_HID_IRQHandler(void)
+{
+    u2f_hid_process();
+}
+
+
 /**
  * @brief Function for initializing the U2F HID.
  *
@@ -579,6 +752,20 @@ ret_code_t u2f_hid_init(void)
         return ret;
     }
 
+    u2f_stats_init();
+
+    u2f_trace_init();
+
+    ret = u2f_worker_init(u2f_hid_schedule);
+    if(ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    NVIC_SetPriority(U2F_HID_IRQn, U2F_HID_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(U2F_HID_IRQn);
+    NVIC_EnableIRQ(U2F_HID_IRQn);
+
     ret = u2f_hid_if_init();
     if(ret != NRF_SUCCESS)
     {
@@ -600,7 +787,46 @@ ret_code_t u2f_hid_init(void)
 
     u2f_channel_init(p_ch, CID_BROADCAST);
 
-    return NRF_SUCCESS;
+    return app_timer_create(&m_u2f_hid_wake_timer, APP_TIMER_MODE_SINGLE_SHOT,
+                            u2f_hid_wake_handler);
+}
+
+
+/**
+ * @brief Get the time left until the next timeout of the frame layer.
+ *
+ */
+bool u2f_hid_next_deadline_get(uint32_t * p_left_ms)
+{
+    timer_heap_node_t * p_node = timer_heap_peek(&m_u2f_ch_timers);
+    bool pending = false;
+    uint32_t left_ms;
+
+    if(p_node != NULL)
+    {
+        uint64_t now = current_time_ms();
+        *p_left_ms = (p_node->deadline > now) ? 
+                     (uint32_t)(p_node->deadline - now) : 0;
+        pending = true;
+    }
+
+    if(u2f_hid_if_rx_pending(&left_ms))
+    {
+        *p_left_ms = pending ? MIN(*p_left_ms, left_ms) : left_ms;
+        pending = true;
+    }
+
+    return pending;
+}
+
+
+/**
+ * @brief Schedule the U2F HID frame layer.
+ *
+ */
+void u2f_hid_schedule(void)
+{
+    NVIC_SetPendingIRQ(U2F_HID_IRQn);
 }
 
 
@@ -608,6 +834,8 @@ ret_code_t u2f_hid_init(void)
 /**
  * @brief U2FHID process function, which should be executed when data is ready.
  *
+ * Runs in the U2F HID software interrupt, see @ref u2f_hid_schedule.
+ *
  */
 void u2f_hid_process(void)
 {
@@ -619,10 +847,18 @@ void u2f_hid_process(void)
 
     u2f_hid_if_process();
 
-    ret = u2f_hid_if_recv(&cid, &cmd, buf, &size, 1000);
+    u2f_hid_msg_complete();
 
-    if(ret == ERR_NONE)
+    while((ret = u2f_hid_if_recv(&cid, &cmd, buf, &size, 1000)) 
+            != U2F_HID_IF_NO_DATA)
     {
+        if(ret != ERR_NONE)
+        {
+            NRF_LOG_WARNING("Receive error: %d", ret);
+            u2f_hid_error_response(cid, ret);
+            continue;
+        }
+
         u2f_channel_t * p_ch;
 
         p_ch = u2f_channel_find(cid);
@@ -630,6 +866,13 @@ void u2f_hid_process(void)
         if(p_ch == NULL)
         {
             NRF_LOG_ERROR("No valid channel found!");
+            u2f_hid_if_stats_invalid_cid_notify();
+            u2f_hid_error_response(cid, ERR_CHANNEL_BUSY);
+        }
+        else if(p_ch->state == CID_STATE_BUSY)
+        {
+            NRF_LOG_WARNING("Channel busy!");
+            u2f_hid_if_stats_busy_notify();
             u2f_hid_error_response(cid, ERR_CHANNEL_BUSY);
         }
         else
@@ -637,11 +880,14 @@ void u2f_hid_process(void)
             p_ch->cmd = cmd;
             p_ch->bcnt = size;
             p_ch->state = CID_STATE_READY;
+            U2F_TRACE(U2F_TRACE_EV_CH_STATE, p_ch->cid, p_ch->state);
             memcpy(p_ch->req, buf, size);
             u2f_channel_cmd_process(p_ch);
         }
     }
 
     u2f_channel_process();
+
+    u2f_hid_wake_timer_update();
 }
 
@@ -31,33 +31,43 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "nrf.h"
+#include "app_util.h"
 #include "app_util_platform.h"
-#include "app_fifo.h"
+#include "nrf_queue.h"
 #include "bsp.h"
+#include "app_timer.h"
 
 #include "timer_interface.h"
 
+#include "u2f.h"
 #include "u2f_hid.h"
 #include "u2f_hid_if.h"
+#include "u2f_power.h"
+#include "u2f_trace.h"
 
 #include "nrf_drv_usbd.h"
 #include "app_usbd.h"
 #include "app_usbd_core.h"
 #include "app_usbd_hid_generic.h"
 
+#include "sdk_config.h"
+
 #define NRF_LOG_MODULE_NAME u2f_hid_if
 
+#if U2F_HID_IF_CONFIG_LOG_ENABLED
+#define NRF_LOG_LEVEL       U2F_HID_IF_CONFIG_LOG_LEVEL
+#else
+#define NRF_LOG_LEVEL       0
+#endif
+
 #include "nrf_log.h"
 
 NRF_LOG_MODULE_REGISTER();
 
 
-//static uint8_t u2f_hid_fifo_buf[1024];
-
-//static app_fifo_t m_u2f_hid_fifo;
-
 /**
  * @brief User event handler.
  * */
@@ -91,48 +101,129 @@ APP_USBD_HID_GENERIC_GLOBAL_DEF(m_app_u2f_hid,
 /*lint -restore*/
 
 
+/**
+ * @brief Reassembly state of the message being received.
+ */
+typedef struct
+{
+    bool     active;                    //!< A message is being reassembled.
+    uint32_t cid;                       //!< Channel identifier.
+    uint8_t  cmd;                       //!< Command.
+    uint8_t  seq;                       //!< Next expected sequence number.
+    size_t   size;                      //!< Total message length.
+    size_t   offset;                    //!< Bytes received so far.
+    Timer    timer;                     //!< Reassembly timeout.
+    uint8_t  data[U2F_MAX_REQ_SIZE];    //!< Message payload.
+} u2f_hid_if_rx_t;
+
+
+/**
+ * @brief Queue of received OUT reports.
+ */
+NRF_QUEUE_DEF(U2FHID_FRAME, m_rx_frame_queue, U2F_HID_IF_RX_QUEUE_SIZE,
+              NRF_QUEUE_MODE_NO_OVERFLOW);
+
+
+/**
+ * @brief Queue of IN reports waiting for transmission.
+ */
+NRF_QUEUE_DEF(U2FHID_FRAME, m_tx_frame_queue, U2F_HID_IF_TX_QUEUE_SIZE,
+              NRF_QUEUE_MODE_NO_OVERFLOW);
+
+
 /**
  * @brief Mark the ongoing transmission
  *
- * Marks that the report buffer is busy and cannot be used until 
+ * Marks that the report buffer is busy and cannot be used until
  * transmission finishes or invalidates (by USB reset or suspend event).
  */
 static bool m_report_pending = false;
 
 
 /**
- * @brief Mark a report received.
+ * @brief IN report being transmitted.
  *
  */
-static bool m_report_received = false;
+static U2FHID_FRAME m_tx_frame;
 
 
 /**
- * \brief send one HID frame. 
+ * @brief Message being reassembled.
+ *
  */
-static uint8_t u2f_hid_if_frame_send(U2FHID_FRAME * p_frame)
+static u2f_hid_if_rx_t m_rx;
+
+
+/**
+ * @brief Transport counters.
+ *
+ * Updated from the USBD interrupt and the frame layer, which run at the 
+ * same priority.
+ */
+static u2f_hid_if_stats_t m_stats;
+
+
+/**
+ * @brief RTC tick count when the pending IN report was handed to USBD.
+ *
+ */
+static uint32_t m_tx_start;
+
+
+/**
+ * @brief Transaction owner.
+ *
+ * Channel whose U2F message is being processed. Messages from any other 
+ * channel are refused with ERR_CHANNEL_BUSY until the transaction ends.
+ */
+static struct
+{
+    bool     active;
+    uint32_t cid;
+} m_trans_owner;
+
+
+/**
+ * \brief Start the transmission of the next queued IN report, if any.
+ */
+static void u2f_hid_if_tx_kick(void)
 {
     ret_code_t ret;
 
-    while(m_report_pending){
-        while (app_usbd_event_queue_process())
-        {
-            /* Nothing to do */
-        }
-    }
+    if(m_report_pending) return;
+
+    if(nrf_queue_pop(&m_tx_frame_queue, &m_tx_frame) != NRF_SUCCESS) return;
 
     ret = app_usbd_hid_generic_in_report_set(
         &m_app_u2f_hid,
-        (uint8_t *)p_frame,
+        (uint8_t *)&m_tx_frame,
         HID_RPT_SIZE);
 
     if(ret == NRF_SUCCESS)
     {
         m_report_pending = true;
-        return ERR_NONE;
+        m_tx_start = app_timer_cnt_get();
+        m_stats.frames_out++;
+        U2F_TRACE(U2F_TRACE_EV_FRAME_TX, m_tx_frame.cid, m_tx_frame.type);
+    }
+    else
+    {
+        NRF_LOG_WARNING("IN report dropped! [code = %d]", ret);
+    }
+}
+
+
+/**
+ * \brief queue one HID frame.
+ */
+static uint8_t u2f_hid_if_frame_send(U2FHID_FRAME * p_frame)
+{
+    if(nrf_queue_push(&m_tx_frame_queue, p_frame) != NRF_SUCCESS)
+    {
+        return ERR_OTHER;
     }
 
-    return ERR_OTHER;
+    return ERR_NONE;
 }
 
 
@@ -141,8 +232,23 @@ uint8_t u2f_hid_if_send(uint32_t cid, uint8_t cmd, uint8_t *p_data, size_t size)
     U2FHID_FRAME frame;
     int ret;
     size_t frameLen;
+    size_t frameCnt;
     uint8_t seq = 0;
 
+    /* Queue the whole message or nothing */
+    frameCnt = 1;
+    if(size > sizeof(frame.init.data))
+    {
+        frameCnt += CEIL_DIV(size - sizeof(frame.init.data),
+                             sizeof(frame.cont.data));
+    }
+    if(nrf_queue_available_get(&m_tx_frame_queue) < frameCnt)
+    {
+        m_stats.tx_queue_full++;
+        NRF_LOG_WARNING("TX queue full!");
+        return ERR_OTHER;
+    }
+
     frame.cid = cid;
     frame.init.cmd = TYPE_INIT | cmd;
     frame.init.bcnth = (size >> 8) & 0xFF;
@@ -152,7 +258,7 @@ uint8_t u2f_hid_if_send(uint32_t cid, uint8_t cmd, uint8_t *p_data, size_t size)
     memset(frame.init.data, 0, sizeof(frame.init.data));
     memcpy(frame.init.data, p_data, frameLen);
 
-    do 
+    do
     {
         ret = u2f_hid_if_frame_send(&frame);
         if(ret != ERR_NONE) return ret;
@@ -166,79 +272,188 @@ uint8_t u2f_hid_if_send(uint32_t cid, uint8_t cmd, uint8_t *p_data, size_t size)
         memcpy(frame.cont.data, p_data, frameLen);
     } while(size);
 
+    u2f_hid_if_tx_kick();
+
     return ERR_NONE;
 }
 
 
 
-uint8_t u2f_hid_if_recv(uint32_t * p_cid, uint8_t * p_cmd, 
+uint8_t u2f_hid_if_recv(uint32_t * p_cid, uint8_t * p_cmd,
                     uint8_t * p_data, size_t * p_size,
                     uint32_t timeout)
 {
-    uint8_t * p_recv_buf;
-    size_t recv_size, totalLen, frameLen;
-    U2FHID_FRAME * p_frame;
-    uint8_t seq = 0;
-
-    Timer timer;
-    countdown_ms(&timer, timeout);
-
-    if(!m_report_received) return ERR_OTHER+1;
-    m_report_received = false;
+    U2FHID_FRAME frame;
+    size_t frameLen;
 
-    p_recv_buf = (uint8_t *)app_usbd_hid_generic_out_report_get(&m_app_u2f_hid, 
-                                                                &recv_size);
+    while(nrf_queue_pop(&m_rx_frame_queue, &frame) == NRF_SUCCESS)
+    {
+        U2F_TRACE(U2F_TRACE_EV_FRAME_RX, frame.cid, frame.type);
 
-    if(recv_size != sizeof(U2FHID_FRAME)) return ERR_OTHER;
+        if(FRAME_TYPE(frame) == TYPE_INIT)
+        {
+            if(m_rx.active && frame.cid != m_rx.cid)
+            {
+                /* Another channel is in the middle of a transaction */
+                m_stats.channel_busy++;
+                *p_cid = frame.cid;
+                return ERR_CHANNEL_BUSY;
+            }
 
-    p_frame = (U2FHID_FRAME *)p_recv_buf;
+            if(m_trans_owner.active && frame.cid != m_trans_owner.cid
+               && frame.init.cmd == U2FHID_MSG)
+            {
+                /* Another channel owns the device, refuse right away */
+                m_stats.channel_busy++;
+                *p_cid = frame.cid;
+                return ERR_CHANNEL_BUSY;
+            }
 
-    if(FRAME_TYPE(*p_frame) != TYPE_INIT) return ERR_INVALID_CMD;
+            /* A new initialization frame on the same channel aborts the
+             * current transaction */
+            m_rx.active = false;
 
-    *p_cid = p_frame->cid;
-    *p_cmd = p_frame->init.cmd;
+            if(MSG_LEN(frame) > sizeof(m_rx.data))
+            {
+                m_stats.invalid_len++;
+                *p_cid = frame.cid;
+                return ERR_INVALID_LEN;
+            }
 
-    totalLen = MSG_LEN(*p_frame);
-    frameLen = MIN(sizeof(p_frame->init.data), totalLen);
+            m_rx.cid = frame.cid;
+            m_rx.cmd = frame.init.cmd;
+            m_rx.seq = 0;
+            m_rx.size = MSG_LEN(frame);
 
-    *p_size = totalLen;
+            frameLen = MIN(sizeof(frame.init.data), m_rx.size);
+            memcpy(m_rx.data, frame.init.data, frameLen);
+            m_rx.offset = frameLen;
 
-    memcpy(p_data, p_frame->init.data, frameLen);
-    totalLen -= frameLen;
-    p_data += frameLen;
+            m_rx.active = true;
+            countdown_ms(&m_rx.timer, timeout);
 
-    while(totalLen)
-    {
-        while(!m_report_received)
+#if NRF_MODULE_ENABLED(U2F_POWER)
+            if(m_rx.cmd == U2FHID_INIT || m_rx.cmd == U2FHID_MSG)
+            {
+                /* Power the CryptoCell up while the rest comes in */
+                u2f_power_warm();
+            }
+#endif
+        }
+        else
         {
-            while (app_usbd_event_queue_process())
+            /* Spurious continuation frame */
+            if(!m_rx.active || frame.cid != m_rx.cid)
+            {
+                m_stats.invalid_cid++;
+                continue;
+            }
+
+            if(FRAME_SEQ(frame) != m_rx.seq++)
             {
-                /* Nothing to do */
+                m_stats.invalid_seq++;
+                m_rx.active = false;
+                *p_cid = frame.cid;
+                return ERR_INVALID_SEQ;
             }
-            if(has_timer_expired(&timer)) return ERR_MSG_TIMEOUT;
+
+            frameLen = MIN(sizeof(frame.cont.data), m_rx.size - m_rx.offset);
+            memcpy(m_rx.data + m_rx.offset, frame.cont.data, frameLen);
+            m_rx.offset += frameLen;
         }
-        m_report_received = false;
 
-        p_recv_buf = (uint8_t *)app_usbd_hid_generic_out_report_get(
-                                                                &m_app_u2f_hid, 
-                                                                &recv_size);
+        if(m_rx.offset == m_rx.size)
+        {
+            m_rx.active = false;
 
-        if(recv_size != sizeof(U2FHID_FRAME)) continue;
+            *p_cid = m_rx.cid;
+            *p_cmd = m_rx.cmd;
+            *p_size = m_rx.size;
+            memcpy(p_data, m_rx.data, m_rx.size);
 
-        p_frame = (U2FHID_FRAME *)p_recv_buf;
+            return ERR_NONE;
+        }
+    }
 
-        if(p_frame->cid != *p_cid) continue;
-        if(FRAME_TYPE(*p_frame) != TYPE_CONT) return ERR_INVALID_SEQ;
-        if(FRAME_SEQ(*p_frame) != seq++) return ERR_INVALID_SEQ;
+    if(m_rx.active && has_timer_expired(&m_rx.timer))
+    {
+        m_stats.timeouts++;
+        m_rx.active = false;
+        *p_cid = m_rx.cid;
+        return ERR_MSG_TIMEOUT;
+    }
 
-        frameLen = MIN(sizeof(p_frame->cont.data), totalLen);
+    return U2F_HID_IF_NO_DATA;
+}
 
-        memcpy(p_data, p_frame->cont.data, frameLen);
-        totalLen -= frameLen;
-        p_data += frameLen;
+
+bool u2f_hid_if_rx_pending(uint32_t * p_left_ms)
+{
+    if(!m_rx.active) return false;
+
+    *p_left_ms = left_ms(&m_rx.timer);
+    return true;
+}
+
+
+void u2f_hid_if_stats_get(u2f_hid_if_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats;
+    CRITICAL_REGION_EXIT();
+
+    p_stats->rx_queue_hwm = nrf_queue_max_utilization_get(&m_rx_frame_queue);
+    p_stats->tx_queue_hwm = nrf_queue_max_utilization_get(&m_tx_frame_queue);
+}
+
+
+uint16_t u2f_hid_if_stats_encode(uint8_t * p_buf)
+{
+    u2f_hid_if_stats_t stats;
+    uint32_t const * p_counter = (uint32_t const *)&stats;
+    uint16_t len = 0;
+
+    u2f_hid_if_stats_get(&stats);
+
+    for(uint32_t i = 0; i < sizeof(stats) / sizeof(uint32_t); i++)
+    {
+        len += uint32_encode(p_counter[i], &p_buf[len]);
     }
 
-    return ERR_NONE;
+    return len;
+}
+
+
+void u2f_hid_if_stats_reset(void)
+{
+    CRITICAL_REGION_ENTER();
+    memset(&m_stats, 0, sizeof(m_stats));
+    CRITICAL_REGION_EXIT();
+}
+
+
+void u2f_hid_if_stats_invalid_cid_notify(void)
+{
+    m_stats.invalid_cid++;
+}
+
+
+void u2f_hid_if_stats_busy_notify(void)
+{
+    m_stats.channel_busy++;
+}
+
+
+void u2f_hid_if_trans_begin(uint32_t cid)
+{
+    m_trans_owner.cid = cid;
+    m_trans_owner.active = true;
+}
+
+
+void u2f_hid_if_trans_end(void)
+{
+    m_trans_owner.active = false;
 }
 
 
@@ -256,12 +471,34 @@ static void hid_user_ev_handler(app_usbd_class_inst_t const * p_inst,
     {
         case APP_USBD_HID_USER_EVT_OUT_REPORT_READY:
         {
-            m_report_received = true;
+            size_t recv_size;
+            uint8_t const * p_recv_buf = app_usbd_hid_generic_out_report_get(
+                                                                &m_app_u2f_hid,
+                                                                &recv_size);
+            if(recv_size != sizeof(U2FHID_FRAME))
+            {
+                m_stats.invalid_len++;
+                break;
+            }
+
+            m_stats.frames_in++;
+
+            if(nrf_queue_push(&m_rx_frame_queue, p_recv_buf) != NRF_SUCCESS)
+            {
+                m_stats.rx_queue_full++;
+                NRF_LOG_WARNING("OUT report dropped!");
+            }
             break;
         }
         case APP_USBD_HID_USER_EVT_IN_REPORT_DONE:
         {
+            uint32_t wait_us = (uint32_t)(
+                app_timer_cnt_diff_compute(app_timer_cnt_get(), m_tx_start) 
+                * 1000000ULL / APP_TIMER_CLOCK_FREQ);
+            m_stats.tx_wait_max_us = MAX(m_stats.tx_wait_max_us, wait_us);
+
             m_report_pending = false;
+            u2f_hid_if_tx_kick();
             break;
         }
         case APP_USBD_HID_USER_EVT_SET_BOOT_PROTO:
@@ -281,6 +518,24 @@ static void hid_user_ev_handler(app_usbd_class_inst_t const * p_inst,
     }
 }
 
+/**
+ * @brief USBD library ISR event handler.
+ *
+ * Called from the USBD interrupt every time an event is queued, so that the
+ * U2F HID frame layer gets scheduled to process it.
+ *
+ * @param p_event   USBD library internal event.
+ * @param queued    The event was put in the event queue.
+ * */
+static void usbd_isr_ev_handler(app_usbd_internal_evt_t const * const p_event,
+                                bool queued)
+{
+    if(queued)
+    {
+        u2f_hid_schedule();
+    }
+}
+
 /**
  * @brief USBD library specific event handler.
  *
@@ -296,12 +551,14 @@ static void usbd_user_ev_handler(app_usbd_event_type_t event)
             m_report_pending = false;
             break;
         case APP_USBD_EVT_DRV_SUSPEND:
+            m_stats.suspends++;
             m_report_pending = false;
             // Allow the library to put the peripheral into sleep mode
             app_usbd_suspend_req(); 
             bsp_board_leds_off();
             break;
         case APP_USBD_EVT_DRV_RESUME:
+            m_stats.resumes++;
             m_report_pending = false;
             bsp_board_led_on(LED_U2F_WINK);
             break;
@@ -364,6 +621,7 @@ uint32_t u2f_hid_if_init(void)
 	ret_code_t ret;
 
 	static const app_usbd_config_t usbd_config = {
+	    .ev_isr_handler = usbd_isr_ev_handler,
 	    .ev_state_proc = usbd_user_ev_handler
 	};
 
@@ -401,6 +659,8 @@ void u2f_hid_if_process(void)
     {
         /* Nothing to do */
     }
+
+    u2f_hid_if_tx_kick();
 }
 
 
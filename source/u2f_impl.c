@@ -39,15 +39,24 @@
 #include "fds.h"
 
 #include "nrf_crypto.h"
-#include "nrf_crypto_ecc.h"
-#include "nrf_crypto_ecdsa.h"
-#include "nrf_crypto_hash.h"
 #include "nrf_crypto_error.h"
 
 #include "u2f.h"
+#include "u2f_crypto.h"
+#include "u2f_key_handle.h"
+#include "u2f_stats.h"
+#include "u2f_trace.h"
+
+#include "sdk_config.h"
 
 #define NRF_LOG_MODULE_NAME u2f_impl
 
+#if U2F_IMPL_CONFIG_LOG_ENABLED
+#define NRF_LOG_LEVEL       U2F_IMPL_CONFIG_LOG_LEVEL
+#else
+#define NRF_LOG_LEVEL       0
+#endif
+
 #include "nrf_log.h"
 
 NRF_LOG_MODULE_REGISTER();
@@ -62,6 +71,10 @@ NRF_LOG_MODULE_REGISTER();
 
 #define AES_KEY_SIZE             16
 
+/* Dirty records that start a garbage collection from the main loop: half
+ * a page of counter updates. */
+#define CONFIG_FDS_GC_DIRTY_RECORDS (FDS_VIRTUAL_PAGE_SIZE / 8)
+
 
 extern uint8_t aes_key[];
 extern const uint8_t attestation_cert[];
@@ -78,6 +91,12 @@ uint32_t m_auth_counter = 0;
 /* Flag to check fds initialization. */
 static bool volatile m_fds_initialized;
 
+/* Dirty records in flash, counted from the FDS events, and a garbage
+ * collection asked for or running. */
+static uint32_t volatile m_fds_dirty_records;
+static bool volatile m_fds_gc_wanted;
+static bool volatile m_fds_gc_running;
+
 /* The record descriptor of counter */
 static fds_record_desc_t m_counter_record_desc;
 
@@ -102,6 +121,10 @@ static fds_record_t const m_aes_key_record =
     /* The length of a record is always expressed in 4-byte units (words). */
     .data.length_words = AES_KEY_SIZE / sizeof(uint32_t),
 };
+
+/* Set when the AES key record is written, to reload the key before its
+ * next use. */
+static bool volatile m_aes_key_changed;
 #endif /* CONFIG_RANDOM_AES_KEY_ENABLED */
 
 
@@ -120,6 +143,8 @@ static uint16_t signature_convert(uint8_t * p_dest_sig, uint8_t * p_src_sig);
 
 static void fds_evt_handler(fds_evt_t const * p_evt)
 {
+    U2F_TRACE(U2F_TRACE_EV_FDS, p_evt->id, p_evt->result);
+    u2f_stats_flash_event(p_evt);
 
     switch (p_evt->id)
     {
@@ -131,12 +156,27 @@ static void fds_evt_handler(fds_evt_t const * p_evt)
             break;
 
         case FDS_EVT_WRITE:
+        case FDS_EVT_UPDATE:
         {
             if (p_evt->result == FDS_SUCCESS)
             {
-                NRF_LOG_INFO("Record ID:\t0x%04x",  p_evt->write.record_id);
-                NRF_LOG_INFO("File ID:\t0x%04x",    p_evt->write.file_id);
-                NRF_LOG_INFO("Record key:\t0x%04x", p_evt->write.record_key);
+                if (p_evt->id == FDS_EVT_UPDATE)
+                {
+                    m_fds_dirty_records++;
+                }
+
+                NRF_LOG_DEBUG("Record 0x%04x written, file 0x%04x, key 0x%04x",
+                              p_evt->write.record_id,
+                              p_evt->write.file_id,
+                              p_evt->write.record_key);
+
+#ifdef CONFIG_RANDOM_AES_KEY_ENABLED
+                if (p_evt->write.file_id == CONFIG_AES_KEY_FILE &&
+                    p_evt->write.record_key == CONFIG_AES_KEY_REC_KEY)
+                {
+                    m_aes_key_changed = true;
+                }
+#endif
             }
         } break;
 
@@ -144,17 +184,76 @@ static void fds_evt_handler(fds_evt_t const * p_evt)
         {
             if (p_evt->result == FDS_SUCCESS)
             {
-                NRF_LOG_INFO("Record ID:\t0x%04x",  p_evt->del.record_id);
-                NRF_LOG_INFO("File ID:\t0x%04x",    p_evt->del.file_id);
-                NRF_LOG_INFO("Record key:\t0x%04x", p_evt->del.record_key);
+                m_fds_dirty_records++;
+
+                NRF_LOG_DEBUG("Record 0x%04x deleted, file 0x%04x, key 0x%04x",
+                              p_evt->del.record_id,
+                              p_evt->del.file_id,
+                              p_evt->del.record_key);
             }
         } break;
 
+        case FDS_EVT_GC:
+            if (p_evt->result == FDS_SUCCESS)
+            {
+                m_fds_dirty_records = 0;
+            }
+            m_fds_gc_running = false;
+            break;
+
         default:
             break;
     }
 }
 
+#ifdef CONFIG_RANDOM_AES_KEY_ENABLED
+/**@brief   Read the AES key record into aes_key. */
+static ret_code_t aes_key_read(void)
+{
+    ret_code_t ret;
+    fds_find_token_t   tok    = {0};
+    fds_record_desc_t  desc   = {0};
+    fds_flash_record_t config = {0};
+
+    ret = fds_record_find(CONFIG_AES_KEY_FILE, CONFIG_AES_KEY_REC_KEY,
+                          &desc, &tok);
+    if(ret != NRF_SUCCESS) return ret;
+
+    /* Open the record and read its contents. */
+    ret = fds_record_open(&desc, &config);
+    if(ret != NRF_SUCCESS) return ret;
+
+    memcpy(aes_key, config.p_data, AES_KEY_SIZE);
+
+    /* Close the record when done reading. */
+    return fds_record_close(&desc);
+}
+#endif /* CONFIG_RANDOM_AES_KEY_ENABLED */
+
+
+/**@brief   Reload the key handle wrapping contexts if the AES key record
+ *          changed since they were loaded. */
+static void aes_key_refresh(void)
+{
+#ifdef CONFIG_RANDOM_AES_KEY_ENABLED
+    ret_code_t ret;
+
+    if(!m_aes_key_changed) return;
+    m_aes_key_changed = false;
+
+    ret = aes_key_read();
+    if(ret == NRF_SUCCESS)
+    {
+        ret = u2f_crypto_wrap_key_set(aes_key);
+    }
+    if(ret != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("AES key reload failed! [code = %d]", ret);
+    }
+#endif /* CONFIG_RANDOM_AES_KEY_ENABLED */
+}
+
+
 /**@brief   Wait for fds to initialize. */
 static void wait_for_fds_ready(void)
 {
@@ -170,7 +269,7 @@ uint32_t u2f_impl_init(void)
     ret_code_t ret;
     fds_find_token_t  tok  = {0};
 
-    ret = nrf_crypto_init();
+    ret = u2f_crypto_init();
     if(ret != NRF_SUCCESS) return ret;
 
     /* Register first to receive an event when initialization is complete. */
@@ -181,6 +280,11 @@ uint32_t u2f_impl_init(void)
 
     wait_for_fds_ready();
 
+    fds_stat_t stat = {0};
+    ret = fds_stat(&stat);
+    if(ret != NRF_SUCCESS) return ret;
+    m_fds_dirty_records = stat.dirty_records;
+
     /* update m_auth_counter */
     ret = fds_record_find(CONFIG_COUNTER_FILE, CONFIG_COUNTER_REC_KEY, 
                           &m_counter_record_desc, &tok);
@@ -213,198 +317,171 @@ uint32_t u2f_impl_init(void)
 
 #ifdef CONFIG_RANDOM_AES_KEY_ENABLED
     /* update AES key */
-
-    fds_record_desc_t aes_key_record_desc = {0};
-
-    memset(&tok, 0, sizeof(fds_find_token_t));
-
-    ret = fds_record_find(CONFIG_AES_KEY_FILE, CONFIG_AES_KEY_REC_KEY, 
-                          &aes_key_record_desc, &tok);
-    if(ret == NRF_SUCCESS)
+    ret = aes_key_read();
+    if(ret == FDS_ERR_NOT_FOUND)
     {
-        fds_flash_record_t config = {0};
+        fds_record_desc_t aes_key_record_desc = {0};
 
-        /* Open the record and read its contents. */
-        ret = fds_record_open(&aes_key_record_desc, &config);
-        if(ret != NRF_SUCCESS) return ret;
-        
-        /* Copy the counter value from flash into aes_key. */
-        memcpy(aes_key, config.p_data, AES_KEY_SIZE);
-
-        /* Close the record when done reading. */
-        ret = fds_record_close(&aes_key_record_desc);
-        if(ret != NRF_SUCCESS) return ret;
-    }
-    else
-    {
         /* aes_key not found; generate a random one. */
         NRF_LOG_INFO("Generating a random AES key...");
 
-        ret = nrf_crypto_rng_vector_generate(aes_key, AES_KEY_SIZE);
+        ret = u2f_crypto_random(aes_key, AES_KEY_SIZE);
         if(ret != NRF_SUCCESS) return ret;
 
         ret = fds_record_write(&aes_key_record_desc, &m_aes_key_record);
-        if(ret != NRF_SUCCESS) return ret;
     }
+    if(ret != NRF_SUCCESS) return ret;
 #endif /* CONFIG_RANDOM_AES_KEY_ENABLED */
 
-    return ret;
+    /* Expand the key once; the requests reuse the contexts. */
+    return u2f_crypto_wrap_key_set(aes_key);
+}
+
+
+void u2f_impl_process(void)
+{
+    if (m_fds_gc_running) return;
+    if (!m_fds_gc_wanted && m_fds_dirty_records < CONFIG_FDS_GC_DIRTY_RECORDS)
+    {
+        return;
+    }
+
+    m_fds_gc_wanted = false;
+    m_fds_gc_running = true;
+    if (fds_gc() != FDS_SUCCESS)
+    {
+        m_fds_gc_running = false;
+    }
 }
 
 
 uint16_t u2f_register(U2F_REGISTER_REQ * p_req, U2F_REGISTER_RESP * p_resp, 
                       int flags, uint16_t * p_resp_len)
+{
+    return u2f_register_alg(p_req, p_resp, flags, U2F_CRYPTO_ALG_ES256,
+                            p_resp_len);
+}
+
+
+uint16_t u2f_register_alg(U2F_REGISTER_REQ * p_req, U2F_REGISTER_RESP * p_resp,
+                          int flags, int alg, uint16_t * p_resp_len)
 {
     NRF_LOG_INFO("u2f_register starting...");
     ret_code_t ret;
-    size_t len;
     uint8_t buf[64];
 
+    /* Only the HMAC handles tell the algorithm */
+    u2f_key_handle_scheme_t scheme = (alg == U2F_CRYPTO_ALG_ES256) ?
+                                     U2F_KEY_HANDLE_SCHEME : U2F_KEY_HANDLE_HMAC;
+
     memset(p_resp, 0, sizeof(*p_resp));
     *p_resp_len = 0;
     p_resp->registerId = U2F_REGISTER_ID;
 
-    if(!is_user_button_pressed())
+    if(alg < 0 || alg >= U2F_CRYPTO_ALG_COUNT)
     {
-        return U2F_SW_CONDITIONS_NOT_SATISFIED;
+        return U2F_SW_WRONG_DATA;
     }
 
-    bsp_board_led_on(LED_U2F_WINK);
-
-    /* Generate a key pair */
-    nrf_crypto_ecc_private_key_t privkey;
-    nrf_crypto_ecc_public_key_t pubkey;
-    
-    ret = nrf_crypto_ecc_key_pair_generate(NULL, 
-          &g_nrf_crypto_ecc_secp256r1_curve_info, &privkey, &pubkey);
-    if(ret != NRF_SUCCESS)
+    if(!is_user_button_pressed())
     {
-        NRF_LOG_ERROR("Fail to generate key pair! [code = %d]", ret);
-        return U2F_SW_INS_NOT_SUPPORTED;
+        return U2F_SW_CONDITIONS_NOT_SATISFIED;
     }
 
-    /* Export EC Public key */
-    len = U2F_EC_KEY_SIZE * 2;
-    ret = nrf_crypto_ecc_public_key_to_raw(&pubkey, buf, &len);
-    if(ret != NRF_SUCCESS)
-    {
-        NRF_LOG_ERROR("Fail to export EC Public key! [code = %d]", ret);
-        return U2F_SW_INS_NOT_SUPPORTED;
-    }
+    bsp_board_led_on(LED_U2F_WINK);
 
-    p_resp->pubKey.pointFormat = U2F_POINT_UNCOMPRESSED;
-    memcpy(&p_resp->pubKey.x[0], buf, U2F_EC_KEY_SIZE * 2);
+    U2F_PROFILE_START();
 
-    /* Export EC Private key to buf */
-    len = U2F_EC_KEY_SIZE;
-    ret = nrf_crypto_ecc_private_key_to_raw(&privkey, buf, &len);
+    /* Generate a key pair, the private key to buf. The HMAC scheme
+     * derives it from the nonce it writes to the key handle. An Ed25519
+     * public key fills x only. */
+    ret = u2f_key_handle_keygen(scheme, (u2f_crypto_alg_t)alg, p_req->appId,
+                                buf, &p_resp->pubKey.x[0],
+                                p_resp->keyHandleCertSig);
     if(ret != NRF_SUCCESS)
     {
-        NRF_LOG_ERROR("Fail to export EC Private key! [code = %d]", ret);
+        NRF_LOG_ERROR("Fail to generate key pair! [code = %d]", ret);
         return U2F_SW_INS_NOT_SUPPORTED;
     }
 
-    /* Copy appId to buf after private key */
-    memcpy(buf + U2F_EC_KEY_SIZE, p_req->appId, U2F_APPID_SIZE);
-
-    nrf_crypto_aes_context_t ecb_encr_128_ctx; // AES ECB encryption context
-
-    /* Init encryption context for 128 bit key */
-    ret = nrf_crypto_aes_init(&ecb_encr_128_ctx,
-                              &g_nrf_crypto_aes_ecb_128_info,
-                              NRF_CRYPTO_ENCRYPT);
+    U2F_PROFILE_MARK(U2F_PROFILE_REG_KEYGEN);
 
-    /* Convert EC private key to a key handle -> encrypt it and the appId 
-     * using an AES private key */
-    len = U2F_MAX_KH_SIZE;
-    ret += nrf_crypto_aes_crypt(&ecb_encr_128_ctx,
-                                &g_nrf_crypto_aes_ecb_128_info,
-                                NRF_CRYPTO_ENCRYPT,
-                                aes_key,
-                                NULL,
-                                buf,
-                                U2F_EC_KEY_SIZE + U2F_APPID_SIZE,
-                                p_resp->keyHandleCertSig,
-                                &len);
+    p_resp->pubKey.pointFormat = (alg == U2F_CRYPTO_ALG_ED25519) ?
+                                 U2F_POINT_ED25519 : U2F_POINT_UNCOMPRESSED;
 
-    p_resp->keyHandleLen = len;
-
-    ret += nrf_crypto_aes_uninit(&ecb_encr_128_ctx);
+    /* Complete the key handle: the private key and the appId encrypted
+     * with the AES key, or the tag of the nonce */
+    aes_key_refresh();
+    ret = u2f_key_handle_wrap(scheme, p_req->appId, buf,
+                              p_resp->keyHandleCertSig, &p_resp->keyHandleLen);
     if(ret != NRF_SUCCESS)
     {
-        NRF_LOG_ERROR("AES encryption failed! [code = %d]", ret);
+        NRF_LOG_ERROR("Key handle wrapping failed! [code = %d]", ret);
         return U2F_SW_INS_NOT_SUPPORTED;
     }
 
-    /* Copy x509 attestation public key certificate */
-    memcpy(&p_resp->keyHandleCertSig[p_resp->keyHandleLen], attestation_cert, 
-           attestation_cert_size);
-
-    /* Compute SHA256 hash of appId & chal & keyhandle & pubkey */
-
-    nrf_crypto_hash_context_t   hash_context;
+    U2F_PROFILE_MARK(U2F_PROFILE_REG_WRAP);
 
-    memset(buf, 0, sizeof(buf));
+    /* Compute SHA256 hash of appId & chal & keyhandle & pubkey. The data is
+     * laid out after the key handle, where the certificate goes next, so
+     * that it is hashed in one call. */
+    uint8_t * p_reg_data = &p_resp->keyHandleCertSig[p_resp->keyHandleLen];
+    u2f_crypto_chunk_t reg_data = { p_reg_data, 0 };
 
-    // Initialize the hash context
-    ret = nrf_crypto_hash_init(&hash_context, &g_nrf_crypto_hash_sha256_info);
-
-    /* hash update buf[0] = 0x00 */
-    ret += nrf_crypto_hash_update(&hash_context, buf, 1);
+    STATIC_ASSERT(1 + U2F_APPID_SIZE + U2F_CHAL_SIZE + U2F_MAX_KH_SIZE +
+                  U2F_EC_POINT_SIZE <= U2F_MAX_ATT_CERT_SIZE + U2F_MAX_EC_SIG_SIZE);
 
+    /* A byte reserved for future use [1 byte] with the value 0x00. */
+    p_reg_data[0] = 0x00;
+    reg_data.size += 1;
     /* The application parameter [32 bytes] from 
      * the registration request message. */
-    ret += nrf_crypto_hash_update(&hash_context, p_req->appId, U2F_APPID_SIZE);
-
+    memcpy(&p_reg_data[reg_data.size], p_req->appId, U2F_APPID_SIZE);
+    reg_data.size += U2F_APPID_SIZE;
     /* The challenge parameter [32 bytes] from 
      * the registration request message. */
-    ret += nrf_crypto_hash_update(&hash_context, p_req->chal, U2F_CHAL_SIZE);
-
+    memcpy(&p_reg_data[reg_data.size], p_req->chal, U2F_CHAL_SIZE);
+    reg_data.size += U2F_CHAL_SIZE;
     /* The key handle [variable length] */
-    ret += nrf_crypto_hash_update(&hash_context, p_resp->keyHandleCertSig, 
-                                  p_resp->keyHandleLen);
-
+    memcpy(&p_reg_data[reg_data.size], p_resp->keyHandleCertSig,
+           p_resp->keyHandleLen);
+    reg_data.size += p_resp->keyHandleLen;
     /* The user public key [65 bytes]. */
-    ret += nrf_crypto_hash_update(&hash_context, (uint8_t *)&p_resp->pubKey, 
-                                  U2F_EC_POINT_SIZE);
+    memcpy(&p_reg_data[reg_data.size], &p_resp->pubKey, U2F_EC_POINT_SIZE);
+    reg_data.size += U2F_EC_POINT_SIZE;
 
-    len = 32;
-    ret += nrf_crypto_hash_finalize(&hash_context, buf, &len);
+    ret = u2f_crypto_hash(&reg_data, 1, buf);
     if(ret != NRF_SUCCESS)
     {
         NRF_LOG_ERROR("Fail to calculate hash! [code = %d]", ret);
         return U2F_SW_INS_NOT_SUPPORTED;
     }
 
-    nrf_crypto_ecc_private_key_t sign_private_key;
+    U2F_PROFILE_MARK(U2F_PROFILE_REG_HASH);
+
+    /* Copy x509 attestation public key certificate */
+    memcpy(&p_resp->keyHandleCertSig[p_resp->keyHandleLen], attestation_cert, 
+           attestation_cert_size);
+
     /* Sign the SHA256 hash using the attestation key */
-    ret = nrf_crypto_ecc_private_key_from_raw(
-                                        &g_nrf_crypto_ecc_secp256r1_curve_info,
-                                        &sign_private_key,
-                                        attestation_private_key,
-                                        attestation_private_key_size);
-
-    nrf_crypto_ecdsa_secp256r1_signature_t m_signature;
-    size_t m_signature_size = sizeof(m_signature);
-
-    ret += nrf_crypto_ecdsa_sign(NULL,
-                                 &sign_private_key,
-                                 buf,
-                                 len,
-                                 m_signature,
-                                 &m_signature_size);
-    // Key deallocation
-    ret += nrf_crypto_ecc_private_key_free(&sign_private_key);
+    uint8_t m_signature[U2F_CRYPTO_SIGNATURE_SIZE];
+    uint16_t m_signature_size;
+
+    ret = u2f_crypto_sign(attestation_private_key, buf, m_signature);
     if(ret != NRF_SUCCESS)
     {
         NRF_LOG_ERROR("Fail to generate signature! [code = %d]", ret);
         return U2F_SW_INS_NOT_SUPPORTED;
     }
 
+    U2F_PROFILE_MARK(U2F_PROFILE_REG_SIGN);
+
     m_signature_size = signature_convert(
         &p_resp->keyHandleCertSig[p_resp->keyHandleLen + attestation_cert_size], 
         m_signature);
 
+    U2F_PROFILE_MARK(U2F_PROFILE_REG_DER);
+
     *p_resp_len = p_resp->keyHandleCertSig - (uint8_t *)p_resp 
                   + p_resp->keyHandleLen + attestation_cert_size 
                   + m_signature_size;
@@ -421,8 +498,8 @@ uint16_t u2f_authenticate(U2F_AUTHENTICATE_REQ * p_req,
     NRF_LOG_INFO("u2f_authenticate starting...");
 
     ret_code_t ret;
-    size_t len;
-    uint8_t buf[U2F_EC_KEY_SIZE + U2F_APPID_SIZE];
+    uint8_t buf[U2F_EC_KEY_SIZE];
+    u2f_crypto_alg_t alg;
 
     *p_resp_len = 0;
 
@@ -433,105 +510,114 @@ uint16_t u2f_authenticate(U2F_AUTHENTICATE_REQ * p_req,
 
     bsp_board_led_on(LED_U2F_WINK);
 
-    /* Convert key handle to EC private key -> 
-     * decrypt it using AES private key */
-    nrf_crypto_aes_context_t ecb_decr_128_ctx; // AES ECB decryption context
-
-    /* Init decryption context for 128 bit key */
-    ret = nrf_crypto_aes_init(&ecb_decr_128_ctx,
-                              &g_nrf_crypto_aes_ecb_128_info,
-                              NRF_CRYPTO_DECRYPT);
-
-    len = sizeof(buf);
-    ret += nrf_crypto_aes_crypt(&ecb_decr_128_ctx,
-                                &g_nrf_crypto_aes_ecb_128_info,
-                                NRF_CRYPTO_DECRYPT,
-                                aes_key,
-                                NULL,
-                                p_req->keyHandle,
-                                p_req->keyHandleLen,
-                                buf,
-                                &len);
-    ret += nrf_crypto_aes_uninit(&ecb_decr_128_ctx);
-    if(ret != NRF_SUCCESS)
-    {
-        NRF_LOG_ERROR("AES decryption failed! [code = %d]", ret);
-        return U2F_SW_INS_NOT_SUPPORTED;        
-    }
+    U2F_PROFILE_START();
 
-    if(memcmp(&buf[U2F_EC_KEY_SIZE], p_req->appId, U2F_APPID_SIZE) != 0)
+    /* Convert key handle to EC private key -> decrypt it using AES
+     * private key, or derive it from the nonce and check the tag */
+    aes_key_refresh();
+    ret = u2f_key_handle_open(p_req->appId, p_req->keyHandle,
+                              p_req->keyHandleLen, buf, &alg);
+    if(ret == NRF_ERROR_INVALID_DATA)
     {
-        NRF_LOG_ERROR("APPID MISMATCH!");
+        NRF_LOG_ERROR("KEY HANDLE OR APPID MISMATCH!");
         return U2F_SW_WRONG_DATA;
     }
+    if(ret != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("Key handle unwrapping failed! [code = %d]", ret);
+        return U2F_SW_INS_NOT_SUPPORTED;
+    }
+
+    U2F_PROFILE_MARK(U2F_PROFILE_AUTH_UNWRAP);
 
     uint32_big_encode(m_auth_counter, p_resp->ctr);
     m_auth_counter++;
     /* Write the updated record to flash. */
     ret = fds_record_update(&m_counter_record_desc, &m_counter_record);
-    APP_ERROR_CHECK(ret);
-
-    p_resp->flags = U2F_AUTH_FLAG_TUP;
-
-    /* Get private key */
-    nrf_crypto_ecc_private_key_t private_key;
-    ret = nrf_crypto_ecc_private_key_from_raw(
-                                        &g_nrf_crypto_ecc_secp256r1_curve_info,
-                                        &private_key,
-                                        buf,
-                                        U2F_EC_KEY_SIZE);
     if(ret != NRF_SUCCESS)
     {
-        NRF_LOG_ERROR("Fail to get private key from raw! [code = %d]", ret);
-        return U2F_SW_INS_NOT_SUPPORTED;
+        /* The counter must not be used without being saved. The main loop
+         * reclaims the old counters, the client can retry then. */
+        NRF_LOG_ERROR("Counter update failed! [code = %d]", ret);
+        if(ret == FDS_ERR_NO_SPACE_IN_FLASH)
+        {
+            m_fds_gc_wanted = true;
+        }
+        return VENDOR_U2F_NOMEM;
     }
 
-    /* Compute SHA256 hash of appId & user presence & counter & chal */
-    nrf_crypto_hash_context_t   hash_context;
+    U2F_PROFILE_MARK(U2F_PROFILE_AUTH_COUNTER);
 
-    // Initialize the hash context
-    ret = nrf_crypto_hash_init(&hash_context, &g_nrf_crypto_hash_sha256_info);
-    
-    /* hash update appId */
-    ret += nrf_crypto_hash_update(&hash_context, p_req->appId, U2F_APPID_SIZE);
+    p_resp->flags = U2F_AUTH_FLAG_TUP;
 
-    /* hash update user presence */
-    ret += nrf_crypto_hash_update(&hash_context, &p_resp->flags, 1);
+    /* Compute SHA256 hash of appId & user presence & counter & chal. The
+     * data is laid out where the signature goes next, so that it is hashed
+     * in one call. */
+    uint8_t hash[U2F_CRYPTO_HASH_SIZE];
+    uint8_t * p_auth_data = p_resp->sig;
+    u2f_crypto_chunk_t auth_data = { p_auth_data, 0 };
+
+    STATIC_ASSERT(U2F_APPID_SIZE + 1 + U2F_CTR_SIZE + U2F_CHAL_SIZE <=
+                  U2F_MAX_EC_SIG_SIZE);
+
+    memcpy(&p_auth_data[auth_data.size], p_req->appId, U2F_APPID_SIZE);
+    auth_data.size += U2F_APPID_SIZE;
+    p_auth_data[auth_data.size] = p_resp->flags;
+    auth_data.size += 1;
+    memcpy(&p_auth_data[auth_data.size], p_resp->ctr, U2F_CTR_SIZE);
+    auth_data.size += U2F_CTR_SIZE;
+    memcpy(&p_auth_data[auth_data.size], p_req->chal, U2F_CHAL_SIZE);
+    auth_data.size += U2F_CHAL_SIZE;
+
+    /* Ed25519 signs the data itself */
+    if(alg == U2F_CRYPTO_ALG_ES256)
+    {
+        ret = u2f_crypto_hash(&auth_data, 1, hash);
+        if(ret != NRF_SUCCESS)
+        {
+            NRF_LOG_ERROR("Fail to calculate hash! [code = %d]", ret);
+            return U2F_SW_INS_NOT_SUPPORTED;
+        }
+    }
 
-    /* hash update counter */
-    ret += nrf_crypto_hash_update(&hash_context, p_resp->ctr, U2F_CTR_SIZE);
+    U2F_PROFILE_MARK(U2F_PROFILE_AUTH_HASH);
 
-    /* hash update chal */
-    ret += nrf_crypto_hash_update(&hash_context, p_req->chal, U2F_CHAL_SIZE);
+    /* Sign the SHA256 hash, or the data with Ed25519, using the private
+     * key */
+    uint8_t m_signature[U2F_CRYPTO_SIGNATURE_SIZE];
+    uint16_t m_signature_size;
 
-    len = 32;
-    ret += nrf_crypto_hash_finalize(&hash_context, buf, &len);
+    STATIC_ASSERT(U2F_CRYPTO_ED25519_SIGNATURE_SIZE <= sizeof(m_signature));
+
+    if(alg == U2F_CRYPTO_ALG_ES256)
+    {
+        ret = u2f_crypto_sign(buf, hash, m_signature);
+    }
+    else
+    {
+        ret = u2f_crypto_alg_sign(alg, buf, p_auth_data, auth_data.size,
+                                  m_signature);
+    }
     if(ret != NRF_SUCCESS)
     {
-        NRF_LOG_ERROR("Fail to calculate hash! [code = %d]", ret);
+        NRF_LOG_ERROR("Fail to generate signature! [code = %d]", ret);
         return U2F_SW_INS_NOT_SUPPORTED;
     }
 
-    /* Sign the SHA256 hash using the private key */
-    nrf_crypto_ecdsa_secp256r1_signature_t m_signature;
-    size_t m_signature_size = sizeof(m_signature);
-
-    ret = nrf_crypto_ecdsa_sign(NULL,
-                                &private_key,
-                                buf,
-                                len,
-                                m_signature,
-                                &m_signature_size);
+    U2F_PROFILE_MARK(U2F_PROFILE_AUTH_SIGN);
 
-    // Key deallocation
-    ret += nrf_crypto_ecc_private_key_free(&private_key);
-    if(ret != NRF_SUCCESS)
+    /* An Ed25519 signature is R | S as is, there is no DER form */
+    if(alg == U2F_CRYPTO_ALG_ES256)
     {
-        NRF_LOG_ERROR("Fail to generate signature! [code = %d]", ret);
-        return U2F_SW_INS_NOT_SUPPORTED;
+        m_signature_size = signature_convert(p_resp->sig, m_signature);
+    }
+    else
+    {
+        memcpy(p_resp->sig, m_signature, U2F_CRYPTO_ED25519_SIGNATURE_SIZE);
+        m_signature_size = U2F_CRYPTO_ED25519_SIGNATURE_SIZE;
     }
 
-    m_signature_size = signature_convert(p_resp->sig, m_signature);
+    U2F_PROFILE_MARK(U2F_PROFILE_AUTH_DER);
 
     *p_resp_len = p_resp->sig - (uint8_t *)p_resp + m_signature_size;
 
@@ -0,0 +1,298 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "app_util.h"
+#include "nrf_crypto_error.h"
+
+#include "u2f.h"
+#include "u2f_crypto.h"
+#include "u2f_key_handle.h"
+
+#include "sdk_config.h"
+
+/*
+ * An HMAC key handle is
+ *
+ *   version (1) | nonce (32) | HMAC-SHA256(mk, k | appId) (32)
+ *
+ * with k = HMAC-SHA256(mk, version | nonce | appId), the private key, and
+ * mk the MAC sub-key of the device key, see u2f_crypto_wrap_key_set(). The
+ * two messages differ in length, 65 and 64 bytes, so a tag is never a
+ * private key. Opening one is two HMACs, where the AES handles need a
+ * decryption. A derived k out of [1, n - 1], once in 2^32, is retried
+ * with another nonce on registration. k is an Ed25519 seed as well; as the
+ * version is in the HMAC, the same nonce gives unrelated keys to the two
+ * algorithms.
+ */
+
+/** Nonces drawn before giving up on a registration. */
+#define HMAC_KEYGEN_ATTEMPTS    4
+
+#define HMAC_NONCE_OFFSET       1
+#define HMAC_TAG_OFFSET         (HMAC_NONCE_OFFSET + U2F_KEY_HANDLE_NONCE_SIZE)
+
+
+/**
+ * @brief Compare in a time that does not depend on the data.
+ */
+static bool equal(uint8_t const * p_a, uint8_t const * p_b, size_t size)
+{
+    uint8_t diff = 0;
+
+    for(size_t i = 0; i < size; i++)
+    {
+        diff |= p_a[i] ^ p_b[i];
+    }
+
+    return diff == 0;
+}
+
+
+/**
+ * @brief Derive the private key of the version and the nonce of @p p_handle.
+ */
+static ret_code_t hmac_derive(uint8_t const * p_app_id,
+                              uint8_t const * p_handle,
+                              uint8_t * p_private_key)
+{
+    u2f_crypto_chunk_t const chunks[] =
+    {
+        { p_handle, HMAC_TAG_OFFSET },
+        { p_app_id, U2F_APPID_SIZE },
+    };
+
+    return u2f_crypto_mac(chunks, ARRAY_SIZE(chunks), p_private_key);
+}
+
+
+static ret_code_t hmac_tag(uint8_t const * p_app_id,
+                           uint8_t const * p_private_key,
+                           uint8_t * p_tag)
+{
+    u2f_crypto_chunk_t const chunks[] =
+    {
+        { p_private_key, U2F_CRYPTO_PRIVATE_KEY_SIZE },
+        { p_app_id, U2F_APPID_SIZE },
+    };
+
+    return u2f_crypto_mac(chunks, ARRAY_SIZE(chunks), p_tag);
+}
+
+
+static ret_code_t hmac_keygen(u2f_crypto_alg_t alg,
+                              uint8_t const * p_app_id,
+                              uint8_t * p_private_key,
+                              uint8_t * p_public_key,
+                              uint8_t * p_handle)
+{
+    ret_code_t ret = NRF_ERROR_CRYPTO_ECC_INVALID_KEY;
+
+    p_handle[0] = (alg == U2F_CRYPTO_ALG_ED25519) ?
+                  U2F_KEY_HANDLE_VERSION_ED25519 : U2F_KEY_HANDLE_VERSION_HMAC;
+
+    for(uint32_t i = 0; i < HMAC_KEYGEN_ATTEMPTS &&
+                        ret == NRF_ERROR_CRYPTO_ECC_INVALID_KEY; i++)
+    {
+        ret = u2f_crypto_random(&p_handle[HMAC_NONCE_OFFSET],
+                                U2F_KEY_HANDLE_NONCE_SIZE);
+        if(ret != NRF_SUCCESS) break;
+
+        ret = hmac_derive(p_app_id, p_handle, p_private_key);
+        if(ret != NRF_SUCCESS) break;
+
+        ret = u2f_crypto_alg_public_key(alg, p_private_key, p_public_key);
+    }
+
+    if(ret != NRF_SUCCESS)
+    {
+        memset(p_private_key, 0, U2F_CRYPTO_PRIVATE_KEY_SIZE);
+    }
+
+    return ret;
+}
+
+
+static ret_code_t hmac_open(uint8_t const * p_app_id,
+                            uint8_t const * p_handle,
+                            uint8_t * p_private_key,
+                            u2f_crypto_alg_t * p_alg)
+{
+    uint8_t tag[U2F_CRYPTO_MAC_SIZE];
+    ret_code_t ret;
+
+    switch(p_handle[0])
+    {
+        case U2F_KEY_HANDLE_VERSION_HMAC:
+            *p_alg = U2F_CRYPTO_ALG_ES256;
+            break;
+
+        case U2F_KEY_HANDLE_VERSION_ED25519:
+            *p_alg = U2F_CRYPTO_ALG_ED25519;
+            break;
+
+        default:
+            return NRF_ERROR_INVALID_DATA;
+    }
+
+    ret = hmac_derive(p_app_id, p_handle, p_private_key);
+    if(ret == NRF_SUCCESS)
+    {
+        ret = hmac_tag(p_app_id, p_private_key, tag);
+    }
+    if(ret == NRF_SUCCESS &&
+       !equal(tag, &p_handle[HMAC_TAG_OFFSET], sizeof(tag)))
+    {
+        ret = NRF_ERROR_INVALID_DATA;
+    }
+
+    if(ret != NRF_SUCCESS)
+    {
+        memset(p_private_key, 0, U2F_CRYPTO_PRIVATE_KEY_SIZE);
+    }
+
+    return ret;
+}
+
+
+static ret_code_t aes_wrap(uint8_t const * p_app_id,
+                           uint8_t const * p_private_key,
+                           uint8_t * p_handle)
+{
+    uint8_t buf[U2F_KEY_HANDLE_AES_SIZE];
+    ret_code_t ret;
+
+    memcpy(buf, p_private_key, U2F_EC_KEY_SIZE);
+    memcpy(&buf[U2F_EC_KEY_SIZE], p_app_id, U2F_APPID_SIZE);
+
+    ret = u2f_crypto_wrap(buf, p_handle, sizeof(buf));
+
+    memset(buf, 0, sizeof(buf));
+
+    return ret;
+}
+
+
+static ret_code_t aes_open(uint8_t const * p_app_id,
+                           uint8_t const * p_handle,
+                           uint8_t * p_private_key)
+{
+    uint8_t buf[U2F_KEY_HANDLE_AES_SIZE];
+    ret_code_t ret;
+
+    ret = u2f_crypto_unwrap(p_handle, buf, sizeof(buf));
+    if(ret == NRF_SUCCESS &&
+       !equal(&buf[U2F_EC_KEY_SIZE], p_app_id, U2F_APPID_SIZE))
+    {
+        ret = NRF_ERROR_INVALID_DATA;
+    }
+    if(ret == NRF_SUCCESS)
+    {
+        memcpy(p_private_key, buf, U2F_EC_KEY_SIZE);
+    }
+
+    memset(buf, 0, sizeof(buf));
+
+    return ret;
+}
+
+
+ret_code_t u2f_key_handle_keygen(u2f_key_handle_scheme_t scheme,
+                                 u2f_crypto_alg_t alg,
+                                 uint8_t const * p_app_id,
+                                 uint8_t * p_private_key,
+                                 uint8_t * p_public_key,
+                                 uint8_t * p_handle)
+{
+    if(alg >= U2F_CRYPTO_ALG_COUNT) return NRF_ERROR_INVALID_PARAM;
+
+    switch(scheme)
+    {
+        case U2F_KEY_HANDLE_AES:
+            if(alg != U2F_CRYPTO_ALG_ES256) return NRF_ERROR_INVALID_PARAM;
+            return u2f_crypto_keygen(p_private_key, p_public_key);
+
+        case U2F_KEY_HANDLE_HMAC:
+            return hmac_keygen(alg, p_app_id, p_private_key, p_public_key,
+                               p_handle);
+
+        default:
+            return NRF_ERROR_INVALID_PARAM;
+    }
+}
+
+
+ret_code_t u2f_key_handle_wrap(u2f_key_handle_scheme_t scheme,
+                               uint8_t const * p_app_id,
+                               uint8_t const * p_private_key,
+                               uint8_t * p_handle,
+                               uint8_t * p_size)
+{
+    switch(scheme)
+    {
+        case U2F_KEY_HANDLE_AES:
+            *p_size = U2F_KEY_HANDLE_AES_SIZE;
+            return aes_wrap(p_app_id, p_private_key, p_handle);
+
+        case U2F_KEY_HANDLE_HMAC:
+            *p_size = U2F_KEY_HANDLE_HMAC_SIZE;
+            return hmac_tag(p_app_id, p_private_key, &p_handle[HMAC_TAG_OFFSET]);
+
+        default:
+            return NRF_ERROR_INVALID_PARAM;
+    }
+}
+
+
+ret_code_t u2f_key_handle_open(uint8_t const * p_app_id,
+                               uint8_t const * p_handle,
+                               size_t size,
+                               uint8_t * p_private_key,
+                               u2f_crypto_alg_t * p_alg)
+{
+    STATIC_ASSERT(U2F_KEY_HANDLE_HMAC_SIZE <= U2F_MAX_KH_SIZE);
+
+    switch(size)
+    {
+        case U2F_KEY_HANDLE_AES_SIZE:
+            *p_alg = U2F_CRYPTO_ALG_ES256;
+            return aes_open(p_app_id, p_handle, p_private_key);
+
+        case U2F_KEY_HANDLE_HMAC_SIZE:
+            return hmac_open(p_app_id, p_handle, p_private_key, p_alg);
+
+        default:
+            return NRF_ERROR_INVALID_DATA;
+    }
+}
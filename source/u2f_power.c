@@ -0,0 +1,238 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "app_timer.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+#include "cc310_backend_mutex.h"
+#include "cc310_backend_shared.h"
+#include "nrf_mtx.h"
+
+#include "timer_interface.h"
+#include "u2f_crypto.h"
+#include "u2f_power.h"
+#include "u2f_worker.h"
+
+#include "sdk_config.h"
+
+#if NRF_MODULE_ENABLED(U2F_POWER)
+
+/*
+ * nrf_crypto enables the CryptoCell around each of its operations, and
+ * cc310_backend_enable() counts the users, so a reference taken here keeps
+ * it on between them. The reference is taken on the first frame of a
+ * request and dropped from a timer once the key has been idle.
+ *
+ * The count is not atomic, and the worker may be in an operation of the
+ * CC310 backend when a frame or the timer preempts it. The reference is
+ * therefore only taken or dropped under the mutex of the backend; if the
+ * worker holds it, the CryptoCell is on for its operation anyway, and the
+ * timer tries again POWER_RETRY_MS later.
+ */
+
+#define POWER_RETRY_MS      1
+
+
+APP_TIMER_DEF(m_idle_timer);
+
+static uint32_t volatile m_idle_ms = U2F_POWER_CC310_IDLE_MS;
+
+/** The reference should be held. */
+static bool volatile m_wanted;
+
+/** The reference is held. */
+static bool volatile m_on;
+
+/** Time of the last frame, or of the last check that found a job. */
+static uint64_t volatile m_last_ms;
+
+static uint64_t m_on_since_ms;
+
+static u2f_power_stats_t m_stats;
+
+
+/**
+ * @brief Tell whether an operation is routed to CC310.
+ */
+static bool cc310_used(void)
+{
+    for(uint32_t op = 0; op < U2F_CRYPTO_OP_COUNT; op++)
+    {
+        if(u2f_crypto_backend_get((u2f_crypto_op_t)op) == U2F_CRYPTO_BACKEND_CC310)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+static void idle_timer_start(uint32_t ms)
+{
+    UNUSED_RETURN_VALUE(app_timer_stop(m_idle_timer));
+    UNUSED_RETURN_VALUE(app_timer_start(m_idle_timer,
+                                        APP_TIMER_TICKS(MAX(ms, 1)), NULL));
+}
+
+
+/**
+ * @brief Take or drop the reference as wanted, under the CC310 mutex.
+ *
+ * @retval false The mutex is held, nothing was done.
+ */
+static bool reference_apply(void)
+{
+    uint64_t now;
+
+    if(!nrf_mtx_trylock(&g_cc310_mutex))
+    {
+        return false;
+    }
+
+    now = current_time_ms();
+    if(m_wanted && !m_on)
+    {
+        cc310_backend_enable();
+        m_on = true;
+        m_on_since_ms = now;
+        m_stats.warmups++;
+    }
+    else if(!m_wanted && m_on)
+    {
+        cc310_backend_disable();
+        m_on = false;
+        m_stats.powerdowns++;
+        m_stats.on_ms += (uint32_t)(now - m_on_since_ms);
+    }
+
+    nrf_mtx_unlock(&g_cc310_mutex);
+
+    return true;
+}
+
+
+static void idle_timeout_handler(void * p_context)
+{
+    uint64_t now = current_time_ms();
+    uint32_t left = 0;
+
+    UNUSED_PARAMETER(p_context);
+
+    CRITICAL_REGION_ENTER();
+    if(u2f_worker_is_busy())
+    {
+        m_last_ms = now;
+    }
+    if(now - m_last_ms >= m_idle_ms)
+    {
+        m_wanted = false;
+    }
+    else
+    {
+        left = m_idle_ms - (uint32_t)(now - m_last_ms);
+    }
+    CRITICAL_REGION_EXIT();
+
+    if(!reference_apply())
+    {
+        idle_timer_start(POWER_RETRY_MS);
+    }
+    else if(m_wanted)
+    {
+        idle_timer_start(left);
+    }
+}
+
+
+ret_code_t u2f_power_init(void)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_wanted = false;
+    m_on = false;
+
+    return app_timer_create(&m_idle_timer, APP_TIMER_MODE_SINGLE_SHOT,
+                            idle_timeout_handler);
+}
+
+
+void u2f_power_warm(void)
+{
+    bool on = false;
+
+    if(!cc310_used()) return;
+
+    CRITICAL_REGION_ENTER();
+    m_last_ms = current_time_ms();
+    if(m_wanted)
+    {
+        m_stats.hits++;
+    }
+    else
+    {
+        m_wanted = true;
+        on = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if(on)
+    {
+        idle_timer_start(reference_apply() ? m_idle_ms : POWER_RETRY_MS);
+    }
+}
+
+
+void u2f_power_idle_set(uint32_t idle_ms)
+{
+    m_idle_ms = idle_ms;
+}
+
+
+void u2f_power_stats_get(u2f_power_stats_t * p_stats)
+{
+    uint64_t now = current_time_ms();
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats;
+    if(m_on)
+    {
+        p_stats->on_ms += (uint32_t)(now - m_on_since_ms);
+    }
+    CRITICAL_REGION_EXIT();
+
+    p_stats->idle_ms = m_idle_ms;
+    p_stats->on = m_on;
+}
+
+#endif // NRF_MODULE_ENABLED(U2F_POWER)
@@ -0,0 +1,501 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "nrf.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+#include "nrf_cli.h"
+
+#include "u2f.h"
+#include "u2f_hid.h"
+#include "u2f_hid_if.h"
+#include "u2f_stats.h"
+#include "u2f_trace.h"
+#include "u2f_worker.h"
+
+
+/**
+ * @brief Latency histograms.
+ */
+static u2f_stats_hist_data_t m_hist[U2F_STATS_HIST_COUNT];
+
+
+/**
+ * @brief Histogram names, printed by the CLI.
+ */
+static char const * const m_hist_names[U2F_STATS_HIST_COUNT] =
+{
+    [U2F_STATS_HIST_PING]         = "PING",
+    [U2F_STATS_HIST_MSG]          = "MSG",
+    [U2F_STATS_HIST_LOCK]         = "LOCK",
+    [U2F_STATS_HIST_INIT]         = "INIT",
+    [U2F_STATS_HIST_WINK]         = "WINK",
+    [U2F_STATS_HIST_SYNC]         = "SYNC",
+    [U2F_STATS_HIST_VENDOR]       = "VENDOR",
+    [U2F_STATS_HIST_REGISTER]     = "REGISTER",
+    [U2F_STATS_HIST_AUTHENTICATE] = "AUTHENTICATE",
+    [U2F_STATS_HIST_VERSION]      = "VERSION",
+    [U2F_STATS_HIST_INS_OTHER]    = "INS_OTHER",
+};
+
+
+/**
+ * @brief Stack bounds, from the linker script.
+ */
+extern uint32_t __StackLimit;
+extern uint32_t __StackTop;
+
+
+/**
+ * @brief Pattern of the unused stack.
+ */
+#define STACK_PAINT_PATTERN     0xDEADBEEF
+
+
+/**
+ * @brief Stack left unpainted below the current stack pointer, in words.
+ */
+#define STACK_PAINT_MARGIN      16
+
+
+/**
+ * @brief High-water marks.
+ */
+static uint32_t m_hwm[U2F_STATS_HWM_COUNT];
+
+
+/**
+ * @brief Flash operation counters.
+ */
+static u2f_stats_flash_t m_flash;
+
+/**
+ * @brief An FDS event came since the flash usage was taken.
+ */
+static bool volatile m_flash_stale = true;
+
+
+/**
+ * @brief Phase profile.
+ */
+static u2f_profile_data_t m_profile[U2F_PROFILE_COUNT];
+
+
+/**
+ * @brief Phase names, printed by the CLI.
+ */
+static char const * const m_profile_names[U2F_PROFILE_COUNT] =
+{
+    [U2F_PROFILE_REG_KEYGEN]   = "reg keygen",
+    [U2F_PROFILE_REG_WRAP]     = "reg wrap",
+    [U2F_PROFILE_REG_HASH]     = "reg hash",
+    [U2F_PROFILE_REG_SIGN]     = "reg sign",
+    [U2F_PROFILE_REG_DER]      = "reg der",
+    [U2F_PROFILE_AUTH_UNWRAP]  = "auth unwrap",
+    [U2F_PROFILE_AUTH_COUNTER] = "auth counter",
+    [U2F_PROFILE_AUTH_HASH]    = "auth hash",
+    [U2F_PROFILE_AUTH_SIGN]    = "auth sign",
+    [U2F_PROFILE_AUTH_DER]     = "auth der",
+};
+
+
+/**
+ * @brief Add a sample to a histogram.
+ */
+static void u2f_stats_hist_add(u2f_stats_hist_t hist, uint32_t start)
+{
+    uint32_t cycles = u2f_stats_cycles_get() - start;
+    uint32_t bucket = (cycles > 1) ? (31 - __CLZ(cycles)) : 0;
+    u2f_stats_hist_data_t * p_hist = &m_hist[hist];
+
+    bucket = MIN(bucket, U2F_STATS_HIST_BUCKETS - 1);
+
+    p_hist->count++;
+    p_hist->total += cycles;
+    p_hist->buckets[bucket]++;
+    if(cycles > p_hist->max)
+    {
+        p_hist->max = cycles;
+    }
+}
+
+
+void u2f_stats_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Interrupts share the main stack, keep them out while painting
+    CRITICAL_REGION_ENTER();
+    uint32_t * p_word = &__StackLimit;
+    uint32_t * p_end = (uint32_t *)(uintptr_t)__get_MSP() - STACK_PAINT_MARGIN;
+
+    while(p_word < p_end)
+    {
+        *p_word++ = STACK_PAINT_PATTERN;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+void u2f_stats_hwm_update(u2f_stats_hwm_t hwm, uint32_t value)
+{
+    CRITICAL_REGION_ENTER();
+    m_hwm[hwm] = MAX(m_hwm[hwm], value);
+    CRITICAL_REGION_EXIT();
+}
+
+
+uint32_t u2f_stats_hwm_get(u2f_stats_hwm_t hwm)
+{
+    return m_hwm[hwm];
+}
+
+
+uint32_t u2f_stats_stack_size_get(void)
+{
+    return (uint32_t)((uint8_t *)&__StackTop - (uint8_t *)&__StackLimit);
+}
+
+
+uint32_t u2f_stats_stack_used_max_get(void)
+{
+    uint32_t const * p_word = &__StackLimit;
+
+    while(p_word < &__StackTop && *p_word == STACK_PAINT_PATTERN)
+    {
+        p_word++;
+    }
+
+    return (uint32_t)((uint8_t *)&__StackTop - (uint8_t const *)p_word);
+}
+
+
+void u2f_stats_flash_event(fds_evt_t const * p_evt)
+{
+    if(p_evt->result != FDS_SUCCESS)
+    {
+        m_flash.failures++;
+    }
+    else
+    {
+        switch(p_evt->id)
+        {
+            case FDS_EVT_WRITE:      m_flash.writes++;  break;
+            case FDS_EVT_UPDATE:     m_flash.updates++; break;
+            case FDS_EVT_DEL_RECORD:
+            case FDS_EVT_DEL_FILE:   m_flash.deletes++; break;
+            case FDS_EVT_GC:         m_flash.gc_runs++; break;
+            default:                                    break;
+        }
+    }
+
+    m_flash_stale = true;
+}
+
+
+void u2f_stats_process(void)
+{
+    fds_stat_t usage = {0};
+
+    if(!m_flash_stale) return;
+    m_flash_stale = false;
+
+    // fds_stat() scans the pages, which a job could be writing meanwhile
+    u2f_worker_suspend();
+    UNUSED_RETURN_VALUE(fds_stat(&usage));
+    u2f_worker_resume();
+
+    CRITICAL_REGION_ENTER();
+    m_flash.usage = usage;
+    CRITICAL_REGION_EXIT();
+}
+
+
+void u2f_stats_flash_get(u2f_stats_flash_t * p_flash)
+{
+    CRITICAL_REGION_ENTER();
+    *p_flash = m_flash;
+    CRITICAL_REGION_EXIT();
+}
+
+
+void u2f_stats_cmd_record(uint8_t cmd, uint32_t start)
+{
+    u2f_stats_hist_t hist;
+
+    switch(cmd)
+    {
+        case U2FHID_PING: hist = U2F_STATS_HIST_PING; break;
+        case U2FHID_MSG:  hist = U2F_STATS_HIST_MSG;  break;
+        case U2FHID_LOCK: hist = U2F_STATS_HIST_LOCK; break;
+        case U2FHID_INIT: hist = U2F_STATS_HIST_INIT; break;
+        case U2FHID_WINK: hist = U2F_STATS_HIST_WINK; break;
+        case U2FHID_SYNC: hist = U2F_STATS_HIST_SYNC; break;
+        default:          hist = U2F_STATS_HIST_VENDOR; break;
+    }
+
+    u2f_stats_hist_add(hist, start);
+}
+
+
+void u2f_stats_ins_record(uint8_t ins, uint32_t start)
+{
+    u2f_stats_hist_t hist;
+
+    switch(ins)
+    {
+        case U2F_REGISTER:     hist = U2F_STATS_HIST_REGISTER;     break;
+        case U2F_AUTHENTICATE: hist = U2F_STATS_HIST_AUTHENTICATE; break;
+        case U2F_VERSION:      hist = U2F_STATS_HIST_VERSION;      break;
+        default:               hist = U2F_STATS_HIST_INS_OTHER;    break;
+    }
+
+    u2f_stats_hist_add(hist, start);
+}
+
+
+uint32_t u2f_stats_profile_record(u2f_profile_phase_t phase, uint32_t start)
+{
+    uint32_t now = u2f_stats_cycles_get();
+    uint32_t cycles = now - start;
+    u2f_profile_data_t * p_data = &m_profile[phase];
+
+    // Phases run in the worker only, but the CLI may read or clear them
+    CRITICAL_REGION_ENTER();
+    p_data->count++;
+    p_data->last = cycles;
+    p_data->total += cycles;
+    if(cycles > p_data->max)
+    {
+        p_data->max = cycles;
+    }
+    CRITICAL_REGION_EXIT();
+
+    U2F_TRACE(U2F_TRACE_EV_PHASE, phase, cycles);
+
+    // Leave the bookkeeping out of the next phase
+    return u2f_stats_cycles_get();
+}
+
+
+uint16_t u2f_stats_profile_encode(uint8_t * p_buf, uint16_t size)
+{
+    uint16_t len = 0;
+
+    for(uint32_t i = 0; i < U2F_PROFILE_COUNT; i++)
+    {
+        u2f_profile_data_t data;
+
+        if(size - len < U2F_PROFILE_ENCODED_SIZE) break;
+
+        CRITICAL_REGION_ENTER();
+        data = m_profile[i];
+        CRITICAL_REGION_EXIT();
+
+        len += uint32_encode(data.count, &p_buf[len]);
+        len += uint32_encode(data.last, &p_buf[len]);
+        len += uint32_encode(data.max, &p_buf[len]);
+        len += uint32_encode((uint32_t)data.total, &p_buf[len]);
+        len += uint32_encode((uint32_t)(data.total >> 32), &p_buf[len]);
+    }
+
+    return len;
+}
+
+
+u2f_stats_hist_data_t const * u2f_stats_hist_get(u2f_stats_hist_t hist)
+{
+    if(hist >= U2F_STATS_HIST_COUNT) return NULL;
+
+    return &m_hist[hist];
+}
+
+
+void u2f_stats_reset(void)
+{
+    CRITICAL_REGION_ENTER();
+    memset(m_hist, 0, sizeof(m_hist));
+    memset(m_profile, 0, sizeof(m_profile));
+    CRITICAL_REGION_EXIT();
+}
+
+
+/**
+ * @brief Convert CPU cycles to microseconds.
+ */
+static uint32_t cycles_to_us(uint64_t cycles)
+{
+    return (uint32_t)((cycles * 1000000) / SystemCoreClock);
+}
+
+
+static void cmd_stats_latency(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if(nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    for(uint32_t i = 0; i < U2F_STATS_HIST_COUNT; i++)
+    {
+        u2f_stats_hist_data_t hist;
+
+        // Take a consistent copy, the frame layer may record meanwhile
+        CRITICAL_REGION_ENTER();
+        hist = m_hist[i];
+        CRITICAL_REGION_EXIT();
+
+        if(hist.count == 0) continue;
+
+        nrf_cli_fprintf(p_cli, NRF_CLI_INFO, 
+                        "%s: %u samples, avg %u cycles (%u us), max %u us\r\n",
+                        m_hist_names[i], hist.count, 
+                        (uint32_t)(hist.total / hist.count),
+                        cycles_to_us(hist.total / hist.count),
+                        cycles_to_us(hist.max));
+
+        for(uint32_t b = 0; b < U2F_STATS_HIST_BUCKETS; b++)
+        {
+            if(hist.buckets[b] == 0) continue;
+
+            nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "  < %10u us: %u\r\n",
+                            cycles_to_us(2ULL << b), hist.buckets[b]);
+        }
+    }
+}
+
+
+static void cmd_stats_profile(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if(nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+#ifndef CONFIG_U2F_PROFILE_ENABLED
+    nrf_cli_fprintf(p_cli, NRF_CLI_WARNING, 
+                    "Built without CONFIG_U2F_PROFILE_ENABLED.\r\n");
+#endif
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_INFO, "%-14s %8s %10s %10s %10s\r\n",
+                    "phase", "count", "last us", "avg us", "max us");
+
+    for(uint32_t i = 0; i < U2F_PROFILE_COUNT; i++)
+    {
+        u2f_profile_data_t data;
+
+        CRITICAL_REGION_ENTER();
+        data = m_profile[i];
+        CRITICAL_REGION_EXIT();
+
+        if(data.count == 0) continue;
+
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-14s %8u %10u %10u %10u\r\n",
+                        m_profile_names[i], data.count, 
+                        cycles_to_us(data.last), 
+                        cycles_to_us(data.total / data.count), 
+                        cycles_to_us(data.max));
+    }
+}
+
+
+static void cmd_stats_usb(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    u2f_hid_if_stats_t stats;
+
+    if(nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    u2f_hid_if_stats_get(&stats);
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, 
+                    "frames in:      %u\r\n"
+                    "frames out:     %u\r\n"
+                    "invalid cid:    %u\r\n"
+                    "invalid seq:    %u\r\n"
+                    "invalid len:    %u\r\n"
+                    "timeouts:       %u\r\n"
+                    "channel busy:   %u\r\n"
+                    "rx queue full:  %u\r\n"
+                    "tx queue full:  %u\r\n"
+                    "tx wait max:    %u us\r\n"
+                    "suspends:       %u\r\n"
+                    "resumes:        %u\r\n",
+                    stats.frames_in, stats.frames_out,
+                    stats.invalid_cid, stats.invalid_seq, stats.invalid_len,
+                    stats.timeouts, stats.channel_busy,
+                    stats.rx_queue_full, stats.tx_queue_full,
+                    stats.tx_wait_max_us, stats.suspends, stats.resumes);
+}
+
+
+static void cmd_stats_reset(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if(nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    u2f_stats_reset();
+    u2f_hid_if_stats_reset();
+    nrf_cli_fprintf(p_cli, NRF_CLI_INFO, "Statistics cleared.\r\n");
+}
+
+
+static void cmd_stats(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    nrf_cli_help_print(p_cli, NULL, 0);
+}
+
+
+NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_sub_stats)
+{
+    NRF_CLI_CMD(latency, NULL, "Dump the U2F command latency histograms.", cmd_stats_latency),
+    NRF_CLI_CMD(profile, NULL, "Dump the U2F phase cycle counts.", cmd_stats_profile),
+    NRF_CLI_CMD(usb,     NULL, "Dump the USB transport counters.", cmd_stats_usb),
+    NRF_CLI_CMD(reset,   NULL, "Clear the statistics.", cmd_stats_reset),
+    NRF_CLI_SUBCMD_SET_END
+};
+
+NRF_CLI_CMD_REGISTER(stats, &m_sub_stats, "U2F statistics", cmd_stats);
+
@@ -0,0 +1,139 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "nrf.h"
+#include "app_util.h"
+#include "app_timer.h"
+#include "nrf_atomic.h"
+#include "SEGGER_RTT.h"
+
+#include "u2f_trace.h"
+
+
+STATIC_ASSERT(IS_POWER_OF_TWO(U2F_TRACE_RING_SIZE));
+
+#define U2F_TRACE_RING_MASK     (U2F_TRACE_RING_SIZE - 1)
+
+
+/**
+ * @brief Trace records.
+ */
+static u2f_trace_record_t m_ring[U2F_TRACE_RING_SIZE];
+
+
+/**
+ * @brief Number of records reserved by the writers.
+ */
+static nrf_atomic_u32_t m_head = 0;
+
+
+/**
+ * @brief Number of records read by @ref u2f_trace_flush.
+ */
+static uint32_t m_tail = 0;
+
+
+/**
+ * @brief RTT up buffer.
+ */
+static uint8_t m_rtt_buf[U2F_TRACE_RTT_BUFFER_SIZE];
+
+
+void u2f_trace_init(void)
+{
+    UNUSED_RETURN_VALUE(SEGGER_RTT_ConfigUpBuffer(U2F_TRACE_RTT_CHANNEL, "u2f_trace", 
+                                                  m_rtt_buf, sizeof(m_rtt_buf), 
+                                                  SEGGER_RTT_MODE_NO_BLOCK_SKIP));
+}
+
+
+void u2f_trace_write(u2f_trace_event_t id, uint32_t arg0, uint32_t arg1)
+{
+    // Reserve a slot, writers at a higher priority simply take the next one
+    uint32_t idx = nrf_atomic_u32_fetch_add(&m_head, 1);
+    u2f_trace_record_t * p_rec = &m_ring[idx & U2F_TRACE_RING_MASK];
+
+    // Invalidate the slot while it is being written
+    p_rec->seq = (uint16_t)(idx - 1);
+    __DMB();
+
+    p_rec->timestamp = app_timer_cnt_get();
+    p_rec->id = id;
+    p_rec->arg0 = arg0;
+    p_rec->arg1 = arg1;
+
+    // Publish
+    __DMB();
+    p_rec->seq = (uint16_t)idx;
+}
+
+
+void u2f_trace_flush(void)
+{
+    uint32_t head = m_head;
+
+    // Skip what has been overwritten, the decoder sees the gap in seq
+    if(head - m_tail > U2F_TRACE_RING_SIZE)
+    {
+        m_tail = head - U2F_TRACE_RING_SIZE;
+    }
+
+    while(m_tail != head)
+    {
+        u2f_trace_record_t rec = m_ring[m_tail & U2F_TRACE_RING_MASK];
+
+        __DMB();
+
+        // Not published yet, or overwritten meanwhile
+        if(rec.seq != (uint16_t)m_tail || 
+           m_ring[m_tail & U2F_TRACE_RING_MASK].seq != rec.seq)
+        {
+            if(m_head - m_tail > U2F_TRACE_RING_SIZE)
+            {
+                m_tail++;
+                continue;
+            }
+            break;
+        }
+
+        // RTT buffer full, retry on the next flush
+        if(SEGGER_RTT_Write(U2F_TRACE_RTT_CHANNEL, &rec, sizeof(rec)) == 0)
+        {
+            break;
+        }
+
+        m_tail++;
+    }
+}
+
@@ -0,0 +1,289 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "nrf.h"
+#include "app_util.h"
+
+#include "u2f_hid.h"
+#include "u2f_hid_if.h"
+#include "u2f_stats.h"
+#include "u2f_vendor.h"
+
+
+#ifndef U2F_FW_VERSION
+#define U2F_FW_VERSION "unknown"
+#endif
+
+/**
+ * @brief Source revision, from git describe in the Makefile, reported in
+ *        the version TLV.
+ */
+static char const m_fw_revision[] = U2F_FW_VERSION;
+
+
+/**
+ * @brief TLV writer.
+ */
+typedef struct
+{
+    uint8_t * p_buf;
+    uint16_t  size;
+    uint16_t  len;
+    bool      truncated;
+} tlv_writer_t;
+
+
+/**
+ * @brief Open a TLV of the given length, NULL if it does not fit.
+ *
+ * Two bytes are always kept for the truncation marker.
+ */
+static uint8_t * tlv_open(tlv_writer_t * p_wr, uint8_t tag, uint8_t length)
+{
+    uint8_t * p_value;
+
+    if(p_wr->truncated || p_wr->len + 2 + length + 2 > p_wr->size)
+    {
+        p_wr->truncated = true;
+        return NULL;
+    }
+
+    p_wr->p_buf[p_wr->len++] = tag;
+    p_wr->p_buf[p_wr->len++] = length;
+    p_value = &p_wr->p_buf[p_wr->len];
+    p_wr->len += length;
+
+    return p_value;
+}
+
+
+static void tlv_version_put(tlv_writer_t * p_wr)
+{
+    uint8_t * p_value = tlv_open(p_wr, U2F_VENDOR_TAG_VERSION, 
+                                 4 + sizeof(m_fw_revision) - 1);
+    if(p_value == NULL) return;
+
+    *p_value++ = U2FHID_IF_VERSION;
+    *p_value++ = U2FHID_FW_VERSION_MAJOR;
+    *p_value++ = U2FHID_FW_VERSION_MINOR;
+    *p_value++ = U2FHID_FW_VERSION_BUILD;
+    memcpy(p_value, m_fw_revision, sizeof(m_fw_revision) - 1);
+}
+
+
+static void tlv_usb_put(tlv_writer_t * p_wr)
+{
+    uint8_t * p_value = tlv_open(p_wr, U2F_VENDOR_TAG_USB,
+                                 sizeof(u2f_hid_if_stats_t));
+
+    if(p_value == NULL) return;
+
+    UNUSED_RETURN_VALUE(u2f_hid_if_stats_encode(p_value));
+}
+
+
+static void tlv_hist_put(tlv_writer_t * p_wr)
+{
+    for(uint32_t id = 0; id < U2F_STATS_HIST_COUNT; id++)
+    {
+        u2f_stats_hist_data_t const * p_hist = u2f_stats_hist_get(id);
+        uint8_t buckets = 0;
+        uint8_t * p_value;
+
+        if(p_hist->count == 0) continue;
+
+        for(uint32_t b = 0; b < U2F_STATS_HIST_BUCKETS; b++)
+        {
+            buckets += (p_hist->buckets[b] != 0);
+        }
+
+        // Only the non-empty buckets are sent
+        p_value = tlv_open(p_wr, U2F_VENDOR_TAG_HIST, 17 + buckets * 5);
+        if(p_value == NULL) return;
+
+        *p_value++ = id;
+        p_value += uint32_encode(p_hist->count, p_value);
+        p_value += uint32_encode(p_hist->max, p_value);
+        p_value += uint32_encode((uint32_t)p_hist->total, p_value);
+        p_value += uint32_encode((uint32_t)(p_hist->total >> 32), p_value);
+
+        for(uint32_t b = 0; b < U2F_STATS_HIST_BUCKETS && buckets > 0; b++)
+        {
+            if(p_hist->buckets[b] == 0) continue;
+
+            *p_value++ = b;
+            p_value += uint32_encode(p_hist->buckets[b], p_value);
+            buckets--;
+        }
+    }
+}
+
+
+static void tlv_memory_put(tlv_writer_t * p_wr)
+{
+    u2f_hid_if_stats_t stats;
+    uint8_t * p_value = tlv_open(p_wr, U2F_VENDOR_TAG_MEMORY, 20);
+
+    if(p_value == NULL) return;
+
+    u2f_hid_if_stats_get(&stats);
+
+    p_value += uint32_encode(u2f_stats_stack_size_get(), p_value);
+    p_value += uint32_encode(u2f_stats_stack_used_max_get(), p_value);
+    p_value += uint32_encode(u2f_stats_hwm_get(U2F_STATS_HWM_CHANNELS), p_value);
+    p_value += uint32_encode(stats.rx_queue_hwm, p_value);
+    p_value += uint32_encode(stats.tx_queue_hwm, p_value);
+}
+
+
+static void tlv_flash_put(tlv_writer_t * p_wr)
+{
+    u2f_stats_flash_t flash;
+    uint8_t * p_value = tlv_open(p_wr, U2F_VENDOR_TAG_FLASH, 34);
+
+    if(p_value == NULL) return;
+
+    u2f_stats_flash_get(&flash);
+
+    p_value += uint16_encode(flash.usage.pages_available, p_value);
+    p_value += uint16_encode(flash.usage.valid_records, p_value);
+    p_value += uint16_encode(flash.usage.dirty_records, p_value);
+    p_value += uint16_encode(flash.usage.words_used, p_value);
+    p_value += uint16_encode(flash.usage.freeable_words, p_value);
+    p_value += uint16_encode(flash.usage.largest_contig, p_value);
+    *p_value++ = flash.usage.corruption;
+    *p_value++ = 0;
+    p_value += uint32_encode(flash.writes, p_value);
+    p_value += uint32_encode(flash.updates, p_value);
+    p_value += uint32_encode(flash.deletes, p_value);
+    p_value += uint32_encode(flash.gc_runs, p_value);
+    p_value += uint32_encode(flash.failures, p_value);
+}
+
+
+static void tlv_profile_put(tlv_writer_t * p_wr)
+{
+    uint8_t * p_value = tlv_open(p_wr, U2F_VENDOR_TAG_PROFILE, 
+                                 U2F_PROFILE_COUNT * U2F_PROFILE_ENCODED_SIZE);
+    if(p_value == NULL) return;
+
+    UNUSED_RETURN_VALUE(u2f_stats_profile_encode(p_value, 
+                            U2F_PROFILE_COUNT * U2F_PROFILE_ENCODED_SIZE));
+}
+
+
+static void tlv_tag_put(tlv_writer_t * p_wr, uint8_t tag)
+{
+    switch(tag)
+    {
+        case U2F_VENDOR_TAG_VERSION: tlv_version_put(p_wr); break;
+        case U2F_VENDOR_TAG_USB:     tlv_usb_put(p_wr);     break;
+        case U2F_VENDOR_TAG_HIST:    tlv_hist_put(p_wr);    break;
+        case U2F_VENDOR_TAG_MEMORY:  tlv_memory_put(p_wr);  break;
+        case U2F_VENDOR_TAG_FLASH:   tlv_flash_put(p_wr);   break;
+        case U2F_VENDOR_TAG_PROFILE: tlv_profile_put(p_wr); break;
+        default:                                            break;
+    }
+}
+
+
+/**
+ * @brief Handle U2FHID_METRICS.
+ */
+static uint8_t u2f_vendor_metrics(uint8_t const * p_req, uint16_t req_len,
+                                  uint8_t * p_resp, uint16_t * p_resp_len)
+{
+    static uint8_t const all_tags[] =
+    {
+        U2F_VENDOR_TAG_VERSION,
+        U2F_VENDOR_TAG_USB,
+        U2F_VENDOR_TAG_MEMORY,
+        U2F_VENDOR_TAG_FLASH,
+        U2F_VENDOR_TAG_HIST,
+    };
+
+    tlv_writer_t wr = { .p_buf = p_resp, .size = *p_resp_len };
+
+    if(req_len == 0)
+    {
+        p_req = all_tags;
+        req_len = sizeof(all_tags);
+    }
+
+    for(uint16_t i = 0; i < req_len; i++)
+    {
+        tlv_tag_put(&wr, p_req[i]);
+    }
+
+    if(wr.truncated)
+    {
+        wr.p_buf[wr.len++] = U2F_VENDOR_TAG_TRUNCATED;
+        wr.p_buf[wr.len++] = 0;
+    }
+
+    *p_resp_len = wr.len;
+
+    return ERR_NONE;
+}
+
+
+uint8_t u2f_vendor_cmd_process(uint8_t cmd, 
+                               uint8_t const * p_req, uint16_t req_len,
+                               uint8_t * p_resp, uint16_t * p_resp_len)
+{
+    switch(cmd)
+    {
+        case U2FHID_PROFILE:
+#ifdef CONFIG_U2F_PROFILE_ENABLED
+            *p_resp_len = u2f_stats_profile_encode(p_resp, *p_resp_len);
+            return ERR_NONE;
+#else
+            return ERR_INVALID_CMD;
+#endif
+
+        case U2FHID_STATS:
+            if(*p_resp_len < sizeof(u2f_hid_if_stats_t)) return ERR_OTHER;
+
+            *p_resp_len = u2f_hid_if_stats_encode(p_resp);
+            return ERR_NONE;
+
+        case U2FHID_METRICS:
+            return u2f_vendor_metrics(p_req, req_len, p_resp, p_resp_len);
+
+        default:
+            return ERR_INVALID_CMD;
+    }
+}
+
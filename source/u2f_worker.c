@@ -0,0 +1,191 @@
+/**
+* Copyright (c) 2018 makerdiary
+* All rights reserved.
+* 
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*
+* * Redistributions of source code must retain the above copyright
+*   notice, this list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above
+*   copyright notice, this list of conditions and the following
+*   disclaimer in the documentation and/or other materials provided
+*   with the distribution.
+
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+* OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+* THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "nrf.h"
+#include "app_util_platform.h"
+#include "nrf_queue.h"
+
+#include "u2f_worker.h"
+
+#include "sdk_config.h"
+
+#define NRF_LOG_MODULE_NAME u2f_worker
+
+#if U2F_WORKER_CONFIG_LOG_ENABLED
+#define NRF_LOG_LEVEL       U2F_WORKER_CONFIG_LOG_LEVEL
+#else
+#define NRF_LOG_LEVEL       0
+#endif
+
+#include "nrf_log.h"
+
+NRF_LOG_MODULE_REGISTER();
+
+
+typedef struct
+{
+    u2f_worker_job_t job;
+    void           * p_context;
+} u2f_worker_job_desc_t;
+
+
+/**
+ * @brief Queue of pending jobs.
+ */
+NRF_QUEUE_DEF(u2f_worker_job_desc_t, m_job_queue, U2F_WORKER_QUEUE_SIZE,
+              NRF_QUEUE_MODE_NO_OVERFLOW);
+
+/**
+ * @brief Queue of finished jobs.
+ */
+NRF_QUEUE_DEF(void *, m_done_queue, U2F_WORKER_QUEUE_SIZE,
+              NRF_QUEUE_MODE_NO_OVERFLOW);
+
+
+/**
+ * @brief Completion handler.
+ */
+static u2f_worker_done_handler_t m_done_handler = NULL;
+
+
+/**
+ * @brief Number of jobs submitted but not yet completed.
+ */
+static volatile uint32_t m_jobs_in_progress = 0;
+
+
+/**
+ * @brief Worker interrupt handler, runs the queued jobs.
+ */
+void U2F_WORKER_IRQHandler(void)
+{
+    u2f_worker_job_desc_t desc;
+
+    while(nrf_queue_pop(&m_job_queue, &desc) == NRF_SUCCESS)
+    {
+        desc.job(desc.p_context);
+
+        if(nrf_queue_push(&m_done_queue, &desc.p_context) != NRF_SUCCESS)
+        {
+            /* Cannot happen: the completion queue is as large as the job 
+             * queue and u2f_worker_submit checks the jobs in progress. */
+            NRF_LOG_ERROR("Completion queue full!");
+        }
+
+        if(m_done_handler != NULL)
+        {
+            m_done_handler();
+        }
+    }
+}
+
+
+ret_code_t u2f_worker_init(u2f_worker_done_handler_t done_handler)
+{
+    m_done_handler = done_handler;
+    m_jobs_in_progress = 0;
+
+    nrf_queue_reset(&m_job_queue);
+    nrf_queue_reset(&m_done_queue);
+
+    NVIC_SetPriority(U2F_WORKER_IRQn, U2F_WORKER_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(U2F_WORKER_IRQn);
+    NVIC_EnableIRQ(U2F_WORKER_IRQn);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t u2f_worker_submit(u2f_worker_job_t job, void * p_context)
+{
+    u2f_worker_job_desc_t desc = {
+        .job       = job,
+        .p_context = p_context,
+    };
+
+    ret_code_t ret = NRF_ERROR_BUSY;
+
+    CRITICAL_REGION_ENTER();
+    if(m_jobs_in_progress < U2F_WORKER_QUEUE_SIZE)
+    {
+        ret = nrf_queue_push(&m_job_queue, &desc);
+        if(ret == NRF_SUCCESS)
+        {
+            m_jobs_in_progress++;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    if(ret != NRF_SUCCESS)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    NVIC_SetPendingIRQ(U2F_WORKER_IRQn);
+
+    return NRF_SUCCESS;
+}
+
+
+bool u2f_worker_done_get(void ** pp_context)
+{
+    if(nrf_queue_pop(&m_done_queue, pp_context) != NRF_SUCCESS)
+    {
+        return false;
+    }
+
+    CRITICAL_REGION_ENTER();
+    m_jobs_in_progress--;
+    CRITICAL_REGION_EXIT();
+
+    return true;
+}
+
+
+bool u2f_worker_is_busy(void)
+{
+    return (m_jobs_in_progress > 0);
+}
+
+
+void u2f_worker_suspend(void)
+{
+    NVIC_DisableIRQ(U2F_WORKER_IRQn);
+}
+
+
+void u2f_worker_resume(void)
+{
+    NVIC_EnableIRQ(U2F_WORKER_IRQn);
+}
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+
+
+# Copyright (c) 2018 makerdiary
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+# * Redistributions of source code must retain the above copyright
+#   notice, this list of conditions and the following disclaimer.
+#
+# * Redistributions in binary form must reproduce the above
+#   copyright notice, this list of conditions and the following
+#   disclaimer in the documentation and/or other materials provided
+#   with the distribution.
+
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Generate the fixed-base comb table of secp256r1 used by the comb backend
+# of u2f_crypto (source/u2f_crypto_comb.c).
+#
+# Entry u of block j is sum(u_r * 2^(r*d + j*e) * G) over the teeth r, with
+# d = 256 / teeth and e = d / blocks. The coordinates are affine, in the
+# Montgomery domain of p, as 32-bit little endian limbs.
+#
+# Run by the Makefiles, e.g.:
+#   python3 gen_p256_comb.py -o _build/u2f_crypto_comb_table.c
+
+import argparse
+import sys
+
+# Keep in sync with include/u2f_crypto_comb.h
+TEETH = 4
+BLOCKS = 4
+
+P = 0xffffffff00000001000000000000000000000000ffffffffffffffffffffffff
+A = P - 3
+B = 0x5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b
+GX = 0x6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296
+GY = 0x4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5
+BITS = 256
+R = 1 << BITS
+
+
+def point_add(p1, p2):
+    if p1 is None:
+        return p2
+    if p2 is None:
+        return p1
+    (x1, y1), (x2, y2) = p1, p2
+    if x1 == x2:
+        if (y1 + y2) % P == 0:
+            return None
+        lam = (3 * x1 * x1 + A) * pow(2 * y1, -1, P) % P
+    else:
+        lam = (y2 - y1) * pow(x2 - x1, -1, P) % P
+    x3 = (lam * lam - x1 - x2) % P
+    return (x3, (lam * (x1 - x3) - y1) % P)
+
+
+def point_mul(k, point):
+    result = None
+    while k:
+        if k & 1:
+            result = point_add(result, point)
+        point = point_add(point, point)
+        k >>= 1
+    return result
+
+
+def limbs(value):
+    value = value * R % P
+    return ', '.join('0x%08x' % ((value >> (32 * i)) & 0xffffffff)
+                     for i in range(BITS // 32))
+
+
+def generate(teeth, blocks):
+    d = BITS // teeth
+    e = d // blocks
+    g = (GX, GY)
+
+    assert (GY * GY - GX * GX * GX - A * GX - B) % P == 0, 'G not on the curve'
+
+    lines = []
+    for j in range(blocks):
+        lines.append('    {')
+        for u in range(1, 1 << teeth):
+            k = sum(1 << (r * d + j * e) for r in range(teeth) if u >> r & 1)
+            x, y = point_mul(k, g)
+            lines.append('        {')
+            lines.append('            { %s },' % limbs(x))
+            lines.append('            { %s },' % limbs(y))
+            lines.append('        },')
+        lines.append('    },')
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Generate the secp256r1 comb table of u2f_crypto.')
+    parser.add_argument('-o', '--output', help='C file to write, stdout by default')
+    parser.add_argument('--teeth', type=int, default=TEETH)
+    parser.add_argument('--blocks', type=int, default=BLOCKS)
+    args = parser.parse_args()
+
+    if BITS % args.teeth or (BITS // args.teeth) % args.blocks:
+        sys.exit('teeth and blocks must divide %d' % BITS)
+
+    text = '''/* This file was automatically generated by gen_p256_comb.py, do not edit. */
+
+#include <stdint.h>
+
+#include "u2f_crypto_comb.h"
+
+#if (U2F_CRYPTO_COMB_TEETH != %(teeth)d) || (U2F_CRYPTO_COMB_BLOCKS != %(blocks)d)
+#error "Comb table of %(teeth)d teeth and %(blocks)d blocks, run tools/gen_p256_comb.py again"
+#endif
+
+u2f_crypto_comb_point_t const g_u2f_crypto_comb_table[U2F_CRYPTO_COMB_BLOCKS][U2F_CRYPTO_COMB_POINTS] =
+{
+%(table)s
+};
+''' % {'teeth': args.teeth, 'blocks': args.blocks,
+       'table': generate(args.teeth, args.blocks)}
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2018 makerdiary
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+# * Redistributions of source code must retain the above copyright
+#   notice, this list of conditions and the following disclaimer.
+#
+# * Redistributions in binary form must reproduce the above
+#   copyright notice, this list of conditions and the following
+#   disclaimer in the documentation and/or other materials provided
+#   with the distribution.
+
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# End-to-end benchmark of the host build, over its virtual HID socket.
+#
+# Usage:
+#   (cd boards/host && make serve) &
+#   python3 u2f_host_bench.py [-n count] [-s socket]
+#
+# Reports register/s, authenticate/s and the PING throughput, with the
+# latency percentiles seen by the client.
+
+import argparse
+import hashlib
+import os
+import struct
+import time
+
+from u2f_socket_device import SocketCtapDevice, DEFAULT_SOCKET, U2FHID_MSG, \
+    U2FHID_PING
+
+U2F_REGISTER = 0x01
+U2F_AUTHENTICATE = 0x02
+U2F_AUTH_ENFORCE = 0x03
+U2F_SW_NO_ERROR = 0x9000
+
+# Largest request the device reassembles, U2F_MAX_REQ_SIZE in include/u2f.h
+PING_MAX_SIZE = 203
+
+
+class U2fStatusError(IOError):
+    def __init__(self, sw):
+        super().__init__('U2F status 0x%04x' % sw)
+        self.sw = sw
+
+
+def apdu(ins, p1, data):
+    return struct.pack('>BBBBBH', 0, ins, p1, 0, 0, len(data)) + data
+
+
+def u2f_msg(dev, ins, p1, data):
+    resp = dev.call(U2FHID_MSG, apdu(ins, p1, data))
+    sw = struct.unpack('>H', resp[-2:])[0]
+    if sw != U2F_SW_NO_ERROR:
+        raise U2fStatusError(sw)
+    return resp[:-2]
+
+
+def register(dev, app_id):
+    resp = u2f_msg(dev, U2F_REGISTER, 0, os.urandom(32) + app_id)
+    kh_len = resp[66]
+    return resp[67:67 + kh_len]
+
+
+def authenticate(dev, app_id, key_handle):
+    return u2f_msg(dev, U2F_AUTHENTICATE, U2F_AUTH_ENFORCE,
+                   os.urandom(32) + app_id + bytes([len(key_handle)]) +
+                   key_handle)
+
+
+def percentile(samples, p):
+    samples = sorted(samples)
+    return samples[min(len(samples) - 1, int(len(samples) * p / 100))]
+
+
+def run(name, count, op):
+    lat = []
+    start = time.perf_counter()
+    for _ in range(count):
+        t = time.perf_counter()
+        op()
+        lat.append(time.perf_counter() - t)
+    elapsed = time.perf_counter() - start
+    print('%-13s %6d ops %9.1f ops/s   p50 %8.1f us   p99 %8.1f us   '
+          'max %8.1f us' % (name, count, count / elapsed,
+                            percentile(lat, 50) * 1e6,
+                            percentile(lat, 99) * 1e6, max(lat) * 1e6))
+    return elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('-s', '--socket', default=DEFAULT_SOCKET)
+    parser.add_argument('-n', '--count', type=int, default=200)
+    parser.add_argument('--ping-size', type=int, default=PING_MAX_SIZE)
+    args = parser.parse_args()
+
+    dev = SocketCtapDevice(args.socket)
+    app_id = hashlib.sha256(b'https://example.com').digest()
+    payload = os.urandom(args.ping_size)
+
+    key_handles = []
+    run('register', args.count,
+        lambda: key_handles.append(register(dev, app_id)))
+    run('authenticate', args.count,
+        lambda: authenticate(dev, app_id, key_handles[-1]))
+
+    def ping():
+        if dev.call(U2FHID_PING, payload) != payload:
+            raise IOError('PING echo mismatch')
+
+    elapsed = run('ping %d B' % args.ping_size, args.count, ping)
+    print('ping throughput %.3f MB/s each way' % (
+        args.count * args.ping_size / elapsed / 1e6))
+
+    dev.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2018 makerdiary
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+# * Redistributions of source code must retain the above copyright
+#   notice, this list of conditions and the following disclaimer.
+#
+# * Redistributions in binary form must reproduce the above
+#   copyright notice, this list of conditions and the following
+#   disclaimer in the documentation and/or other materials provided
+#   with the distribution.
+
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Load generator: N concurrent clients on their own U2FHID channels.
+#
+# Usage:
+#   (cd boards/host && make serve) &
+#   python3 u2f_load.py [-c clients] [-d seconds] [--mix ping=4,...]
+#                       [--interleave frame|message] [--think ms]
+#                       [--backoff ms]
+#
+# Each client connects to the virtual HID device of the host build, as a
+# browser or an agent opening the same key would, allocates its channel and
+# runs a random mix of INIT, PING, REGISTER and AUTHENTICATE. With
+# --interleave frame the clients send freely, so the reports of their
+# messages interleave on the device; with --interleave message one message
+# is on the wire at a time, which gives the baseline.
+#
+# Reports the latency percentiles of each client, the errors by code
+# (ERR_CHANNEL_BUSY, timeouts...) and the aggregate throughput.
+
+import argparse
+import collections
+import hashlib
+import os
+import random
+import socket
+import threading
+import time
+
+from u2f_socket_device import SocketCtapDevice, CtapError, DEFAULT_SOCKET, \
+    U2FHID_PING
+from u2f_host_bench import register, authenticate, U2fStatusError
+import u2f_socket_device
+
+OPS = ('init', 'ping', 'register', 'authenticate')
+
+ERR_NAMES = dict((getattr(u2f_socket_device, name), name)
+                 for name in dir(u2f_socket_device) if name.startswith('ERR_'))
+
+APP_ID = hashlib.sha256(b'https://example.com').digest()
+
+PING_SIZE = 128
+
+
+def parse_mix(text):
+    mix = {}
+    for item in text.split(','):
+        op, _, weight = item.partition('=')
+        if op not in OPS:
+            raise argparse.ArgumentTypeError('unknown operation %s' % op)
+        mix[op] = int(weight or 1)
+    return mix
+
+
+def percentile(samples, p):
+    samples = sorted(samples)
+    return samples[min(len(samples) - 1, int(len(samples) * p / 100))]
+
+
+class Client(threading.Thread):
+
+    def __init__(self, index, args, wire_lock, deadline):
+        super().__init__(daemon=True)
+        self.index = index
+        self.args = args
+        self.wire_lock = wire_lock
+        self.deadline = deadline
+        self.rand = random.Random(args.seed + index)
+        self.latency = collections.defaultdict(list)
+        self.errors = collections.Counter()
+        self.dev = None
+        self.key_handle = None
+
+    def connect(self):
+        if self.dev is not None:
+            self.dev.close()
+        self.dev = SocketCtapDevice(self.args.socket, self.args.timeout)
+
+    def op(self, name):
+        if name == 'init':
+            self.dev.init()
+        elif name == 'ping':
+            payload = os.urandom(PING_SIZE)
+            if self.dev.call(U2FHID_PING, payload) != payload:
+                raise IOError('PING echo mismatch')
+        elif name == 'register' or self.key_handle is None:
+            self.key_handle = register(self.dev, APP_ID)
+        else:
+            authenticate(self.dev, APP_ID, self.key_handle)
+
+    def run(self):
+        ops = [op for op, weight in sorted(self.args.mix.items())
+               for _ in range(weight)]
+
+        while time.monotonic() < self.deadline:
+            name = self.rand.choice(ops)
+            try:
+                with self.wire_lock:
+                    if self.dev is None:
+                        self.connect()
+                    start = time.perf_counter()
+                    self.op(name)
+                    self.latency[name].append(time.perf_counter() - start)
+            except CtapError as e:
+                code = int(e.code)
+                self.errors[ERR_NAMES.get(code, 'ERR 0x%02x' % code)] += 1
+                # Retry later, as the browsers do
+                time.sleep(self.rand.uniform(0, self.args.backoff) / 1000)
+            except U2fStatusError as e:
+                self.errors['SW 0x%04x' % e.sw] += 1
+            except socket.timeout:
+                self.errors['timeout'] += 1
+                self.dev = None
+            except (IOError, OSError) as e:
+                self.errors['protocol: %s' % e] += 1
+                self.dev = None
+
+            if self.args.think:
+                time.sleep(self.rand.uniform(0, self.args.think) / 1000)
+
+        if self.dev is not None:
+            self.dev.close()
+
+
+class NoLock(object):
+    def __enter__(self):
+        pass
+
+    def __exit__(self, *exc):
+        pass
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-s', '--socket', default=DEFAULT_SOCKET)
+    parser.add_argument('-c', '--clients', type=int, default=4)
+    parser.add_argument('-d', '--duration', type=float, default=5.0,
+                        help='seconds')
+    parser.add_argument('--mix', type=parse_mix,
+                        default=parse_mix('init=1,ping=4,register=1,'
+                                          'authenticate=4'),
+                        help='weights of the operations, e.g. ping=4,init=1')
+    parser.add_argument('--interleave', choices=('frame', 'message'),
+                        default='frame')
+    parser.add_argument('--think', type=float, default=0,
+                        help='random pause between operations, max ms')
+    parser.add_argument('--backoff', type=float, default=10,
+                        help='random pause after an error, max ms')
+    parser.add_argument('--timeout', type=float, default=2.0,
+                        help='response timeout, seconds')
+    parser.add_argument('--seed', type=int, default=1)
+    args = parser.parse_args()
+
+    wire_lock = threading.Lock() if args.interleave == 'message' else NoLock()
+    start = time.monotonic()
+    clients = [Client(i, args, wire_lock, start + args.duration)
+               for i in range(args.clients)]
+    for client in clients:
+        client.start()
+    for client in clients:
+        client.join()
+    elapsed = time.monotonic() - start
+
+    totals = collections.defaultdict(list)
+    errors = collections.Counter()
+
+    print('%-6s %-13s %7s %10s %10s %10s' % (
+        'client', 'operation', 'count', 'p50 us', 'p90 us', 'p99 us'))
+    for client in clients:
+        for name in OPS:
+            lat = client.latency[name]
+            if not lat:
+                continue
+            totals[name] += lat
+            print('%-6d %-13s %7d %10.1f %10.1f %10.1f' % (
+                client.index, name, len(lat), percentile(lat, 50) * 1e6,
+                percentile(lat, 90) * 1e6, percentile(lat, 99) * 1e6))
+        for name, count in sorted(client.errors.items()):
+            print('%-6d %-13s %7d' % (client.index, name, count))
+        errors.update(client.errors)
+
+    print('')
+    print('%d clients, %s interleaving, %.1f s' % (
+        args.clients, args.interleave, elapsed))
+    count = 0
+    for name in OPS:
+        lat = totals[name]
+        if not lat:
+            continue
+        count += len(lat)
+        print('  %-13s %7d ops %9.1f ops/s   p50 %8.1f us   p99 %8.1f us' % (
+            name, len(lat), len(lat) / elapsed, percentile(lat, 50) * 1e6,
+            percentile(lat, 99) * 1e6))
+    print('  %-13s %7d ops %9.1f ops/s' % ('total', count, count / elapsed))
+    for name, n in sorted(errors.items()):
+        print('  %-13s %7d' % (name, n))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+
+
+# Copyright (c) 2018 makerdiary
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+# * Redistributions of source code must retain the above copyright
+#   notice, this list of conditions and the following disclaimer.
+#
+# * Redistributions in binary form must reproduce the above
+#   copyright notice, this list of conditions and the following
+#   disclaimer in the documentation and/or other materials provided
+#   with the distribution.
+
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Read the U2FHID vendor metrics (U2FHID_METRICS) of a connected key.
+#
+# Usage:
+#   python3 u2f_metrics.py [tag ...]
+#
+# where tag is one of: version usb hist memory flash profile. Without tags
+# the device sends everything but the phase profile.
+
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                'python-fido2'))
+
+from fido2.hid import CtapHidDevice  # noqa: E402
+
+# Keep in sync with include/u2f_vendor.h, without the TYPE_INIT bit
+U2FHID_PROFILE = 0x40
+U2FHID_STATS = 0x41
+U2FHID_METRICS = 0x42
+
+TAG_VERSION = 0x01
+TAG_USB = 0x02
+TAG_HIST = 0x03
+TAG_MEMORY = 0x04
+TAG_FLASH = 0x05
+TAG_PROFILE = 0x06
+TAG_TRUNCATED = 0xff
+
+TAGS = {
+    'version': TAG_VERSION, 'usb': TAG_USB, 'hist': TAG_HIST,
+    'memory': TAG_MEMORY, 'flash': TAG_FLASH, 'profile': TAG_PROFILE,
+}
+
+CPU_FREQ = 64000000
+
+# Keep in sync with u2f_hid_if_stats_t in include/u2f_hid_if.h
+USB_COUNTERS = [
+    'frames_in', 'frames_out', 'invalid_cid', 'invalid_seq', 'invalid_len',
+    'timeouts', 'channel_busy', 'rx_queue_full', 'tx_queue_full',
+    'tx_wait_max_us', 'suspends', 'resumes', 'rx_queue_hwm', 'tx_queue_hwm',
+]
+
+# Keep in sync with u2f_stats_hist_t in include/u2f_stats.h
+HISTOGRAMS = [
+    'PING', 'MSG', 'LOCK', 'INIT', 'WINK', 'SYNC', 'VENDOR', 'REGISTER',
+    'AUTHENTICATE', 'VERSION', 'INS_OTHER',
+]
+
+# Keep in sync with u2f_profile_phase_t in include/u2f_stats.h
+PHASES = [
+    'reg keygen', 'reg wrap', 'reg hash', 'reg sign', 'reg der',
+    'auth unwrap', 'auth counter', 'auth hash', 'auth sign', 'auth der',
+]
+
+
+def us(cycles):
+    return cycles * 1e6 / CPU_FREQ
+
+
+def parse_tlv(data):
+    off = 0
+    while off + 2 <= len(data):
+        tag, length = data[off], data[off + 1]
+        yield tag, data[off + 2:off + 2 + length]
+        off += 2 + length
+
+
+def show_version(value):
+    if_ver, major, minor, build = struct.unpack_from('<4B', value)
+    print('version:    %d.%d.%d (U2FHID v%d), revision %s' % (
+        major, minor, build, if_ver, value[4:].decode('ascii', 'replace')))
+
+
+def show_usb(value):
+    counters = struct.unpack_from('<%dI' % (len(value) // 4), value)
+    print('usb:')
+    for name, count in zip(USB_COUNTERS, counters):
+        print('  %-16s %u' % (name, count))
+
+
+def show_hist(value):
+    hid, count, cmax, lo, hi = struct.unpack_from('<BIIII', value)
+    total = lo | (hi << 32)
+    name = HISTOGRAMS[hid] if hid < len(HISTOGRAMS) else 'hist %d' % hid
+    print('latency %s: %u samples, avg %.1f us, max %.1f us' % (
+        name, count, us(total / count), us(cmax)))
+    for off in range(17, len(value), 5):
+        bucket, n = struct.unpack_from('<BI', value, off)
+        print('  < %12.1f us: %u' % (us(2 << bucket), n))
+
+
+def show_memory(value):
+    stack, used, channels, rx, tx = struct.unpack_from('<5I', value)
+    print('memory:')
+    print('  stack used max   %u / %u bytes' % (used, stack))
+    print('  channels max     %u' % channels)
+    print('  rx queue max     %u' % rx)
+    print('  tx queue max     %u' % tx)
+
+
+def show_flash(value):
+    (pages, valid, dirty, used, freeable, contig, corruption, _,
+     writes, updates, deletes, gc_runs, failures) = struct.unpack_from(
+        '<6H2B5I', value)
+    print('flash:')
+    print('  pages available  %u' % pages)
+    print('  records          %u valid, %u dirty' % (valid, dirty))
+    print('  words            %u used, %u freeable, %u largest free' % (
+        used, freeable, contig))
+    print('  corruption       %s' % bool(corruption))
+    print('  operations       %u writes, %u updates, %u deletes' % (
+        writes, updates, deletes))
+    print('  gc runs          %u' % gc_runs)
+    print('  failures         %u' % failures)
+
+
+def show_profile(value):
+    print('profile:')
+    print('  %-14s %8s %10s %10s %10s' % (
+        'phase', 'count', 'last us', 'avg us', 'max us'))
+    for i, off in enumerate(range(0, len(value), 20)):
+        count, last, pmax, lo, hi = struct.unpack_from('<5I', value, off)
+        if count == 0:
+            continue
+        total = lo | (hi << 32)
+        name = PHASES[i] if i < len(PHASES) else 'phase %d' % i
+        print('  %-14s %8u %10.1f %10.1f %10.1f' % (
+            name, count, us(last), us(total / count), us(pmax)))
+
+
+SHOW = {
+    TAG_VERSION: show_version, TAG_USB: show_usb, TAG_HIST: show_hist,
+    TAG_MEMORY: show_memory, TAG_FLASH: show_flash,
+    TAG_PROFILE: show_profile,
+}
+
+
+def main():
+    try:
+        tags = bytes(TAGS[t] for t in sys.argv[1:])
+    except KeyError as e:
+        print('Unknown tag %s, use one of: %s' % (e, ' '.join(sorted(TAGS))))
+        sys.exit(1)
+
+    dev = next(CtapHidDevice.list_devices(), None)
+    if dev is None:
+        print('No U2F device found!')
+        sys.exit(1)
+
+    data = bytearray(dev.call(U2FHID_METRICS, tags))
+
+    for tag, value in parse_tlv(data):
+        if tag == TAG_TRUNCATED:
+            print('(response truncated, ask for the missing tags alone)')
+        elif tag in SHOW:
+            SHOW[tag](value)
+        else:
+            print('unknown tag 0x%02x, %d bytes' % (tag, len(value)))
+
+
+if __name__ == '__main__':
+    main()
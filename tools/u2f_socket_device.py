@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+
+
+# Copyright (c) 2018 makerdiary
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+# * Redistributions of source code must retain the above copyright
+#   notice, this list of conditions and the following disclaimer.
+#
+# * Redistributions in binary form must reproduce the above
+#   copyright notice, this list of conditions and the following
+#   disclaimer in the documentation and/or other materials provided
+#   with the distribution.
+
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# CtapDevice for the virtual HID device of the host build.
+#
+# The host build (boards/host) serves the U2F HID interface on a Unix
+# socket, each 64-byte report carried as is:
+#   cd boards/host && make serve
+# Client code of python-fido2 can then use SocketCtapDevice like a
+# CtapHidDevice, e.g. fido2.ctap1.CTAP1(SocketCtapDevice()).
+#
+# The device sends its IN reports to every connected client, as hidraw does,
+# so several clients can share it on their own channels.
+
+import os
+import socket
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                'python-fido2'))
+
+try:
+    from fido2.ctap import CtapDevice, CtapError
+except ImportError:
+    # Without python-fido2, the device still works for the tools of this
+    # directory.
+    CtapDevice = object
+
+    class CtapError(Exception):
+        def __init__(self, code):
+            super().__init__('CTAP error: 0x%02x' % code)
+            self.code = code
+
+
+DEFAULT_SOCKET = os.environ.get('U2F_HOST_SOCKET', '/tmp/u2f_host.sock')
+
+HID_RPT_SIZE = 64
+INIT_DATA_SIZE = HID_RPT_SIZE - 7
+CONT_DATA_SIZE = HID_RPT_SIZE - 5
+
+CID_BROADCAST = 0xffffffff
+TYPE_INIT = 0x80
+
+# Keep in sync with include/u2f_hid.h, without the TYPE_INIT bit
+U2FHID_PING = 0x01
+U2FHID_MSG = 0x03
+U2FHID_LOCK = 0x04
+U2FHID_INIT = 0x06
+U2FHID_WINK = 0x08
+U2FHID_SYNC = 0x3c
+U2FHID_ERROR = 0x3f
+
+ERR_INVALID_CMD = 0x01
+ERR_INVALID_PAR = 0x02
+ERR_INVALID_LEN = 0x03
+ERR_INVALID_SEQ = 0x04
+ERR_MSG_TIMEOUT = 0x05
+ERR_CHANNEL_BUSY = 0x06
+ERR_LOCK_REQUIRED = 0x0a
+ERR_SYNC_FAIL = 0x0b
+ERR_OTHER = 0x7f
+
+CAPFLAG_WINK = 0x01
+
+
+def frames(cid, cmd, data):
+    """Split a message in the reports carrying it."""
+    header = struct.pack('>IBH', cid, TYPE_INIT | cmd, len(data))
+    yield (header + data[:INIT_DATA_SIZE]).ljust(HID_RPT_SIZE, b'\0')
+    seq = 0
+    for off in range(INIT_DATA_SIZE, len(data), CONT_DATA_SIZE):
+        chunk = data[off:off + CONT_DATA_SIZE]
+        yield (struct.pack('>IB', cid, seq) + chunk).ljust(HID_RPT_SIZE, b'\0')
+        seq += 1
+
+
+class SocketCtapDevice(CtapDevice):
+    """CTAPHID device on the Unix socket of the host build."""
+
+    def __init__(self, path=DEFAULT_SOCKET, timeout=5.0):
+        self.descriptor = path
+        self._sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self._sock.settimeout(timeout)
+        self._buf = b''
+        self._channel_id = CID_BROADCAST
+        try:
+            self._sock.connect(path)
+            self.init()
+        except Exception:
+            self._sock.close()
+            raise
+
+    def __repr__(self):
+        return 'SocketCtapDevice(%s, cid 0x%08x)' % (self.descriptor,
+                                                     self._channel_id)
+
+    def init(self):
+        """Allocate a new channel, with INIT on the broadcast channel.
+
+        The INIT responses of the other clients are skipped by their nonce.
+        """
+        channel_id, self._channel_id = self._channel_id, CID_BROADCAST
+        nonce = os.urandom(8)
+        try:
+            self.send(U2FHID_INIT, nonce)
+            while True:
+                resp = self.recv(U2FHID_INIT)
+                if resp[:8] == nonce:
+                    break
+        except Exception:
+            self._channel_id = channel_id
+            raise
+        (self._channel_id, self._u2fhid_version, major, minor, build,
+         self._capabilities) = struct.unpack_from('>IBBBBB', resp, 8)
+        self._device_version = (major, minor, build)
+
+    @property
+    def channel_id(self):
+        return self._channel_id
+
+    @property
+    def version(self):
+        """U2FHID protocol version."""
+        return self._u2fhid_version
+
+    @property
+    def device_version(self):
+        """Device version, (major, minor, build)."""
+        return self._device_version
+
+    @property
+    def capabilities(self):
+        """Capabilities flags, from the INIT response."""
+        return self._capabilities
+
+    def _drain(self):
+        """Drop the reports received so far.
+
+        They are responses to other clients, or late responses to requests
+        given up on, which must not be taken for the next response.
+        """
+        timeout = self._sock.gettimeout()
+        self._sock.setblocking(False)
+        try:
+            while True:
+                chunk = self._sock.recv(4096)
+                if not chunk:
+                    raise IOError('Device disconnected')
+                self._buf += chunk
+        except BlockingIOError:
+            pass
+        finally:
+            self._sock.settimeout(timeout)
+        self._buf = self._buf[len(self._buf) // HID_RPT_SIZE * HID_RPT_SIZE:]
+
+    def send(self, cmd, data=b''):
+        """Send a message, without waiting for the response."""
+        self._drain()
+        for report in frames(self._channel_id, cmd, bytes(data)):
+            self._sock.sendall(report)
+
+    def _read_report(self):
+        while len(self._buf) < HID_RPT_SIZE:
+            chunk = self._sock.recv(4096)
+            if not chunk:
+                raise IOError('Device disconnected')
+            self._buf += chunk
+        report = self._buf[:HID_RPT_SIZE]
+        self._buf = self._buf[HID_RPT_SIZE:]
+        return report
+
+    def recv(self, cmd):
+        """Receive the response to a message, skipping other channels."""
+        while True:
+            report = self._read_report()
+            cid, rcmd, size = struct.unpack_from('>IBH', report)
+            if cid == self._channel_id and rcmd & TYPE_INIT:
+                break
+        data = report[7:7 + size]
+        seq = 0
+        while len(data) < size:
+            report = self._read_report()
+            rcid, rseq = struct.unpack_from('>IB', report)
+            if rcid != self._channel_id:
+                continue
+            if rseq != seq:
+                raise IOError('Wrong sequence number %d, expected %d' % (
+                    rseq, seq))
+            data += report[5:5 + min(CONT_DATA_SIZE, size - len(data))]
+            seq += 1
+
+        rcmd &= ~TYPE_INIT
+        if rcmd == U2FHID_ERROR:
+            raise CtapError(data[0])
+        if rcmd != cmd:
+            raise IOError('Wrong command 0x%02x in response, expected 0x%02x' % (
+                rcmd, cmd))
+        return data
+
+    def call(self, cmd, data=b'', event=None, on_keepalive=None):
+        self.send(cmd, data)
+        return self.recv(cmd)
+
+    def wink(self):
+        self.call(U2FHID_WINK)
+
+    def ping(self, msg=b'Hello U2F'):
+        return self.call(U2FHID_PING, msg)
+
+    def close(self):
+        self._sock.close()
+
+    @classmethod
+    def list_devices(cls, path=DEFAULT_SOCKET):
+        if os.path.exists(path):
+            yield cls(path)
+
+
+if __name__ == '__main__':
+    for dev in SocketCtapDevice.list_devices(*sys.argv[1:2]):
+        print('%r: U2FHID v%d, version %d.%d.%d, capabilities 0x%02x' % (
+            (dev, dev.version) + dev.device_version + (dev.capabilities,)))
+        dev.close()
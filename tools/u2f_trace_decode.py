@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+
+
+# Copyright (c) 2018 makerdiary
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+# * Redistributions of source code must retain the above copyright
+#   notice, this list of conditions and the following disclaimer.
+#
+# * Redistributions in binary form must reproduce the above
+#   copyright notice, this list of conditions and the following
+#   disclaimer in the documentation and/or other materials provided
+#   with the distribution.
+
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Decode the binary U2F trace streamed on RTT channel 1.
+#
+# Capture with e.g.:
+#   JLinkRTTLogger -Device NRF52840_XXAA -If SWD -Speed 4000 -RTTChannel 1 trace.bin
+# then:
+#   python3 u2f_trace_decode.py trace.bin
+
+import struct
+import sys
+
+RECORD = struct.Struct('<IHHII')
+RTC_FREQ = 32768
+RTC_WRAP = 1 << 24
+CPU_FREQ = 64000000
+
+# Keep in sync with include/u2f_trace.h
+EV_FRAME_RX  = 1
+EV_FRAME_TX  = 2
+EV_CMD       = 3
+EV_CH_STATE  = 4
+EV_CH_ALLOC  = 5
+EV_CH_FREE   = 6
+EV_ERROR     = 7
+EV_MSG_START = 8
+EV_MSG_DONE  = 9
+EV_PHASE     = 10
+EV_FDS       = 11
+
+CMDS = {
+    0x81: 'PING', 0x83: 'MSG', 0x84: 'LOCK', 0x86: 'INIT',
+    0x88: 'WINK', 0xbc: 'SYNC', 0xbf: 'ERROR', 0xc0: 'PROFILE', 0xc1: 'STATS', 0xc2: 'METRICS',
+}
+
+INS = {0x01: 'REGISTER', 0x02: 'AUTHENTICATE', 0x03: 'VERSION'}
+
+STATES = {1: 'IDLE', 2: 'READY', 3: 'BUSY'}
+
+ERRORS = {
+    0x01: 'INVALID_CMD', 0x02: 'INVALID_PAR', 0x03: 'INVALID_LEN',
+    0x04: 'INVALID_SEQ', 0x05: 'MSG_TIMEOUT', 0x06: 'CHANNEL_BUSY',
+    0x0a: 'LOCK_REQUIRED', 0x0b: 'SYNC_FAIL', 0x7f: 'OTHER',
+}
+
+# Keep in sync with u2f_profile_phase_t in include/u2f_stats.h
+PHASES = [
+    'reg keygen', 'reg wrap', 'reg hash', 'reg sign', 'reg der',
+    'auth unwrap', 'auth counter', 'auth hash', 'auth sign', 'auth der',
+]
+
+FDS_EVENTS = {0: 'INIT', 1: 'WRITE', 2: 'UPDATE', 3: 'DEL_RECORD',
+              4: 'DEL_FILE', 5: 'GC'}
+
+
+def frame_str(byte):
+    if byte & 0x80:
+        return 'init %s' % CMDS.get(byte, '0x%02x' % byte)
+    return 'cont seq %d' % byte
+
+
+def describe(ev, a0, a1):
+    if ev == EV_FRAME_RX:
+        return 'cid %08x  <- %s' % (a0, frame_str(a1))
+    if ev == EV_FRAME_TX:
+        return 'cid %08x  -> %s' % (a0, frame_str(a1))
+    if ev == EV_CMD:
+        return 'cid %08x  command %s' % (a0, CMDS.get(a1, '0x%02x' % a1))
+    if ev == EV_CH_STATE:
+        return 'cid %08x  state %s' % (a0, STATES.get(a1, a1))
+    if ev == EV_CH_ALLOC:
+        return 'cid %08x  allocated' % a0
+    if ev == EV_CH_FREE:
+        return 'cid %08x  freed' % a0
+    if ev == EV_ERROR:
+        return 'cid %08x  error %s' % (a0, ERRORS.get(a1, '0x%02x' % a1))
+    if ev == EV_MSG_START:
+        return 'cid %08x  %s started' % (a0, INS.get(a1, 'INS 0x%02x' % a1))
+    if ev == EV_MSG_DONE:
+        return 'cid %08x  message done, %d bytes' % (a0, a1)
+    if ev == EV_PHASE:
+        name = PHASES[a0] if a0 < len(PHASES) else 'phase %d' % a0
+        return '            %-12s %8d cycles %9.1f us' % (
+            name, a1, a1 * 1e6 / CPU_FREQ)
+    if ev == EV_FDS:
+        return 'fds %s result %d' % (FDS_EVENTS.get(a0, a0), a1)
+    return 'event %d (0x%08x, 0x%08x)' % (ev, a0, a1)
+
+
+def decode(data):
+    ticks = 0
+    last_ts = None
+    last_seq = None
+    lost = 0
+
+    for off in range(0, len(data) - RECORD.size + 1, RECORD.size):
+        ts, ev, seq, a0, a1 = RECORD.unpack_from(data, off)
+
+        # Unwrap the 24-bit RTC counter
+        if last_ts is not None:
+            ticks += (ts - last_ts) % RTC_WRAP
+        last_ts = ts
+
+        if last_seq is not None and seq != (last_seq + 1) & 0xffff:
+            missing = (seq - last_seq - 1) & 0xffff
+            lost += missing
+            print('%12s  --- %d records lost ---' % ('', missing))
+        last_seq = seq
+
+        print('%12.3f  %s' % (ticks * 1000.0 / RTC_FREQ, describe(ev, a0, a1)))
+
+    if len(data) % RECORD.size:
+        print('warning: %d trailing bytes ignored' % (len(data) % RECORD.size))
+    if lost:
+        print('warning: %d records lost, drain RTT faster or grow '
+              'U2F_TRACE_RING_SIZE' % lost)
+
+
+def main():
+    if len(sys.argv) != 2:
+        print('Usage: python3 u2f_trace_decode.py <trace.bin>')
+        sys.exit(1)
+
+    with open(sys.argv[1], 'rb') as f:
+        decode(f.read())
+
+
+if __name__ == '__main__':
+    main()